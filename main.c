@@ -7,6 +7,7 @@
  * W następnej generacji komórka będzie żywa wtedy i tylko wtedy, gdy:
  * -w bieżącej generacji jest żywa i ma dokładnie dwóch lub trzech żywych sąsiadów,
  * -w bieżącej generacji jest martwa i ma dokładnie trzech żywych sąsiadów.
+ * Opcja -r zmienia tę regułę na dowolną inną regułę B/S.
  *
  * Program wczytuje opis generacji początkowej.
  * W pętli, pokazuje fragment planszy, po czym czyta i wykonuje polecenie użytkownika.
@@ -16,901 +17,1172 @@
  * Program rozpoznaje polecenia:
  * '.' - zakończenie pracy
  * N - liczba całkowita dodatnia - oblicza N - tą generacje
+ *     (po wykryciu cyklu, także przesuniętego, pełne okresy przeskakuje, a okres pisze na stderr)
  * wiersz pusty - oblicza następną genrację
  * '0' - generuje opis aktualnej generacji.
+ * '0>plik' - zapisuje opis aktualnej generacji do pliku 'plik'
+ * '0>&N' - zapisuje opis aktualnej generacji do deskryptora N
+ * "zapisz plik" - zapisuje migawkę aktualnej generacji do pliku 'plik'
+ * "statystyki" - pisze populację, prostokąt z żywymi komórkami i liczniki silnika
+ * "populacja", "prostokat", "zywa w k", "policz w1 k1 w2 k2", "wytnij w1 k1 w2 k2" -
+ *     zapytania o populację, prostokąt z żywymi komórkami, stan komórki, liczbę żywych
+ *     komórek prostokąta i jego zawartość (zob. wykonaj_zapytanie)
  * 'w' 'k' - zmienia współrzędne lewego górnego rogu okna na wiersz w i kolumne k
  *
+ * Współrzędne komórek są 64-bitowe. Symulację liczy biblioteka (zob. zycie.h),
+ * a program tylko czyta opcje i polecenia i pisze ich wyniki.
+ *
+ * Program przyjmuje opcje:
+ * -s silnik - wybiera reprezentacje planszy i sposób liczenia generacji:
+ *             "lista" (domyślny), "przebieg", "tablica", "aktywne", "odcinki", "kafelki"
+ *             lub "hashlife"
+ * -w watki - liczba wątków liczących generację (tylko silnik "przebieg")
+ * -r regula - reguła w zapisie B/S, np. "B36/S23" (HighLife), domyślnie "B3/S23"
+ * -p plik - czyta generację początkową z pliku zamiast z wejścia
+ * -b migawka - czyta generację początkową z migawki zapisanej poleceniem "zapisz"
+ * -e WxK - wyświetla okno o W wierszach i K kolumnach, 0x0 wyłącza okno
+ * -d tryb - wyświetla tylko zmienione linie okna: "linie" z numerami linii,
+ *           "ansi" nadpisując je na terminalu
+ * -n generacje - liczy bez okna i poleceń podaną liczbę generacji i pisze zrzut stanu
+ *                ostatniej z nich
+ * -z generacja - razem z -n pisze też zrzut stanu podanej generacji, można powtarzać
+ * -o cel - razem z -n pisze zrzuty do pliku lub deskryptora "&N" zamiast na wyjście
+ * -m watki - razem z -n liczy podaną liczbą wątków wiele plansz podanych jedna za drugą
+ *            i dla każdej pisze populacje generacji z -z i -n, cykl i zrzut stanu
+ *            ostatniej generacji
+ * -k katalog - razem z -m czyta plansze ze wszystkich plików katalogu
+ * -a - pisze okno, odpowiedzi, komunikaty i zrzuty osobnym wątkiem, w tej samej
+ *      kolejności, podczas gdy gra czyta polecenia i liczy dalej (zob. Wyjscie)
+ *
  * autor: Michał Korniak
  *
  * data: 30 grudnia 2022
  */
 
+#define _GNU_SOURCE
+
 #include <stdio.h>
 #include <stdlib.h>
-#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
-/**
- * Liczba wierszy okna
- */
-#ifndef WIERSZE
-#define WIERSZE 22
-#endif
+#include "zycie.h"
 
 /**
- * Liczba kolumn okna
+ * Domyślna liczba generacji liczonych w teście wydajności
  */
-#ifndef KOLUMNY
-#define KOLUMNY 80
-#endif
+#define GENERACJE_TESTU 1000
 
 /**
- * Reprezentuje komórke
- *
- * 'stan' - aktualny stan komórki
- * 'ile_sasiadow'- liczba sasiadow komorki
- * 'kol' - numer kolumny w której jest komórka
- * 'poprz' - wskaźnik do poprzedniej komórki w wierszu
- * 'nast' - wskaźnik do następnej komórki w wierszu
+ * Komunikat dla poleceń, które wymagają skończonej populacji, wydanych,
+ * gdy plansza trzyma dopełnienie generacji
  */
-typedef struct Komorka_
-{
-    char stan;
-    int ile_sasiadow;
-    int kol;
-    struct Komorka_* poprz;
-    struct Komorka_* nast;
-} Komorka;
+#define NIESKONCZONA_POPULACJA "nieskonczona populacja, polecenie pominiete\n"
 
 /**
- * Reprezentuja wiersz planszy
- *
- * 'wiersz' - numer wiersza
- * 'k'- wskaźnik do pierwszej komórki w wierszu
- * 'poprz' - wskaznik do poprzedniego wiersza
- * 'nast' - wskaźnik do następnego wiersza
+ * Liczba linii prostokąta polecenia "wytnij" składanych naraz
  */
-typedef struct Plansza_
-{
-    int wiersz;
-    Komorka* k;
-    struct Plansza_* poprz;
-    struct Plansza_* nast;
-} Plansza;
+#define LINIE_WYCINKA 64
 
 /**
- * Reprezentuje komorke okna
+ * Zapisuje w 'x' 'n' współrzędnych zapisanych w napisie 'napis', każdą poprzedzoną spacjami
  *
- * 'znak' - '0' lub '.', komorka opowiednio żywa lub martwa.
- * 'wiersz' - numer wiersza
- * 'kol' - numer kolumny
+ * Zwraca 0, gdy napis jest niepoprawny lub wartość bezwzględna którejś współrzędnej
+ * przekracza ZAKRES_WSPOLRZEDNYCH, wpp. 1
  */
-typedef struct Okno_
+int czytaj_wspolrzedne(const char* napis, long long* x, int n)
 {
-    char znak;
-    int wiersz;
-    int kol;
-} Okno;
+    for (int i = 0; i < n; i++) {
+        if (*napis != ' ')
+            return 0;
+        while (*napis == ' ')
+            napis++;
+        const char* cyfry = *napis == '-' ? napis + 1 : napis;
+        if (*cyfry < '0' || *cyfry > '9')
+            return 0;
+        char* koniec;
+        errno = 0;
+        x[i] = strtoll(napis, &koniec, 10);
+        if (errno != 0 || x[i] > ZAKRES_WSPOLRZEDNYCH || x[i] < -ZAKRES_WSPOLRZEDNYCH)
+            return 0;
+        napis = koniec;
+    }
+    return *napis == '\0';
+}
 
 /**
- * Usuwa ostatnią komórke 'k'  w wierszu
+ * Największa liczba porcji wyjścia czekających na wątek piszący
  *
- * Gdyby po usunięcia wiersz miałby być pusty wtedy nie usuwa
+ * Wątek główny, który ma oddać następną porcję, czeka, aż wątek piszący nadrobi
+ * zaległości, więc liczy najwyżej tyle porcji naprzód.
  */
-void usun_komorke(Komorka* k) {
-    if (k -> poprz != NULL)
-        k -> poprz -> nast = NULL;
-    free(k);
-}
+#define PORCJE_W_KOLEJCE 2
 
 /**
- * Usuwa ostatni wiersz 'p'  w planszy
+ * Reprezentuje porcję wyjścia pisaną przez wątek piszący
  *
- * Gdyby po usunięciu plansza miałaby być pusta wtedy zmienia stan ostatniej komórki
+ * 'fd' - deskryptor, do którego trafia tekst porcji
+ * 'tekst', 'dlugosc', 'rozmiar' - tekst porcji, jego długość i pojemność
+ * 'kopia' - kopia generacji zrzucana po tekście lub NULL
+ * 'fd_kopii' - deskryptor, do którego trafia zrzut kopii
+ * 'cel' - cel zrzutu podawany w opisie błędu zapisu lub NULL, gdy błąd się pomija
+ * 'zamknij' - 1, gdy po zrzucie trzeba zamknąć 'fd_kopii'
+ * 'nast' - następna porcja w kolejce
  */
-void usun_wiersz(Plansza* p) {
-    if (p -> poprz != NULL) {
-        p -> poprz -> nast = NULL;
-        free(p -> k);
-        free(p);
-    }
-    else
-        p -> k -> stan = 0;
-}
+typedef struct Porcja_
+{
+    int fd;
+    char* tekst;
+    size_t dlugosc;
+    size_t rozmiar;
+    Kopia* kopia;
+    int fd_kopii;
+    char* cel;
+    int zamknij;
+    struct Porcja_* nast;
+} Porcja;
 
 /**
- * Tworzy i dodaje komórke na koniec wiersza bezpośrednio za 'k'
+ * Reprezentuje strumień wyjścia asynchronicznego, którego tekst trafia do porcji
  *
- * Zwraca w wyniku adres nowej komórki
- *
- * k jest różne od NULL
+ * 'wy' - wyjście
+ * 'fd' - deskryptor, do którego trafia tekst strumienia
  */
-Komorka* dodaj_komorke(Komorka* k)
+typedef struct Strumien_
 {
-    assert(k != NULL);
-    Komorka* k2 = (Komorka*) malloc (sizeof(Komorka));
-    k -> nast = k2;
-    k2 -> poprz = k;
-    k2 -> nast = NULL;
-    return k2;
-}
+    struct Wyjscie_* wy;
+    int fd;
+} Strumien;
 
 /**
- * Tworzy i dodaje wiersz na koniec planszy bezpośrednio za 'p'
+ * Reprezentuje wyjście programu w czasie gry
  *
- * Zwraca w wyniku adres nowego wiersza
+ * Wyjście synchroniczne pisze od razu na standardowe wyjście i wyjście błędów.
+ * Wyjście asynchroniczne zbiera tekst obu w porcjach, a zrzuty stanu jako kopie
+ * generacji, i oddaje je wątkowi piszącemu, który pisze je w tej samej kolejności,
+ * podczas gdy wątek główny liczy kolejne generacje. Powolny terminal lub duży zrzut
+ * wstrzymują wtedy liczenie dopiero po PORCJE_W_KOLEJCE porcjach.
  *
- * p jest różne od NULL
+ * 'f', 'bledy' - pliki, do których pisze się standardowe wyjście i wyjście błędów
+ * 'asynchroniczne' - 1 dla wyjścia asynchronicznego
+ * 'strumienie' - strumienie plików 'f' i 'bledy' wyjścia asynchronicznego
+ * 'biezaca' - porcja zbierana przez wątek główny lub NULL
+ * 'pierwsza', 'ostatnia', 'ile' - kolejka porcji czekających na wątek piszący
+ * 'pisze' - 1, gdy wątek piszący pisze porcję spoza kolejki
+ * 'watek' - wątek piszący
+ * 'm' - zamek pól od 'pierwsza'
+ * 'jest' - sygnalizuje nową porcję w kolejce lub koniec
+ * 'miejsce' - sygnalizuje wypisanie porcji
+ * 'koniec' - 1, gdy wątek piszący ma skończyć po wypisaniu kolejki
+ * 'przerwij' - 1, gdy po nieudanym zrzucie pomija się dalsze porcje
+ * 'blad' - 1, gdy któryś zrzut się nie udał
  */
-Plansza* dodaj_wiersz(Plansza* p)
+typedef struct Wyjscie_
 {
-    assert(p != NULL);
-    Plansza* p2 = (Plansza*) malloc (sizeof(Plansza));
-    p -> nast = p2;
-    p2 -> poprz = p;
-    p2 -> nast = NULL;
-    return p2;
-}
+    FILE* f;
+    FILE* bledy;
+    int asynchroniczne;
+    Strumien strumienie[2];
+    Porcja* biezaca;
+    Porcja* pierwsza;
+    Porcja* ostatnia;
+    int ile;
+    int pisze;
+    pthread_t watek;
+    pthread_mutex_t m;
+    pthread_cond_t jest;
+    pthread_cond_t miejsce;
+    int koniec;
+    int przerwij;
+    int blad;
+} Wyjscie;
 
 /**
- * Czyta, zapisuje i inicjuje komórki dane na wejściu w wierszu, w którym jest 'pom2'
- *
- * pom2 jest różne od NULL
+ * Zwraca porcję zbieraną przez wątek główny wyjścia 'wy', tworząc ją dla tekstu
+ * deskryptora 'fd', gdy jej nie ma
  */
-void czytaj_wiersz(Komorka* pom2)
+Porcja* biezaca_porcja(Wyjscie* wy, int fd)
 {
-    assert(pom2 != NULL);
-    int x;
-    int y;
-    int ok2 = 1;
-    while (ok2) {
-        x = getchar();
-        if (x == EOF || x == '\n')
-            ok2 = 0;
-        else {
-            scanf("%d", &y);
-            pom2 -> kol = y;
-            pom2 -> stan = '0';
-            pom2 -> ile_sasiadow = 0;
-            pom2 = dodaj_komorke(pom2);
-        }
+    if (wy -> biezaca == NULL) {
+        wy -> biezaca = (Porcja*) calloc (1, sizeof(Porcja));
+        wy -> biezaca -> fd = fd;
     }
-    usun_komorke(pom2);
+    return wy -> biezaca;
 }
 
 /**
- * Czyta, zapisuje i inicjuje komórki dane na wejściu w całej planszy 'p'
+ * Oddaje wątkowi piszącemu porcję zbieraną przez wątek główny wyjścia 'wy'
  *
- * p jest różne od NULL
+ * Czeka, gdy w kolejce jest już PORCJE_W_KOLEJCE porcji. Wyjście synchroniczne nie ma
+ * porcji.
  */
-void czytaj_plansze(Plansza* p)
+void oddaj_porcje(Wyjscie* wy)
 {
-    assert(p != NULL);
-    int x;
-    int y;
-    int ok = 1;
-    Plansza* pom = p;
-    Komorka* pom2 = p -> k;
-    while (ok) {
-        x = getchar();
-        x = getchar();
-        if (x == EOF || x == '\n')
-            ok = 0;
-        else {
-            ungetc(x, stdin);
-            scanf("%d", &y);
-            pom -> wiersz = y;
-            czytaj_wiersz(pom2);
-            pom = dodaj_wiersz(pom);
-            pom -> k = (Komorka*) malloc (sizeof(Komorka));
-            pom2 = pom -> k;
-            pom2 -> poprz = NULL;
-            pom2 -> nast = NULL;
-        }
-    }
-    usun_wiersz(pom);
+    Porcja* p = wy -> biezaca;
+    if (p == NULL)
+        return;
+    wy -> biezaca = NULL;
+    pthread_mutex_lock(&wy -> m);
+    while (wy -> ile >= PORCJE_W_KOLEJCE)
+        pthread_cond_wait(&wy -> miejsce, &wy -> m);
+    if (wy -> ostatnia == NULL)
+        wy -> pierwsza = p;
+    else
+        wy -> ostatnia -> nast = p;
+    wy -> ostatnia = p;
+    wy -> ile++;
+    pthread_cond_signal(&wy -> jest);
+    pthread_mutex_unlock(&wy -> m);
 }
 
 /**
- * Sprawdza czy plansza jest pusta
- * Przyjmujemy, że gdy stan ostaniej komórki to 0 w ASCII to plansza jest pusta
+ * Dopisuje 'n' znaków 'tekst' strumienia 'kontekst' do porcji zbieranej przez wątek
+ * główny
  *
- * 'p' jest różne od NULL
+ * Tekst innego deskryptora niż poprzedni zaczyna nową porcję, żeby kolejność tekstu
+ * standardowego wyjścia i wyjścia błędów się nie zmieniła.
  */
-int czy_plansza_pusta(Plansza* p)
+ssize_t dopisz_do_porcji(void* kontekst, const char* tekst, size_t n)
 {
-    assert(p != NULL);
-    if ((int) p -> k -> stan == 0)
-        return 1;
-    else
-        return 0;
+    Strumien* s = (Strumien*) kontekst;
+    Wyjscie* wy = s -> wy;
+    if (wy -> biezaca != NULL && wy -> biezaca -> fd != s -> fd)
+        oddaj_porcje(wy);
+    Porcja* p = biezaca_porcja(wy, s -> fd);
+    if (p -> dlugosc + n > p -> rozmiar) {
+        p -> rozmiar = 2 * (p -> dlugosc + n);
+        p -> tekst = (char*) realloc (p -> tekst, p -> rozmiar);
+    }
+    memcpy(p -> tekst + p -> dlugosc, tekst, n);
+    p -> dlugosc += n;
+    return (ssize_t) n;
 }
 
 /**
- * Tworzy wiersz oraz komórke w nim takie, że
- * -numer wiersza jest równy numerowi wiersza 'pom' + 'w' oraz
- * -numer kolumny komórki jest równy numerowi komórki 'pom2' + 'n'
+ * Pisze 'n' znaków 'tekst' do deskryptora 'fd'
  *
- * 'pom' i 'pom2' są różne od NULL, w = {-1, 1},  'n' = {-1, 0, 1}
+ * Zwraca 0, gdy zapis się nie udał, wpp. 1
  */
-void tworz_wiersz(Plansza* pom, Komorka* pom2, int w, int n)
+int pisz_wszystko(int fd, const char* tekst, size_t n)
 {
-    assert(pom != NULL);
-    assert(pom2 != NULL);
-    assert(w == -1 || w == 1);
-    assert(n >= -1 && n <= 1);
-    Plansza* pomw = (Plansza*) malloc (sizeof(Plansza));
-    if (w == -1) {
-        if (pom -> poprz != NULL)
-            pom -> poprz -> nast = pomw;
-        pomw -> poprz = pom -> poprz;
-        pomw -> nast = pom;
-        pom -> poprz = pomw;
+    while (n > 0) {
+        ssize_t k = write(fd, tekst, n);
+        if (k < 0 && errno == EINTR)
+            continue;
+        if (k <= 0)
+            return 0;
+        tekst += k;
+        n -= (size_t) k;
     }
-    else {
-        if (pom -> nast != NULL)
-            pom -> nast -> poprz = pomw;
-        pomw -> nast = pom -> nast;
-        pomw -> poprz = pom;
-        pom -> nast = pomw;
-    }
-    pomw -> wiersz = pom -> wiersz + w;
-    pomw -> k = (Komorka*) malloc (sizeof(Komorka));
-    pomw -> k -> stan = '.';
-    pomw -> k -> ile_sasiadow = 0;
-    pomw -> k -> kol = pom2 -> kol + n;
-    pomw -> k -> poprz = NULL;
-    pomw -> k -> nast = NULL;
+    return 1;
 }
 
 /**
- * Tworzy komórke w wierszu 'pomw' przed komórką 'pom3', taką że
- * numer jej wiersza jest równy numerowi wiersza 'pom2' + 'n'
- *
- * 'pomw' jest rozne od NULL, 'n' = {-1, 0, 1}, 'pom3', 'pom2' są rozne od NULL
+ * Pętla wątku piszącego wyjścia 'x': pisze kolejne porcje, aż kolejka się skończy
+ * i wątek główny zakończy wyjście
  */
-void tworz_komorke(Plansza* pomw, Komorka* pom3, Komorka* pom2, int n)
+void* pisz_porcje(void* x)
 {
-    assert(pomw != NULL);
-    assert(n >= -1 && n <= 1);
-    assert(pom3 != NULL);
-    assert(pom2 != NULL);
-    Komorka* k2 = (Komorka*) malloc (sizeof(Komorka));
-    if (pom3 -> poprz != NULL)
-        pom3 -> poprz -> nast = k2;
-    k2 -> poprz = pom3 -> poprz;
-    k2 -> nast = pom3;
-    pom3 -> poprz = k2;
-    k2 -> stan = '.';
-    k2 -> ile_sasiadow = 0;
-    k2 -> kol = pom2 -> kol + n;
-    if (k2 -> poprz == NULL) {
-        pomw -> k = k2;
+    Wyjscie* wy = (Wyjscie*) x;
+    while (1) {
+        pthread_mutex_lock(&wy -> m);
+        while (wy -> pierwsza == NULL && !wy -> koniec)
+            pthread_cond_wait(&wy -> jest, &wy -> m);
+        Porcja* p = wy -> pierwsza;
+        if (p != NULL) {
+            wy -> pierwsza = p -> nast;
+            if (wy -> pierwsza == NULL)
+                wy -> ostatnia = NULL;
+            wy -> ile--;
+            wy -> pisze = 1;
+        }
+        int pomin = wy -> blad && wy -> przerwij;
+        pthread_mutex_unlock(&wy -> m);
+        if (p == NULL)
+            break;
+        int blad = 0;
+        if (!pomin) {
+            pisz_wszystko(p -> fd, p -> tekst, p -> dlugosc);
+            if (p -> kopia != NULL && !zycie_zrzuc_kopie(p -> kopia, p -> fd_kopii)) {
+                blad = 1;
+                if (p -> cel != NULL)
+                    dprintf(STDERR_FILENO, "nie udal sie zapis zrzutu: %s\n", p -> cel);
+            }
+        }
+        if (p -> zamknij)
+            close(p -> fd_kopii);
+        if (p -> kopia != NULL)
+            zycie_usun_kopie(p -> kopia);
+        free(p -> cel);
+        free(p -> tekst);
+        free(p);
+        pthread_mutex_lock(&wy -> m);
+        wy -> pisze = 0;
+        wy -> blad |= blad;
+        pthread_cond_broadcast(&wy -> miejsce);
+        pthread_mutex_unlock(&wy -> m);
     }
+    return NULL;
 }
 
 /**
- * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu,
- * w którym jest 'pom2' począwszy od 'pom2' takich, że:
- * -znajdują się w wierszu 'pomw' oraz
- * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ * Tworzy w '*wy' wyjście, asynchroniczne, gdy 'asynchroniczne' jest 1
  *
- * 'pomw' jest różne od NULL, n = {-1, 0 , 1}
+ * 'przerwij' równe 1 sprawia, że po nieudanym zrzucie wyjście asynchroniczne pomija
+ * dalsze porcje
  */
-void tworz_sasiadow_pom_pom(Plansza* pomw, Komorka* pom2, int n)
+void tworz_wyjscie(Wyjscie* wy, int asynchroniczne, int przerwij)
 {
-    assert(pomw != NULL);
-    assert(n >= -1 && n <= 1);
-    Komorka* pom3 = pomw -> k;
-    Komorka* pom4 = NULL;
-    while (pom2 != NULL) {
-        if (pom2 -> stan == '0') {
-            if (pom3 == NULL) {
-                pom3 = dodaj_komorke(pom4);
-                pom3 -> stan = '.';
-                pom3 -> ile_sasiadow = 0;
-                pom3 -> kol = pom2 -> kol + n;
-            }
-            else if (pom2 -> kol + n < pom3 -> kol) {
-                tworz_komorke(pomw, pom3, pom2, n);
-                pom2 = pom2 -> nast;
-            }
-            else if (pom2 -> kol + n == pom3 -> kol) {
-                pom2 = pom2 -> nast;
-                pom4 = pom3;
-                pom3 = pom3 -> nast;
-            }
-            else if (pom2 -> kol + n > pom3 -> kol) {
-                pom4 = pom3;
-                pom3 = pom3 -> nast;
-            }
-        }
-        else
-            pom2 = pom2 -> nast;
+    memset(wy, 0, sizeof(Wyjscie));
+    wy -> f = stdout;
+    wy -> bledy = stderr;
+    wy -> asynchroniczne = asynchroniczne;
+    wy -> przerwij = przerwij;
+    if (!asynchroniczne)
+        return;
+    cookie_io_functions_t funkcje = {NULL, dopisz_do_porcji, NULL, NULL};
+    FILE** pliki[2] = {&wy -> f, &wy -> bledy};
+    for (int i = 0; i < 2; i++) {
+        wy -> strumienie[i].wy = wy;
+        wy -> strumienie[i].fd = i == 0 ? STDOUT_FILENO : STDERR_FILENO;
+        *pliki[i] = fopencookie(&wy -> strumienie[i], "w", funkcje);
+        // tekst trafia do porcji od razu, więc plik nie potrzebuje własnego bufora
+        setvbuf(*pliki[i], NULL, _IONBF, 0);
     }
+    pthread_mutex_init(&wy -> m, NULL);
+    pthread_cond_init(&wy -> jest, NULL);
+    pthread_cond_init(&wy -> miejsce, NULL);
+    pthread_create(&wy -> watek, NULL, pisz_porcje, wy);
 }
 
 /**
- * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom' takich, że:
- * -znajdują się w wierszu o numerze 'pom' -> kol  +  'w' oraz
- * -numer kolumny sąsiada różni się od numeru komórki o 'n'
- *
- * pom jest różne od NULL, n = {-1, 0 , 1}, w = {-1, 1}
+ * Zwraca 1, gdy któryś zrzut wyjścia 'wy' się nie udał, wpp. 0
  */
-void tworz_sasiadow_pom(Plansza* pom, int w, int n)
+int blad_wyjscia(Wyjscie* wy)
 {
-    assert(pom != NULL);
-    assert(w == -1 || w == 1);
-    assert(n >= -1 && n <= 1);
-    Komorka* pom2 = pom -> k;
-    Plansza* pomw;
-    if (w == -1)
-        pomw = pom -> poprz;
-    else
-        pomw = pom -> nast;
-    int ok = 1;
-    while (pom2 != NULL && ok) {
-        if (pom2 -> stan == '0' && (pomw == NULL || pom -> wiersz + w != pomw -> wiersz)) {
-            tworz_wiersz(pom, pom2, w, n);
-            ok = 0;
-        }
-        else if (pom2 -> stan == '0') {
-            ok = 0;
-            break;
-        }
-        pom2 = pom2 -> nast;
-    }
-    if (w == -1)
-        pomw = pom -> poprz;
-    else
-        pomw = pom -> nast;
-    if (ok == 0) {
-        tworz_sasiadow_pom_pom(pomw, pom2, n);
-    }
+    if (!wy -> asynchroniczne)
+        return wy -> blad;
+    pthread_mutex_lock(&wy -> m);
+    int blad = wy -> blad;
+    pthread_mutex_unlock(&wy -> m);
+    return blad;
 }
 
 /**
- * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom' takich, że:
- * -znajdują się w wierszu 'pom' oraz
- * -numer kolumny sąsiada różni się od numeru komórki o 'n'
- *
- * pom jest różne od NULL, n = -1 lub n = 1
+ * Oddaje porcję zbieraną przez wątek główny wyjścia 'wy' i czeka, aż wątek piszący
+ * wypisze wszystkie porcje
  */
-void tworz_sasiadow_pom2(Plansza* pom, int n)
+void czekaj_na_wyjscie(Wyjscie* wy)
 {
-    assert(pom != NULL);
-    assert(n == -1 || n == 1);
-    Komorka* pom2 = pom -> k;
-    while (pom2 != NULL) {
-        if (pom2 -> stan == '0') {
-            if (n == -1) {
-                if (pom2 -> poprz == NULL || pom2 -> kol - 1 != pom2 -> poprz -> kol) {
-                    tworz_komorke(pom, pom2, pom2, -1);
-                }
-            }
-            else {
-                if (pom2 -> nast == NULL || pom2 -> kol + 1 != pom2 -> nast -> kol) {
-                    Komorka* k2 = (Komorka*) malloc (sizeof(Komorka));
-                    if (pom2 -> nast != NULL)
-                        pom2 -> nast -> poprz = k2;
-                    k2 -> nast = pom2 -> nast;
-                    k2 -> poprz = pom2;
-                    pom2 -> nast = k2;
-                    k2 -> stan = '.';
-                    k2 -> ile_sasiadow = 0;
-                    k2 -> kol = pom2 -> kol + 1;
-                }
-            }
-        }
-        pom2 = pom2 -> nast;
-    }
+    if (!wy -> asynchroniczne)
+        return;
+    oddaj_porcje(wy);
+    pthread_mutex_lock(&wy -> m);
+    while (wy -> ile > 0 || wy -> pisze)
+        pthread_cond_wait(&wy -> miejsce, &wy -> m);
+    pthread_mutex_unlock(&wy -> m);
 }
 
 /**
- * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom'
- *
- * pom jest różne od NULL
+ * Wypisuje wszystko, co zostało na wyjściu 'wy', i kończy jego wątek piszący
  */
-void tworz_sasiadow_wiersz(Plansza* pom)
+void zakoncz_wyjscie(Wyjscie* wy)
 {
-    assert(pom != NULL);
-    tworz_sasiadow_pom(pom, -1, -1);
-    tworz_sasiadow_pom(pom, -1, 0);
-    tworz_sasiadow_pom(pom, -1, 1);
-    tworz_sasiadow_pom2(pom, -1);
-    tworz_sasiadow_pom2(pom, 1);
-    tworz_sasiadow_pom(pom, 1, -1);
-    tworz_sasiadow_pom(pom, 1, 0);
-    tworz_sasiadow_pom(pom, 1, 1);
+    if (!wy -> asynchroniczne)
+        return;
+    oddaj_porcje(wy);
+    pthread_mutex_lock(&wy -> m);
+    wy -> koniec = 1;
+    pthread_cond_signal(&wy -> jest);
+    pthread_mutex_unlock(&wy -> m);
+    pthread_join(wy -> watek, NULL);
+    fclose(wy -> f);
+    fclose(wy -> bledy);
+    pthread_mutex_destroy(&wy -> m);
+    pthread_cond_destroy(&wy -> jest);
+    pthread_cond_destroy(&wy -> miejsce);
 }
 
 /**
- * Tworzy wszystkich sąsiadów każdej żywej komórki na planszy 'p'
+ * Pisze zrzut stanu gry 'z' do deskryptora 'fd' po tekście wypisanym wcześniej
+ * na wyjście 'wy', a gdy 'zamknij' jest 1, zamyka potem 'fd'
  *
- * 'p' może ulec zmianie
+ * Nieudany zapis zgłasza na wyjściu błędów z celem 'cel', gdy nie jest NULL.
+ * Wyjście asynchroniczne zrzuca kopię generacji w wątku piszącym, a błąd zapisu
+ * odnotowuje w wyjściu (zob. blad_wyjscia). Zwraca 0, gdy zapis się nie udał, wpp. 1
  */
-void tworz_sasiadow(Plansza** p)
+int zrzuc(Wyjscie* wy, Zycie* z, int fd, const char* cel, int zamknij)
 {
-    Plansza* pom = *p;
-    while (pom != NULL) {
-        tworz_sasiadow_wiersz(pom);
-        pom = pom -> nast;
+    if (wy -> asynchroniczne) {
+        Porcja* p = biezaca_porcja(wy, STDOUT_FILENO);
+        p -> kopia = zycie_kopiuj(z);
+        p -> fd_kopii = fd;
+        p -> cel = cel != NULL ? strdup(cel) : NULL;
+        p -> zamknij = zamknij;
+        oddaj_porcje(wy);
+        return 1;
+    }
+    fflush(wy -> f);
+    int wynik = zycie_zrzuc(z, fd);
+    if (!wynik) {
+        wy -> blad = 1;
+        if (cel != NULL)
+            fprintf(wy -> bledy, "nie udal sie zapis zrzutu: %s\n", cel);
     }
-    if ((*p) != NULL && (*p) -> poprz != NULL)
-        (*p) = (*p) -> poprz;
+    if (zamknij)
+        close(fd);
+    return wynik;
 }
 
 /**
- * Inicjuje okno 'o' poprzez wpisane w wartości 'znak' całego okna znaku '.'
+ * Pisze na wyjście 'wy' prostokąt gry 'z' o rogach ('w1', 'k1') i ('w2', 'k2') liniami
+ * jak w oknie
  *
- * 'w' i 'k' oznaczają współrzędne lewego górnego rogu okna
- *
- * 'o' ma wymiary [WIERSZE][KOLUMNY]
+ * Linie wycina się po LINIE_WYCINKA naraz. Szerokość prostokąta nie może przekraczać
+ * NAJWIEKSZE_OKNO.
  */
-void inicjuj_okno(Okno o[][KOLUMNY], int w, int k)
+void wytnij_prostokat(Wyjscie* wy, const Zycie* z, long long w1, long long k1, long long w2, long long k2)
 {
-    for (int i = 0; i < WIERSZE; i++)
-        for (int j = 0; j < KOLUMNY; j++) {
-            o[i][j].znak = '.';
-            o[i][j].wiersz = i + w;
-            o[i][j].kol = j + k;
-        }
+    int kolumny = (int) (k2 - k1 + 1);
+    char* bufor = (char*) malloc ((size_t) LINIE_WYCINKA * (size_t) (kolumny + 1));
+    for (long long w = w1; w <= w2; w += LINIE_WYCINKA) {
+        // różnica współrzędnych z ZAKRES_WSPOLRZEDNYCH może nie mieścić się w long long
+        unsigned long long reszta = (unsigned long long) w2 - (unsigned long long) w + 1;
+        int linie = reszta < LINIE_WYCINKA ? (int) reszta : LINIE_WYCINKA;
+        zycie_wytnij(z, w, k1, linie, kolumny, bufor);
+        fwrite(bufor, 1, (size_t) linie * (size_t) (kolumny + 1), wy -> f);
+    }
+    free(bufor);
 }
 
 /**
- * Wpisuje w okno 'o' komórki planszy 'p'
+ * Wykonuje zapytanie 'linia' o planszę gry 'z', pisząc odpowiedź na wyjście 'wy'
  *
- * Komórki w oknie są żywe wtw gdy są żywe na planszy 'p'
+ * Zwraca 0, gdy 'linia' nie jest zapytaniem, wpp. 1. Niepoprawne zapytanie zgłasza
+ * na wyjściu błędów.
  *
- * 'w' i 'k' oznaczają współrzędne lewego górnego rogu okna
- *
- * 'o' ma wymiary [WIERSZE][KOLUMNY]
+ * "populacja" - liczba żywych komórek
+ * "prostokat" - najmniejszy prostokąt z żywymi komórkami
+ * "zywa w k" - 1, gdy komórka (w, k) jest żywa, wpp. 0
+ * "policz w1 k1 w2 k2" - liczba żywych komórek w prostokącie o rogach (w1, k1), (w2, k2)
+ * "wytnij w1 k1 w2 k2" - prostokąt o rogach (w1, k1), (w2, k2) liniami jak w oknie
  */
-void wpisz_w_okno(Plansza* p, Okno o[][KOLUMNY], int w, int k)
+int wykonaj_zapytanie(Wyjscie* wy, const Zycie* z, const char* linia)
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            if (w <= pom -> wiersz && pom -> wiersz < w + WIERSZE &&
-                k <= pom2 -> kol && pom2 -> kol < k + KOLUMNY && pom2 -> stan == '0') {
-                o[pom -> wiersz - w][pom2 -> kol - k].znak = '0';
-            }
-            pom2 = pom2 -> nast;
+    long long x[4];
+    if (strcmp(linia, "populacja") == 0 || strcmp(linia, "prostokat") == 0) {
+        if (zycie_nieskonczona(z)) {
+            fprintf(wy -> bledy, NIESKONCZONA_POPULACJA);
+            return 1;
+        }
+        if (strcmp(linia, "populacja") == 0)
+            fprintf(wy -> f, "populacja %lld\n", zycie_populacja(z));
+        else if (!zycie_prostokat(z, &x[0], &x[1], &x[2], &x[3]))
+            fprintf(wy -> f, "prostokat pusty\n");
+        else
+            fprintf(wy -> f, "prostokat %lld %lld %lld %lld\n", x[0], x[1], x[2], x[3]);
+    }
+    else if (strncmp(linia, "zywa", 4) == 0 && (linia[4] == ' ' || linia[4] == '\0')) {
+        if (!czytaj_wspolrzedne(linia + 4, x, 2)) {
+            fprintf(wy -> bledy, "niepoprawne polecenie: %s\n", linia);
+            return 1;
+        }
+        fprintf(wy -> f, "zywa %d\n", zycie_zywa(z, x[0], x[1]));
+    }
+    else if ((strncmp(linia, "policz", 6) == 0 || strncmp(linia, "wytnij", 6) == 0)
+             && (linia[6] == ' ' || linia[6] == '\0')) {
+        if (!czytaj_wspolrzedne(linia + 6, x, 4) || x[0] > x[2] || x[1] > x[3]) {
+            fprintf(wy -> bledy, "niepoprawne polecenie: %s\n", linia);
+            return 1;
+        }
+        if (linia[0] == 'w') {
+            if ((unsigned long long) x[3] - (unsigned long long) x[1] >= NAJWIEKSZE_OKNO)
+                fprintf(wy -> bledy, "prostokat szerszy niz %d kolumn\n", NAJWIEKSZE_OKNO);
+            else
+                wytnij_prostokat(wy, z, x[0], x[1], x[2], x[3]);
+            return 1;
         }
-        pom = pom -> nast;
+        long long n = zycie_policz(z, x[0], x[1], x[2], x[3]);
+        if (n < 0)
+            fprintf(wy -> bledy, NIESKONCZONA_POPULACJA);
+        else
+            fprintf(wy -> f, "policz %lld\n", n);
     }
+    else
+        return 0;
+    fflush(wy -> f);
+    return 1;
 }
 
 /**
- * Pisze wartości 'znak' okna 'o'
+ * Wykonuje polecenie 'linia' zaczynające się od słowa na planszy gry 'z', pisząc
+ * na wyjście 'wy'
  *
- * 'o' ma wymiary [WIERZE][KOLUMNY]
+ * Nieznane lub niepoprawne polecenie zgłasza na wyjściu błędów
  */
-void pisz_okno(Okno o[][KOLUMNY])
+void wykonaj_polecenie(Wyjscie* wy, Zycie* z, const char* linia)
 {
-    for (int i = 0; i < WIERSZE; i++) {
-        for (int j = 0; j < KOLUMNY; j++)
-            printf("%c", o[i][j].znak);
-        printf("\n");
+    if (wykonaj_zapytanie(wy, z, linia))
+        return;
+    if (zycie_nieskonczona(z) && (strncmp(linia, "zapisz ", 7) == 0 || strcmp(linia, "statystyki") == 0))
+        fprintf(wy -> bledy, NIESKONCZONA_POPULACJA);
+    else if (strncmp(linia, "zapisz ", 7) == 0 && linia[7] != '\0') {
+        if (!zycie_zapisz_migawke(z, linia + 7))
+            fprintf(wy -> bledy, "%s\n", zycie_blad(z));
     }
+    else if (strcmp(linia, "statystyki") == 0)
+        zycie_pisz_statystyki(z, wy -> f);
+    else
+        fprintf(wy -> bledy, "nieznane polecenie: %s\n", linia);
 }
 
 /**
- * Wyświetla dolną ramkę okna dlugości KOLUMNY
+ * Otwiera do zapisu cel zrzutu 'cel'
+ *
+ * 'cel' to "&N" dla deskryptora N lub nazwa pliku, który zostanie nadpisany.
+ * Zwraca deskryptor lub -1 z opisem błędu w pliku 'bledy'
  */
-void pisz_ramke(void)
+int otworz_cel(const char* cel, FILE* bledy)
 {
-    for (int i = 0; i < KOLUMNY; i++)
-        printf("=");
-    printf("\n");
+    if (cel[0] == '&') {
+        char* koniec;
+        long n = strtol(cel + 1, &koniec, 10);
+        if (cel[1] == '\0' || *koniec != '\0' || n < 0 || n > INT_MAX) {
+            fprintf(bledy, "niepoprawny deskryptor: %s\n", cel + 1);
+            return -1;
+        }
+        return (int) n;
+    }
+    int fd = open(cel, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fprintf(bledy, "nie mozna otworzyc pliku: %s\n", cel);
+    return fd;
 }
 
 /**
- * Wyświetla okno planszy na której rozgrywa się gra
- *
- * Komórki w oknie są żywe wtw gdy są żywe na planszy 'p'
+ * Wykonuje polecenie zrzutu stanu gry 'z' do celu 'cel' (zob. otworz_cel)
  *
- * 'w' i 'k' oznaczają współrzędne lewego górnego rogu okna
+ * Błąd zgłasza na wyjściu błędów wyjścia 'wy', nie przerywając gry.
  */
-void wyswietl_okno(Plansza* p, int w, int k)
+void zrzuc_stan_do(Wyjscie* wy, Zycie* z, const char* cel)
 {
-    Okno o[WIERSZE][KOLUMNY];
-    inicjuj_okno(o, w, k);
-    wpisz_w_okno(p, o, w, k);
-    pisz_okno(o);
-    pisz_ramke();
+    int fd = otworz_cel(cel, wy -> bledy);
+    if (fd >= 0)
+        zrzuc(wy, z, fd, cel, cel[0] != '&');
 }
 
 /**
- * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom', takich że:
- * -znajdują się także w wierszu 'pom' -> kol + w oraz
- * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ * Liczy 'n' kolejnych generacji gry 'z' i zgłasza na wyjściu błędów wyjścia 'wy' cykl,
+ * gdy został wykryty w trakcie
  *
- * n = {-1, 0, 1} oraz w = {-1, 1}
+ * Zwraca 0 z opisem błędu na wyjściu błędów, gdy gry nie można dalej liczyć, wpp. 1
  */
-void zlicz_sasiadow_pom(Plansza* pom, int w, int n)
+int licz(Wyjscie* wy, Zycie* z, long long n)
 {
-    assert(n >= -1 && n <= 1);
-    assert(w == -1 || w == 1);
-    int ok = 0;
-    Komorka* pom2 = pom -> k;
-    Komorka* pom3 = NULL;
-    if (w == -1 && pom -> poprz != NULL && pom -> poprz -> wiersz + 1 == pom -> wiersz) {
-        ok = 1;
-        pom3 = pom -> poprz -> k;
-    }
-    else if (w == 1 && pom -> nast != NULL && pom -> nast -> wiersz - 1 == pom -> wiersz) {
-        ok = 1;
-        pom3 = pom -> nast -> k;
-    }
-    if (ok == 1) {
-        while (pom2 != NULL && pom3 != NULL) {
-            if (pom2 -> kol + n == pom3 -> kol) {
-                if (pom3 -> stan == '0')
-                    pom2 -> ile_sasiadow++;
-                pom3 = pom3 -> nast;
-                pom2 = pom2 -> nast;
-            }
-            else if (pom2 -> kol + n < pom3 -> kol){
-                pom2 = pom2 -> nast;
-            }
-            else {
-                pom3 = pom3 -> nast;
-            }
-        }
+    int okres;
+    int dy;
+    int dx;
+    long long od;
+    int znany = zycie_okres(z, &okres, &dy, &dx, &od);
+    if (!zycie_licz(z, n)) {
+        fprintf(wy -> bledy, "%s\n", zycie_blad(z));
+        return 0;
     }
+    if (!znany && zycie_okres(z, &okres, &dy, &dx, &od))
+        fprintf(wy -> bledy, "cykl: okres %d, przesuniecie (%d, %d), od generacji %lld\n",
+                okres, dy, dx, od);
+    return 1;
 }
 
 /**
- * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom', takich że:
- * -znajdują się także w wierszu 'pom' oraz
- * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ * Rozgrywa grę 'z', wyświetlając okno 'o' na wyjściu 'wy'
  *
- * n = -1 lub n = 1
+ * Czyta polecenia użytkownika z czytnika 'c'. Każdą klatkę okna oddaje wątkowi
+ * piszącemu wyjścia asynchronicznego, zanim przeczyta polecenie.
+ * Niepoprawne polecenie zgłasza na wyjściu błędów i czyta następne.
+ * Zwraca 0 z opisem błędu na wyjściu błędów, gdy czytnik zgłosił błąd lub gry
+ * nie można dalej liczyć, wpp. 1
  */
-void zlicz_sasiadow_pom2(Plansza* pom, int n)
+int rozgrywaj(Wyjscie* wy, Zycie* z, Okno* o, Czytnik* c)
 {
-    assert(n == -1 || n == 1);
-    Komorka* pom2 = pom -> k;
-    if (n == -1) {
-        while (pom2 != NULL) {
-            if (pom2 -> poprz != NULL && pom2 -> poprz -> kol == pom2 -> kol - 1 &&
-                pom2 -> poprz -> stan == '0')
-                pom2 -> ile_sasiadow++;
-            pom2 = pom2 -> nast;
+    long long w = 1;
+    long long k = 1;
+    Polecenie p;
+    memset(&p, 0, sizeof(p));
+    int wynik = 1;
+    while (wynik) {
+        zycie_wyswietl_okno(z, o, w, k);
+        oddaj_porcje(wy);
+        if (!zycie_czytaj_polecenie(c, &p)) {
+            fprintf(wy -> bledy, "%s\n", zycie_blad_czytnika(c));
+            wynik = 0;
         }
-    }
-    else {
-        while (pom2 != NULL) {
-            if (pom2 -> nast != NULL && pom2 -> nast -> kol == pom2 -> kol + 1 &&
-                pom2 -> nast -> stan == '0')
-                pom2 -> ile_sasiadow++;
-            pom2 = pom2 -> nast;
+        else if (p.rodzaj == POLECENIE_KONIEC)
+            break;
+        else if (p.rodzaj == POLECENIE_KROK)
+            wynik = licz(wy, z, p.liczba);
+        else if (p.rodzaj == POLECENIE_SLOWO) {
+            wykonaj_polecenie(wy, z, p.tekst);
+            zycie_uniewaznij_okno(o);
+        }
+        else if (p.rodzaj == POLECENIE_BLEDNE)
+            fprintf(wy -> bledy, "niepoprawne polecenie: %s\n", p.tekst);
+        else if (p.rodzaj == POLECENIE_OKNO) {
+            w = p.w;
+            k = p.k;
+        }
+        else if (zycie_nieskonczona(z))
+            fprintf(wy -> bledy, NIESKONCZONA_POPULACJA);
+        else if (p.rodzaj == POLECENIE_ZRZUT_DO)
+            zrzuc_stan_do(wy, z, p.tekst);
+        else {
+            zrzuc(wy, z, STDOUT_FILENO, NULL, 0);
+            zycie_uniewaznij_okno(o);
         }
     }
+    free(p.tekst);
+    return wynik;
 }
 
 /**
- * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom'
- *
- * Wyniki zapisuje w ile_sasiadow każdej komórki
+ * Porównuje numery generacji '*a' i '*b'
  */
-void zlicz_sasiadow_wiersz(Plansza* pom)
+int porownaj_generacje(const void* a, const void* b)
 {
-    zlicz_sasiadow_pom(pom, -1, -1);
-    zlicz_sasiadow_pom(pom, -1, 0);
-    zlicz_sasiadow_pom(pom, -1, 1);
-    zlicz_sasiadow_pom2(pom, -1);
-    zlicz_sasiadow_pom2(pom, 1);
-    zlicz_sasiadow_pom(pom, 1, -1);
-    zlicz_sasiadow_pom(pom, 1, 0);
-    zlicz_sasiadow_pom(pom, 1, 1);
+    long long x = *(const long long*) a;
+    long long y = *(const long long*) b;
+    return x < y ? -1 : x > y;
 }
 
 /**
- * Zlicza liczbę sąsiadów każdej komórki na planszy 'p'
- *
- * Wyniki zapisuje w ile_sasiadow każdej komórki
+ * Rozgrywa grę 'z' bez okna i poleceń: liczy generacje do największej z 'ile' generacji
+ * 'zrzuty' i pisze zrzut stanu każdej z nich na wyjście 'wy' do celu 'cel'
+ * (zob. otworz_cel), a gdy 'cel' jest NULL, na standardowe wyjście
  *
- * ile_sasiadow każdej komórki musi być równe 0
+ * Zrzuty trafiają do celu jeden po drugim, w kolejności generacji. Generacje są liczone
+ * jak poleceniem N, z przeskakiwaniem cykli.
+ * Zwraca 0 z opisem błędu na wyjściu błędów, gdy któryś zapis się nie udał, wpp. 1
  */
-void zlicz_sasiadow(Plansza* p)
+int rozgrywaj_wsadowo(Wyjscie* wy, Zycie* z, long long* zrzuty, int ile, const char* cel)
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            assert(pom2 -> ile_sasiadow == 0);
-            pom2 = pom2 -> nast;
-        }
-        pom = pom -> nast;
+    int fd = cel == NULL ? STDOUT_FILENO : otworz_cel(cel, wy -> bledy);
+    if (fd < 0)
+        return 0;
+    qsort(zrzuty, (size_t) ile, sizeof(long long), porownaj_generacje);
+    int wynik = 1;
+    for (int i = 0; i < ile && wynik && !blad_wyjscia(wy); i++) {
+        if (i > 0 && zrzuty[i] == zrzuty[i - 1])
+            continue;
+        if (!licz(wy, z, zrzuty[i] - zycie_generacja(z)))
+            wynik = 0;
+        else if (zycie_nieskonczona(z))
+            fprintf(wy -> bledy, "generacja %lld: " NIESKONCZONA_POPULACJA, zrzuty[i]);
+        else
+            zrzuc(wy, z, fd, cel == NULL ? "stdout" : cel, 0);
     }
-    pom = p;
-    while (pom != NULL) {
-        zlicz_sasiadow_wiersz(pom);
-        pom = pom -> nast;
+    czekaj_na_wyjscie(wy);
+    if (blad_wyjscia(wy))
+        wynik = 0;
+    if (cel != NULL && cel[0] != '&' && close(fd) != 0 && wynik) {
+        fprintf(wy -> bledy, "nie udal sie zapis zrzutu: %s\n", cel);
+        wynik = 0;
     }
+    return wynik;
 }
 
 /**
- * Aktualizuje stan wszystkich komórek planszy 'p' oraz zeruje liczbę sąsiadów
+ * Liczba plansz wczytywanych i liczonych naraz w trybie wielu plansz
+ */
+#define PLANSZE_NARAZ 1024
+
+/**
+ * Reprezentuje plansze trybu wielu plansz
  *
- * W następnej generacji komórka będzie żywa wtedy i tylko wtedy, gdy:
- * -w bieżącej generacji jest żywa i ma dokładnie dwóch lub trzech żywych sąsiadów,
- * -w bieżącej generacji jest martwa i ma dokładnie trzech żywych sąsiadów.
+ * 'z' - gra planszy
+ * 'nr' - numer planszy od 1, w kolejności wczytania
+ * 'zrodlo' - plik, z którego wczytano plansze, lub NULL dla wejścia
+ * 'populacje' - populacje kolejnych generacji zrzutów, -1 dla nieskończonej
+ * 'policzone' - liczba policzonych generacji zrzutów
+ * 'dziala' - 0, gdy gry nie można było dalej liczyć, wpp. 1
  */
-void aktualizuj_stan(Plansza* p)
+typedef struct Plansza_
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            if (pom2 -> stan == '0' && (pom2 -> ile_sasiadow == 2 || pom2 -> ile_sasiadow == 3))
-                pom2 -> stan = '0';
-            else if (pom2 -> stan == '.' && pom2 -> ile_sasiadow == 3)
-                pom2 -> stan = '0';
-            else
-                pom2 -> stan = '.';
-            pom2 -> ile_sasiadow = 0;
-            pom2 = pom2 -> nast;
-        }
-        pom = pom -> nast;
-    }
-}
+    Zycie* z;
+    long long nr;
+    const char* zrodlo;
+    long long* populacje;
+    int policzone;
+    int dziala;
+} Plansza;
 
 /**
- * Usuwa komórki na planszy 'p', gdy:
- * -są martwe oraz
- * -wszyscy sąsiedzi danej komórki sa martwi
- */
-void usun_martwe_pom(Plansza* p)
-{
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            if (pom2 -> stan == '.' && pom2 -> ile_sasiadow == 0) {
-                if (pom2 -> poprz == NULL && pom2 -> nast == NULL) {
-                    pom -> k = NULL;
-                    free(pom2);
-                    pom2 = NULL;
-                }
-                else if (pom2 -> poprz == NULL) {
-                    Komorka* pom3 = pom2 -> nast;
-                    pom3 -> poprz = NULL;
-                    free(pom2);
-                    pom -> k = pom3;
-                    pom2 = pom3;
-                }
-                else if (pom2 -> nast == NULL) {
-                    pom2 -> poprz -> nast = NULL;
-                    free(pom2);
-                    pom2 = NULL;
-                }
-                else {
-                    Komorka* pom3 = pom2 -> poprz;
-                    pom3 -> nast = pom2 -> nast;
-                    pom2 -> nast -> poprz = pom3;
-                    free(pom2);
-                    pom2 = pom3 -> nast;
-                }
+ * Zbiera plansze trybu wielu plansz z kolejnych źródeł
+ *
+ * 'pliki', 'ile_plikow' - pliki z planszami, NULL, gdy plansze czyta się z wejścia
+ * 'zrodlo' - numer bieżącego źródła
+ * 'c' - czytnik bieżącego źródła lub NULL, gdy trzeba otworzyć następne
+ * 'nr' - liczba wczytanych plansz
+ * 'blad' - 1, gdy któregoś źródła nie udało się przeczytać
+ */
+typedef struct Zrodla_
+{
+    char** pliki;
+    int ile_plikow;
+    int zrodlo;
+    Czytnik* c;
+    long long nr;
+    int blad;
+} Zrodla;
+
+/**
+ * Wczytuje do 'p' następną plansze ze źródeł 'zr' jako grę silnikiem 'silnik' liczącym
+ * 'watki' wątkami według reguły 'regula'
+ *
+ * Plik, którego nie da się otworzyć, i resztę źródła za błędem wejścia pomija
+ * z opisem błędu na stderr. Zwraca 0, gdy plansze się skończyły, wpp. 1
+ */
+int nastepna_plansza(Zrodla* zr, Plansza* p, const char* silnik, int watki, const char* regula)
+{
+    int ile = zr -> pliki != NULL ? zr -> ile_plikow : 1;
+    while (zr -> zrodlo < ile) {
+        const char* nazwa = zr -> pliki != NULL ? zr -> pliki[zr -> zrodlo] : NULL;
+        if (zr -> c == NULL) {
+            zr -> c = nazwa != NULL ? zycie_czytnik_pliku(nazwa) : zycie_czytnik(STDIN_FILENO);
+            if (zr -> c == NULL) {
+                fprintf(stderr, "nie mozna otworzyc pliku: %s\n", nazwa);
+                zr -> blad = 1;
+                zr -> zrodlo++;
+                continue;
             }
-            else {
-                pom2 = pom2 -> nast;
+        }
+        if (!zycie_koniec_wejscia(zr -> c)) {
+            Zycie* z = zycie_tworz(silnik, watki, regula);
+            if (zycie_wczytaj(z, zr -> c)) {
+                p -> z = z;
+                p -> nr = ++zr -> nr;
+                p -> zrodlo = nazwa;
+                p -> policzone = 0;
+                p -> dziala = 1;
+                return 1;
             }
+            fprintf(stderr, "%s: %s\n", nazwa != NULL ? nazwa : "stdin", zycie_blad(z));
+            zr -> blad = 1;
+            zycie_usun(z);
         }
-        pom = pom -> nast;
+        zycie_zamknij_czytnik(zr -> c);
+        zr -> c = NULL;
+        zr -> zrodlo++;
     }
+    return 0;
 }
 
 /**
- * Usuwa wiersze planszy 'p', w których nie ma komórek
+ * Liczy zespołem 'watki' wątków 'ile' plansz 'p' do kolejnych z 'ile_zrzutow' rosnących
+ * generacji 'zrzuty', zapamiętując populację każdej z nich
  *
- * 'p' może ulec zmianie
+ * Plansze liczone są razem od jednej generacji zrzutu do następnej. Plansza, której
+ * gry nie można dalej liczyć, odpada.
  */
-void usun_puste_wiersze(Plansza** p)
+void licz_plansze(Plansza* p, int ile, const long long* zrzuty, int ile_zrzutow, int watki)
 {
-    Plansza* pom = (*p);
-    while (pom != NULL) {
-        if (pom -> k == NULL) {
-            if (pom -> poprz == NULL && pom -> nast == NULL) {
-                (*p) = NULL;
-                free(pom);
-                pom = NULL;
-            }
-            else if (pom -> poprz == NULL) {
-                Plansza* pom3 = pom -> nast;
-                pom3 -> poprz = NULL;
-                free(pom);
-                pom = pom3;
-                *p = pom3;
+    Zycie** gry = (Zycie**) malloc ((size_t) ile * sizeof(Zycie*));
+    int* nr = (int*) malloc ((size_t) ile * sizeof(int));
+    int* wyniki = (int*) malloc ((size_t) ile * sizeof(int));
+    for (int i = 0; i < ile_zrzutow; i++) {
+        int n = 0;
+        for (int j = 0; j < ile; j++)
+            if (p[j].dziala) {
+                gry[n] = p[j].z;
+                nr[n++] = j;
             }
-            else if (pom -> nast == NULL) {
-                pom -> poprz -> nast = NULL;
-                free(pom);
-                pom = NULL;
-            }
-            else {
-                Plansza* pom3 = pom -> poprz;
-                pom3 -> nast = pom -> nast;
-                pom -> nast -> poprz = pom3;
-                free(pom);
-                pom = pom3 -> nast;
+        zycie_licz_wiele(gry, n, zrzuty[i] - (i > 0 ? zrzuty[i - 1] : 0), watki, wyniki);
+        for (int j = 0; j < n; j++) {
+            Plansza* q = &p[nr[j]];
+            if (!wyniki[j]) {
+                q -> dziala = 0;
+                continue;
             }
+            q -> populacje[i] = zycie_nieskonczona(q -> z) ? -1 : zycie_populacja(q -> z);
+            q -> policzone++;
         }
-        else
-            pom = pom -> nast;
     }
+    free(gry);
+    free(nr);
+    free(wyniki);
 }
 
 /**
- * Usuwa komórki na planszy 'p', gdy:
- * -są martwe oraz
- * -wszyscy sąsiedzi danej komórki sa martwi
- *
- * Usuwa puste wiersze
+ * Pisze do 'f' wyniki planszy 'p' liczonej do generacji 'zrzuty'
  *
- * 'p' może ulec zmianie
+ * Wynik to linia "plansza" z numerem planszy i plikiem, populacje policzonych
+ * generacji, cykl i zrzut stanu ostatniej generacji, pominięty przy nieskończonej
+ * populacji. Zwraca 0 z opisem błędu na stderr, gdy planszy nie dało się policzyć
+ * do końca lub zapis się nie udał, wpp. 1
  */
-void usun_martwe(Plansza** p)
+int pisz_plansze(FILE* f, Plansza* p, const long long* zrzuty)
 {
-    usun_martwe_pom(*p);
-    usun_puste_wiersze(p);
+    fprintf(f, "plansza %lld", p -> nr);
+    if (p -> zrodlo != NULL)
+        fprintf(f, " %s", p -> zrodlo);
+    fprintf(f, "\n");
+    for (int i = 0; i < p -> policzone; i++)
+        if (p -> populacje[i] < 0)
+            fprintf(f, "generacja %lld populacja nieskonczona\n", zrzuty[i]);
+        else
+            fprintf(f, "generacja %lld populacja %lld\n", zrzuty[i], p -> populacje[i]);
+    if (!p -> dziala) {
+        fprintf(stderr, "plansza %lld: %s\n", p -> nr, zycie_blad(p -> z));
+        return 0;
+    }
+    int okres;
+    int dy;
+    int dx;
+    long long od;
+    if (zycie_okres(p -> z, &okres, &dy, &dx, &od))
+        fprintf(f, "cykl: okres %d, przesuniecie (%d, %d), od generacji %lld\n", okres, dy, dx, od);
+    else
+        fprintf(f, "cykl: nieznany\n");
+    if (zycie_nieskonczona(p -> z))
+        return 1;
+    fflush(f);
+    if (!zycie_zrzuc(p -> z, fileno(f))) {
+        fprintf(stderr, "plansza %lld: %s\n", p -> nr, zycie_blad(p -> z));
+        return 0;
+    }
+    return 1;
 }
 
 /**
- * Zeruje liczbe sąsiadów każdej komórki na planszy 'p'
+ * Liczy wiele niezależnych plansz do największej z 'ile' generacji 'zrzuty' zespołem
+ * 'watki_plansz' wątków i pisze wyniki każdej z nich (zob. pisz_plansze) do celu
+ * 'cel' (zob. otworz_cel), a gdy 'cel' jest NULL, na standardowe wyjście
+ *
+ * Plansze czyta się po kolei z 'ile_plikow' plików 'pliki', a gdy 'pliki' jest NULL, z wejścia;
+ * w każdym źródle może być wiele plansz, jedna za drugą. Każda plansza jest osobną grą
+ * silnika 'silnik' liczącego 'watki' wątkami według reguły 'regula', z własną pamięcią
+ * zwalnianą w całości po wypisaniu jej wyników. Plansze wczytuje się i liczy po
+ * PLANSZE_NARAZ, a wyniki pisze w kolejności wczytania.
+ * Zwraca 0 z opisem błędu na stderr, gdy któregoś źródła lub planszy nie udało się
+ * przeczytać lub policzyć albo zapis się nie udał, wpp. 1
  */
-void zeruj_sasiadow(Plansza* p)
+int rozgrywaj_wiele(const char* silnik, int watki, const char* regula, char** pliki, int ile_plikow,
+                    long long* zrzuty, int ile, const char* cel, int watki_plansz)
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            pom2 -> ile_sasiadow = 0;
-            pom2 = pom2 -> nast;
+    int fd = cel == NULL ? STDOUT_FILENO : otworz_cel(cel, stderr);
+    if (fd < 0)
+        return 0;
+    FILE* f = cel == NULL ? stdout : fdopen(cel[0] == '&' ? dup(fd) : fd, "w");
+    if (f == NULL) {
+        fprintf(stderr, "nie mozna otworzyc pliku: %s\n", cel);
+        return 0;
+    }
+    qsort(zrzuty, (size_t) ile, sizeof(long long), porownaj_generacje);
+    int n = 0;
+    for (int i = 0; i < ile; i++)
+        if (i == 0 || zrzuty[i] != zrzuty[i - 1])
+            zrzuty[n++] = zrzuty[i];
+    ile = n;
+    Plansza* p = (Plansza*) malloc (PLANSZE_NARAZ * sizeof(Plansza));
+    for (int i = 0; i < PLANSZE_NARAZ; i++)
+        p[i].populacje = (long long*) malloc ((size_t) ile * sizeof(long long));
+    Zrodla zr;
+    memset(&zr, 0, sizeof(zr));
+    zr.pliki = pliki;
+    zr.ile_plikow = ile_plikow;
+    int wynik = 1;
+    while (1) {
+        n = 0;
+        while (n < PLANSZE_NARAZ && nastepna_plansza(&zr, &p[n], silnik, watki, regula))
+            n++;
+        if (n == 0)
+            break;
+        licz_plansze(p, n, zrzuty, ile, watki_plansz);
+        for (int i = 0; i < n; i++) {
+            if (!pisz_plansze(f, &p[i], zrzuty))
+                wynik = 0;
+            zycie_usun(p[i].z);
         }
-        pom = pom -> nast;
     }
+    for (int i = 0; i < PLANSZE_NARAZ; i++)
+        free(p[i].populacje);
+    free(p);
+    if (fflush(f) != 0 || (cel != NULL && fclose(f) != 0)) {
+        fprintf(stderr, "nie udal sie zapis zrzutu: %s\n", cel == NULL ? "stdout" : cel);
+        wynik = 0;
+    }
+    return wynik && !zr.blad;
 }
 
 /**
- * Oblicza następną generacje komórek planszy 'p'
- *
- * Zapisuje następną generację na planszy 'p'
- *
- * 'p' może ulec zmianie
+ * Porównuje nazwy plików '*a' i '*b'
  */
-void nastepna_generacja(Plansza** p)
+int porownaj_nazwy(const void* a, const void* b)
 {
-    zlicz_sasiadow(*p);
-    aktualizuj_stan(*p);
-    zlicz_sasiadow(*p);
-    usun_martwe(p);
-    zeruj_sasiadow(*p);
-    tworz_sasiadow(p);
+    return strcmp(*(char* const*) a, *(char* const*) b);
 }
 
 /**
- * Pisze zrzut stanu planszy 'p'
+ * Zapisuje w '*pliki' ścieżki zwykłych plików katalogu 'katalog' w kolejności nazw,
+ * pomijając pliki ukryte
+ *
+ * Zwraca liczbę plików lub -1 z opisem błędu na stderr, gdy katalogu nie da się
+ * przeczytać
  */
-void zrzuc_stan(Plansza* p)
+int czytaj_katalog(const char* katalog, char*** pliki)
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL && pom2 -> stan == '.') {
-            pom2 = pom2 -> nast;
-        }
-        if (pom2 != NULL) {
-            printf("/%d %d", pom -> wiersz, pom2 -> kol);
-            pom2 = pom2 -> nast;
-            while (pom2 != NULL) {
-                if (pom2 -> stan == '0') {
-                    printf(" %d", pom2 -> kol);
-                }
-                pom2 = pom2 -> nast;
-            }
-            printf("\n");
+    DIR* d = opendir(katalog);
+    if (d == NULL) {
+        fprintf(stderr, "nie mozna otworzyc katalogu: %s\n", katalog);
+        return -1;
+    }
+    int n = 0;
+    *pliki = (char**) malloc (sizeof(char*));
+    struct dirent* e;
+    while ((e = readdir(d)) != NULL) {
+        if (e -> d_name[0] == '.')
+            continue;
+        size_t dlugosc = strlen(katalog) + strlen(e -> d_name) + 2;
+        char* sciezka = (char*) malloc (dlugosc);
+        snprintf(sciezka, dlugosc, "%s/%s", katalog, e -> d_name);
+        struct stat st;
+        if (stat(sciezka, &st) != 0 || !S_ISREG(st.st_mode)) {
+            free(sciezka);
+            continue;
         }
-        pom = pom -> nast;
+        *pliki = (char**) realloc (*pliki, (size_t) (n + 1) * sizeof(char*));
+        (*pliki)[n++] = sciezka;
     }
-    printf("/\n");
+    closedir(d);
+    qsort(*pliki, (size_t) n, sizeof(char*), porownaj_nazwy);
+    return n;
 }
 
 /**
- * Usuwa wszystkie komórki i wiersze planszy 'p'
+ * Zapisuje w '*wiersze' i '*kolumny' rozmiar okna zapisany w napisie 'napis' jako "WxK"
+ *
+ * Zwraca 0, gdy napis jest niepoprawny lub rozmiar przekracza NAJWIEKSZE_OKNO, wpp. 1
  */
-void czysc_plansze(Plansza* p)
+int czytaj_rozmiar_okna(const char* napis, int* wiersze, int* kolumny)
 {
-    Plansza* pom = p;
-    while (pom != NULL) {
-        Komorka* pom2 = pom -> k;
-        while (pom2 != NULL) {
-            Komorka* pom3 = pom2 -> nast;
-            free(pom2);
-            pom2 = pom3;
-        }
-        Plansza* pom4 = pom -> nast;
-        free(pom);
-        pom = pom4;
-    }
+    char* koniec;
+    long w = strtol(napis, &koniec, 10);
+    if (napis[0] < '0' || napis[0] > '9' || *koniec != 'x' || koniec[1] < '0' || koniec[1] > '9')
+        return 0;
+    long k = strtol(koniec + 1, &koniec, 10);
+    if (*koniec != '\0' || w > NAJWIEKSZE_OKNO || k > NAJWIEKSZE_OKNO)
+        return 0;
+    *wiersze = (int) w;
+    *kolumny = (int) k;
+    return 1;
 }
 
 /**
- * Rozgrywa grę na planszy 'p'.
- *
- * Czyta początkowy stan planszy oraz polecenia użytkownika
+ * Zapisuje w '*g' numer generacji zapisany w napisie 'napis'
  *
- * 'p' jest różne od NULL
+ * Zwraca 0, gdy napis nie jest nieujemną liczbą całkowitą mieszczącą się w long long,
+ * wpp. 1
  */
-void rozgrywaj(Plansza* p)
+int czytaj_generacje(const char* napis, long long* g)
 {
-    assert(p != NULL);
-    int w = 1;
-    int k = 1;
-    czytaj_plansze(p);
-    if (czy_plansza_pusta(p)) {
-        free(p -> k);
-        free(p);
-        p = NULL;
-    }
-    tworz_sasiadow(&p);
-    int x;
-    while (1) {
-        wyswietl_okno(p, w, k);
-        x = getchar();
-        if ((char) x == '.') {
-            czysc_plansze(p);
-            break;
-        }
-        else if ((char) x == '\n' || (char) x == EOF)
-            nastepna_generacja(&p);
-        else {
-            ungetc(x, stdin);
-            int y;
-            scanf("%d", &y);
-            x = getchar();
-            if ((char) x == ' ') {
-                w = y;
-                scanf("%d", &y);
-                k = y;
-                x = getchar();
-            }
-            else {
-                if (y == 0) {
-                    zrzuc_stan(p);
-                }
-                else {
-                    for (int i = 0; i < y; i++)
-                        nastepna_generacja(&p);
-                }
-            }
-        }
-    }
+    char* koniec;
+    errno = 0;
+    long long x = strtoll(napis, &koniec, 10);
+    if (napis[0] < '0' || napis[0] > '9' || *koniec != '\0' || errno != 0)
+        return 0;
+    *g = x;
+    return 1;
 }
 
 /**
- * Inicjuje plansze 'p' tworząć w niej komórke
- *
- * Ustawia wszystkie wskażniki na NULL
+ * Pisze na stderr sposób użycia programu 'program'
  */
-void inicjuj_plansze(Plansza** p)
+void pisz_uzycie(const char* program)
 {
-    
-    (*p) -> poprz = NULL;
-    (*p) -> nast = NULL;
-    (*p) -> k = (Komorka*) malloc (sizeof(Komorka));
-    (*p) -> k -> poprz = NULL;
-    (*p) -> k -> nast = NULL;
+    fprintf(stderr, "uzycie: %s [-s silnik] [-w watki] [-r regula] [-p plik | -b migawka]\n"
+                    "          [-e wierszexkolumny] [-d linie|ansi] [-a]\n", program);
+    fprintf(stderr, "       %s -n generacje [-z generacja]... [-o cel] [-s silnik] [-w watki]\n"
+                    "          [-r regula] [-p plik | -b migawka] [-a]\n", program);
+    fprintf(stderr, "       %s -n generacje -m watki [-z generacja]... [-o cel] [-s silnik] [-w watki]\n"
+                    "          [-r regula] [-p plik | -k katalog]\n", program);
+    fprintf(stderr, "       %s --bench [generacje] [-s silnik] [-w watki] [-r regula]\n", program);
+    fprintf(stderr, "silniki:");
+    for (int i = 0; zycie_nazwa_silnika(i) != NULL; i++)
+        fprintf(stderr, " %s", zycie_nazwa_silnika(i));
+    fprintf(stderr, "\n");
 }
 
 /**
- * Uruchamia program i tworzy plansze
+ * Uruchamia program z silnikiem i ustawieniami wybranymi w opcjach i tworzy plansze
  */
-int main(void) {
-    Plansza* p = (Plansza*) malloc (sizeof(Plansza));
-    inicjuj_plansze(&p);
-    rozgrywaj(p);
-    return 0;
+int main(int argc, char** argv) {
+    const char* silnik = zycie_nazwa_silnika(0);
+    int watki = 1;
+    const char* regula = NULL;
+    const char* plik = NULL;
+    const char* migawka = NULL;
+    const char* katalog = NULL;
+    int watki_plansz = 0;
+    int test = 0;
+    int generacje = GENERACJE_TESTU;
+    int wybrany = 0;
+    long long* zrzuty = NULL;
+    int ile_zrzutow = 0;
+    const char* cel = NULL;
+    int wiersze = WIERSZE;
+    int kolumny = KOLUMNY;
+    int tryb = OKNO_PELNE;
+    int asynchroniczne = 0;
+    for (int i = 1; i < argc; i++) {
+        long long x;
+        if (strcmp(argv[i], "-s") == 0 && i + 1 < argc) {
+            silnik = NULL;
+            for (int j = 0; zycie_nazwa_silnika(j) != NULL; j++)
+                if (strcmp(argv[i + 1], zycie_nazwa_silnika(j)) == 0)
+                    silnik = zycie_nazwa_silnika(j);
+            if (silnik == NULL) {
+                fprintf(stderr, "nieznany silnik: %s\n", argv[i + 1]);
+                pisz_uzycie(argv[0]);
+                return 1;
+            }
+            wybrany = 1;
+            i++;
+        }
+        else if (strcmp(argv[i], "--bench") == 0) {
+            test = 1;
+            if (i + 1 < argc && atoi(argv[i + 1]) > 0) {
+                generacje = atoi(argv[i + 1]);
+                i++;
+            }
+        }
+        else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            watki = atoi(argv[i + 1]);
+            i++;
+        }
+        else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            if (!zycie_poprawna_regula(argv[i + 1])) {
+                fprintf(stderr, "niepoprawna regula: %s\n", argv[i + 1]);
+                pisz_uzycie(argv[0]);
+                return 1;
+            }
+            regula = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc && migawka == NULL && katalog == NULL) {
+            plik = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc && plik == NULL && katalog == NULL) {
+            migawka = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc && plik == NULL && migawka == NULL) {
+            katalog = argv[i + 1];
+            i++;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc && atoi(argv[i + 1]) > 0) {
+            watki_plansz = atoi(argv[i + 1]);
+            i++;
+        }
+        else if ((strcmp(argv[i], "-n") == 0 || strcmp(argv[i], "-z") == 0) && i + 1 < argc
+                 && czytaj_generacje(argv[i + 1], &x)) {
+            zrzuty = (long long*) realloc (zrzuty, (size_t) (ile_zrzutow + 1) * sizeof(long long));
+            zrzuty[ile_zrzutow++] = x;
+            i++;
+        }
+        else if (strcmp(argv[i], "-e") == 0 && i + 1 < argc
+                 && czytaj_rozmiar_okna(argv[i + 1], &wiersze, &kolumny)) {
+            i++;
+        }
+        else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc
+                 && (strcmp(argv[i + 1], "linie") == 0 || strcmp(argv[i + 1], "ansi") == 0)) {
+            tryb = strcmp(argv[i + 1], "linie") == 0 ? OKNO_LINIE : OKNO_ANSI;
+            i++;
+        }
+        else if (strcmp(argv[i], "-a") == 0)
+            asynchroniczne = 1;
+        else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
+            cel = argv[i + 1];
+            i++;
+        }
+        else {
+            pisz_uzycie(argv[0]);
+            return 1;
+        }
+    }
+    if ((cel != NULL || watki_plansz > 0) && ile_zrzutow == 0) {
+        pisz_uzycie(argv[0]);
+        return 1;
+    }
+    if ((katalog != NULL || watki_plansz > 0) && (watki_plansz == 0 || migawka != NULL || asynchroniczne)) {
+        pisz_uzycie(argv[0]);
+        return 1;
+    }
+    if (test)
+        return zycie_testuj_wydajnosc(wybrany ? silnik : NULL, watki, regula, generacje);
+    if (watki > 1 && !zycie_silnik_wielowatkowy(silnik)) {
+        fprintf(stderr, "silnik %s liczy generacje jednym watkiem\n", silnik);
+        return 1;
+    }
+    if (watki_plansz > 0) {
+        char** pliki = NULL;
+        int ile_plikow = 0;
+        if (katalog != NULL && (ile_plikow = czytaj_katalog(katalog, &pliki)) < 0) {
+            free(zrzuty);
+            return 1;
+        }
+        if (plik != NULL) {
+            pliki = (char**) malloc (sizeof(char*));
+            pliki[0] = (char*) plik;
+            ile_plikow = 1;
+        }
+        int wynik = rozgrywaj_wiele(silnik, watki, regula, pliki, ile_plikow,
+                                    zrzuty, ile_zrzutow, cel, watki_plansz);
+        for (int i = 0; katalog != NULL && i < ile_plikow; i++)
+            free(pliki[i]);
+        free(pliki);
+        free(zrzuty);
+        return !wynik;
+    }
+    Zycie* z = zycie_tworz(silnik, watki, regula);
+    Czytnik* wejscie = zycie_czytnik(STDIN_FILENO);
+    int wynik = 1;
+    if (migawka != NULL)
+        wynik = zycie_wczytaj_migawke(z, migawka);
+    else if (plik != NULL) {
+        Czytnik* plansza = zycie_czytnik_pliku(plik);
+        if (plansza == NULL) {
+            fprintf(stderr, "nie mozna otworzyc pliku: %s\n", plik);
+            zycie_usun(z);
+            zycie_zamknij_czytnik(wejscie);
+            return 1;
+        }
+        wynik = zycie_wczytaj(z, plansza);
+        zycie_zamknij_czytnik(plansza);
+    }
+    else
+        wynik = zycie_wczytaj(z, wejscie);
+    if (!wynik)
+        fprintf(stderr, "%s\n", zycie_blad(z));
+    else {
+        Wyjscie wy;
+        tworz_wyjscie(&wy, asynchroniczne, ile_zrzutow > 0);
+        if (ile_zrzutow > 0)
+            wynik = rozgrywaj_wsadowo(&wy, z, zrzuty, ile_zrzutow, cel);
+        else {
+            Okno* o = zycie_tworz_okno(wiersze, kolumny, tryb, wy.f);
+            wynik = rozgrywaj(&wy, z, o, wejscie);
+            zycie_usun_okno(o);
+        }
+        zakoncz_wyjscie(&wy);
+    }
+    zycie_usun(z);
+    free(zrzuty);
+    zycie_zamknij_czytnik(wejscie);
+    return !wynik;
 }
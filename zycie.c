@@ -0,0 +1,8190 @@
+/**
+ * "Zycie" - biblioteka
+ *
+ * Silniki liczące kolejne generacje świata komórek, rozgrywana gra z historią,
+ * w której szuka się cykli, wczytywanie planszy i poleceń, okno, zrzuty, migawki,
+ * zapytania o plansze i test wydajności. Interfejs biblioteki opisuje zycie.h,
+ * a program "zycie" (main.c) jest jej klientem.
+ *
+ * W następnej generacji komórka będzie żywa wtedy i tylko wtedy, gdy:
+ * -w bieżącej generacji jest żywa i ma dokładnie dwóch lub trzech żywych sąsiadów,
+ * -w bieżącej generacji jest martwa i ma dokładnie trzech żywych sąsiadów,
+ * albo według innej reguły B/S podanej przy tworzeniu gry.
+ *
+ * Współrzędne komórek są 64-bitowe, a silniki liczą na 32-bitowych względem
+ * początków skupisk planszy (zob. Gra).
+ *
+ * autor: Michał Korniak
+ *
+ * data: 30 grudnia 2022
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <stdarg.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "zycie.h"
+
+/**
+ * Reprezentuje regułę zapisaną jako "Bnarodziny/Sprzetrwanie", np. "B3/S23"
+ *
+ * 'narodziny' - bit n jest ustawiony, gdy martwa komórka o n żywych sąsiadach ożywa
+ * 'przetrwanie' - bit n jest ustawiony, gdy żywa komórka o n żywych sąsiadach przeżywa
+ */
+typedef struct Regula_
+{
+    int narodziny;
+    int przetrwanie;
+} Regula;
+
+/**
+ * Maska wszystkich możliwych liczb sąsiadów, od 0 do 8
+ */
+#define WSZYSCY_SASIEDZI 0x1FF
+
+/**
+ * Maski reguły "Game of Life" B3/S23
+ */
+#define NARODZINY_CONWAYA (1 << 3)
+#define PRZETRWANIE_CONWAYA ((1 << 2) | (1 << 3))
+
+/**
+ * Zwraca 1, gdy według reguły 'r' komórka żywa ('zywa' = 1) lub martwa ('zywa' = 0)
+ * o 'sasiedzi' żywych sąsiadach będzie żywa w następnej generacji, wpp. 0
+ */
+static inline int nowy_stan(const Regula* r, int zywa, int sasiedzi)
+{
+    return ((zywa ? r -> przetrwanie : r -> narodziny) >> sasiedzi) & 1;
+}
+
+/**
+ * Moduł haszy komórek, liczba pierwsza 2^61 - 1
+ */
+#define MODUL_HASZU ((1ULL << 61) - 1)
+
+/**
+ * Podstawy haszy komórek: komórka w wierszu y i kolumnie x ma hasz A^y * B^x mod MODUL_HASZU
+ */
+#define PODSTAWA_WIERSZY 0x1b873593a5f0e2c1ULL
+#define PODSTAWA_KOLUMN 0x0c2b2ae35d4f1a97ULL
+
+/**
+ * Odwrotności A, B i B - 1 modulo MODUL_HASZU
+ */
+#define ODWROTNOSC_WIERSZY 0x09660dc6b63429ecULL
+#define ODWROTNOSC_KOLUMN 0x1b788dd0b4ad81f9ULL
+#define ODWROTNOSC_KOLUMN_1 0x1dd2c39b3a3a9bb1ULL
+
+/**
+ * Zwraca 'a' * 'b' mod MODUL_HASZU dla 'a', 'b' mniejszych od modułu
+ */
+static inline uint64_t mnoz_mod(uint64_t a, uint64_t b)
+{
+    unsigned __int128 x = (unsigned __int128) a * b;
+    uint64_t w = ((uint64_t) x & MODUL_HASZU) + (uint64_t) (x >> 61);
+    return w >= MODUL_HASZU ? w - MODUL_HASZU : w;
+}
+
+/**
+ * Zwraca 'a' ^ 'e' mod MODUL_HASZU, również dla ujemnego 'e'
+ */
+static uint64_t potega_mod(uint64_t a, long long e)
+{
+    long long okres = (long long) (MODUL_HASZU - 1);
+    long long r = e >= 0 && e < okres ? e : e % okres;
+    uint64_t k = (uint64_t) (r < 0 ? r + okres : r);
+    uint64_t w = 1;
+    while (k > 0) {
+        if (k & 1)
+            w = mnoz_mod(w, a);
+        a = mnoz_mod(a, a);
+        k >>= 1;
+    }
+    return w;
+}
+
+/**
+ * Reprezentuje odcisk generacji
+ *
+ * Hasz generacji to suma haszy jej żywych komórek (zob. PODSTAWA_WIERSZY), więc
+ * zmianę generacji można doliczać komórka po komórce, a przesunięcie generacji
+ * o 'dy', 'dx' mnoży hasz przez A^dy * B^dx.
+ *
+ * 'hasz' - hasz generacji
+ * 'populacja' - liczba żywych komórek
+ * 'wiersz', 'kol' - lewy górny róg najmniejszego prostokąta z żywymi komórkami
+ */
+typedef struct Odcisk_
+{
+    uint64_t hasz;
+    long long populacja;
+    long long wiersz;
+    long long kol;
+} Odcisk;
+
+/**
+ * Zwraca sumę haszy 'n' komórek wiersza 'wiersz' w rosnących kolumnach 'kol'
+ */
+static uint64_t hasz_wiersza(int wiersz, const int* kol, int n)
+{
+    if (n == 0)
+        return 0;
+    uint64_t b = potega_mod(PODSTAWA_KOLUMN, kol[0]);
+    uint64_t suma = b;
+    for (int i = 1; i < n; i++) {
+        int d = kol[i] - kol[i - 1];
+        b = mnoz_mod(b, d == 1 ? PODSTAWA_KOLUMN : potega_mod(PODSTAWA_KOLUMN, d));
+        suma += b;
+        if (suma >= MODUL_HASZU)
+            suma -= MODUL_HASZU;
+    }
+    return mnoz_mod(potega_mod(PODSTAWA_WIERSZY, wiersz), suma);
+}
+
+/**
+ * Dolicza do odcisku 'kontekst' wiersz 'wiersz' z 'n' żywymi komórkami w kolumnach 'kol'
+ *
+ * Wiersze muszą przychodzić w kolejności rosnących numerów, a odcisk przed pierwszym
+ * wierszem musi być wyzerowany
+ */
+static void dolicz_do_odcisku(void* kontekst, int wiersz, const int* kol, int n)
+{
+    Odcisk* o = (Odcisk*) kontekst;
+    if (n == 0)
+        return;
+    if (o -> populacja == 0) {
+        o -> wiersz = wiersz;
+        o -> kol = kol[0];
+    }
+    if (kol[0] < o -> kol)
+        o -> kol = kol[0];
+    o -> hasz = (o -> hasz + hasz_wiersza(wiersz, kol, n)) % MODUL_HASZU;
+    o -> populacja += n;
+}
+
+/**
+ * Uaktualnia odcisk 'o' generacji przesuniętej o 'dy' wierszy i 'dx' kolumn
+ */
+static void przesun_odcisk(Odcisk* o, int dy, int dx)
+{
+    uint64_t m = mnoz_mod(potega_mod(PODSTAWA_WIERSZY, dy), potega_mod(PODSTAWA_KOLUMN, dx));
+    o -> hasz = mnoz_mod(o -> hasz, m);
+    o -> wiersz += dy;
+    o -> kol += dx;
+}
+
+/**
+ * Reprezentuje populację i najmniejszy prostokąt zawierający żywe komórki
+ *
+ * Prostokąt ma sens tylko dla niezerowej populacji.
+ */
+typedef struct Obszar_
+{
+    long long populacja;
+    int w_min;
+    int w_max;
+    int k_min;
+    int k_max;
+} Obszar;
+
+/**
+ * Dolicza do obszaru 'o' wiersz 'wiersz' z 'n' > 0 żywymi komórkami w kolumnach
+ * od 'pierwsza' do 'ostatnia'
+ *
+ * Wiersze muszą przychodzić w kolejności rosnących numerów, a obszar przed pierwszym
+ * wierszem musi być wyzerowany
+ */
+static inline void dolicz_wiersz_do_obszaru(Obszar* o, int wiersz, int pierwsza, int ostatnia, int n)
+{
+    if (o -> populacja == 0) {
+        o -> w_min = wiersz;
+        o -> k_min = pierwsza;
+        o -> k_max = ostatnia;
+    }
+    o -> w_max = wiersz;
+    if (pierwsza < o -> k_min)
+        o -> k_min = pierwsza;
+    if (ostatnia > o -> k_max)
+        o -> k_max = ostatnia;
+    o -> populacja += n;
+}
+
+/**
+ * Dolicza do obszaru 'o' obszar 'b' wierszy leżących za wierszami 'o'
+ */
+static inline void dolicz_obszar_pasa(Obszar* o, const Obszar* b)
+{
+    if (b -> populacja == 0)
+        return;
+    if (o -> populacja == 0) {
+        *o = *b;
+        return;
+    }
+    o -> w_max = b -> w_max;
+    if (b -> k_min < o -> k_min)
+        o -> k_min = b -> k_min;
+    if (b -> k_max > o -> k_max)
+        o -> k_max = b -> k_max;
+    o -> populacja += b -> populacja;
+}
+
+/**
+ * Przesuwa prostokąt obszaru 'o' o 'dy' wierszy i 'dx' kolumn
+ */
+static void przesun_obszar(Obszar* o, int dy, int dx)
+{
+    if (o -> populacja == 0)
+        return;
+    o -> w_min += dy;
+    o -> w_max += dy;
+    o -> k_min += dx;
+    o -> k_max += dx;
+}
+
+/**
+ * Dolicza wiersz 'wiersz' z żywymi komórkami w kolumnach 'kol' do obszaru 'kontekst'
+ */
+static void dolicz_obszar(void* kontekst, int wiersz, const int* kol, int n)
+{
+    dolicz_wiersz_do_obszaru((Obszar*) kontekst, wiersz, kol[0], kol[n - 1], n);
+}
+
+/**
+ * Dolicza do liczby wskazywanej przez 'kontekst' liczbę żywych komórek wiersza
+ */
+static void dolicz_populacje(void* kontekst, int wiersz, const int* kol, int n)
+{
+    (void) wiersz;
+    (void) kol;
+    *(long long*) kontekst += n;
+}
+
+/**
+ * Zwraca 'x' * 'a' ^ 'd' mod MODUL_HASZU, gdzie 'odwrotnosc' to 'a' ^ -1
+ *
+ * Dla małych |'d'| kosztuje kilka mnożeń
+ */
+static inline uint64_t przesun_potege(uint64_t x, uint64_t a, uint64_t odwrotnosc, long long d)
+{
+    if (d == 1)
+        return mnoz_mod(x, a);
+    return mnoz_mod(x, d >= 0 ? potega_mod(a, d) : potega_mod(odwrotnosc, -d));
+}
+
+/**
+ * Liczba początkowych potęg B w tablicy POTEGI_KOLUMN
+ */
+#define ILE_POTEG_KOLUMN 16
+
+/**
+ * B ^ d mod MODUL_HASZU dla d = 0..ILE_POTEG_KOLUMN - 1, czyli krótkich odstępów
+ * między zmienionymi komórkami wiersza
+ */
+static const uint64_t POTEGI_KOLUMN[ILE_POTEG_KOLUMN] = {
+    0x0000000000000001ULL, 0x0c2b2ae35d4f1a97ULL, 0x0c5fdff3247641feULL, 0x17a1d636065d0ef3ULL,
+    0x13f84c9a85782b4cULL, 0x136da20b9090df11ULL, 0x0d82e772042638dfULL, 0x153a97ab76ac6781ULL,
+    0x0b95ae712786fcbbULL, 0x0742291e8e686928ULL, 0x1eada46db4889eddULL, 0x098e18fda413dcbaULL,
+    0x1aeec3a3928ec929ULL, 0x102a1329e31b4997ULL, 0x01f92a35d35f4e8bULL, 0x1325c3b40b594e33ULL,
+};
+
+/**
+ * Reprezentuje zmianę haszu generacji zbieraną w trakcie kroku
+ *
+ * Komórki, które zmieniły stan, dolicza się wiersz po wierszu, a potęgi podstaw haszu
+ * przenosi z komórki na komórkę i z wiersza na wiersz (zob. przesun_potege), więc
+ * każda zmiana kosztuje kilka mnożeń, a komórki bez zmian nic.
+ *
+ * 'hasz' - suma haszy komórek zamkniętych wierszy, które ożyły, minus tych, które umarły
+ * 'a' - A ^ 'wiersz_a'
+ * 'b' - B ^ 'kol_b'
+ * 'roznica' - suma potęg B kolumn komórek otwartego wiersza, które ożyły, minus tych,
+ *             które umarły
+ */
+typedef struct ZmianyOdcisku_
+{
+    uint64_t hasz;
+    uint64_t a;
+    long long wiersz_a;
+    uint64_t b;
+    long long kol_b;
+    uint64_t roznica;
+} ZmianyOdcisku;
+
+/**
+ * Przygotowuje puste zmiany 'z'
+ */
+static void zacznij_zmiany(ZmianyOdcisku* z)
+{
+    memset(z, 0, sizeof(ZmianyOdcisku));
+    z -> a = 1;
+    z -> b = 1;
+}
+
+/**
+ * Dolicza do otwartego wiersza zmian 'z' komórki w kolumnach od 'od' do 'do_', które
+ * ożyły, gdy 'ozyly' jest niezerowe, lub umarły wpp.
+ *
+ * Suma potęg B ciągu komórek to B ^ 'od' * (B ^ długość - 1) / (B - 1)
+ */
+static inline void dolicz_zmiane(ZmianyOdcisku* z, long long od, long long do_, int ozyly)
+{
+    long long d = od - z -> kol_b;
+    if (d >= 0 && d < ILE_POTEG_KOLUMN)
+        z -> b = mnoz_mod(z -> b, POTEGI_KOLUMN[d]);
+    else
+        z -> b = przesun_potege(z -> b, PODSTAWA_KOLUMN, ODWROTNOSC_KOLUMN, d);
+    z -> kol_b = od;
+    uint64_t x = z -> b;
+    if (do_ > od)
+        x = mnoz_mod(mnoz_mod(x, potega_mod(PODSTAWA_KOLUMN, do_ - od + 1) - 1), ODWROTNOSC_KOLUMN_1);
+    z -> roznica += ozyly ? x : MODUL_HASZU - x;
+    if (z -> roznica >= MODUL_HASZU)
+        z -> roznica -= MODUL_HASZU;
+}
+
+/**
+ * Zamyka otwarty wiersz zmian 'z' jako wiersz 'wiersz'
+ */
+static inline void zamknij_wiersz_zmian(ZmianyOdcisku* z, int wiersz)
+{
+    if (z -> roznica != 0) {
+        z -> a = przesun_potege(z -> a, PODSTAWA_WIERSZY, ODWROTNOSC_WIERSZY, wiersz - z -> wiersz_a);
+        z -> wiersz_a = wiersz;
+        z -> hasz += mnoz_mod(z -> a, z -> roznica);
+        if (z -> hasz >= MODUL_HASZU)
+            z -> hasz -= MODUL_HASZU;
+    }
+    z -> roznica = 0;
+}
+
+/**
+ * Uaktualnia odcisk 'o' o zmiany 'z' kroku, po którym obszar planszy to 'ob'
+ */
+static void zakoncz_zmiany(Odcisk* o, const ZmianyOdcisku* z, const Obszar* ob)
+{
+    o -> hasz = (o -> hasz + z -> hasz) % MODUL_HASZU;
+    o -> populacja = ob -> populacja;
+    o -> wiersz = ob -> w_min;
+    o -> kol = ob -> k_min;
+}
+
+/**
+ * Reprezentuje komórke
+ *
+ * 'stan' - aktualny stan komórki
+ * 'ile_sasiadow'- liczba sasiadow komorki
+ * 'kol' - numer kolumny w której jest komórka
+ * 'poprz' - wskaźnik do poprzedniej komórki w wierszu
+ * 'nast' - wskaźnik do następnej komórki w wierszu
+ */
+typedef struct Komorka_
+{
+    char stan;
+    int ile_sasiadow;
+    int kol;
+    struct Komorka_* poprz;
+    struct Komorka_* nast;
+} Komorka;
+
+/**
+ * Reprezentuja wiersz planszy
+ *
+ * 'wiersz' - numer wiersza
+ * 'k'- wskaźnik do pierwszej komórki w wierszu
+ * 'poprz' - wskaznik do poprzedniego wiersza
+ * 'nast' - wskaźnik do następnego wiersza
+ */
+typedef struct Plansza_
+{
+    int wiersz;
+    Komorka* k;
+    struct Plansza_* poprz;
+    struct Plansza_* nast;
+} Plansza;
+
+/**
+ * Liczba węzłów w jednym bloku puli
+ */
+#ifndef ROZMIAR_BLOKU
+#define ROZMIAR_BLOKU 1024
+#endif
+
+/**
+ * Reprezentuje węzeł puli
+ *
+ * Komórki i wiersze mają ten sam rozmiar, więc dzielą jedną pulę.
+ * 'wolny' - wskaźnik do następnego wolnego węzła, gdy węzeł nie jest używany
+ */
+typedef union Wezel_
+{
+    Komorka k;
+    Plansza p;
+    union Wezel_* wolny;
+} Wezel;
+
+/**
+ * Reprezentuje blok węzłów przydzielony jednym wywołaniem malloc
+ *
+ * 'nast' - wskaźnik do następnego bloku
+ * 'w' - węzły bloku
+ */
+typedef struct Blok_
+{
+    struct Blok_* nast;
+    Wezel w[ROZMIAR_BLOKU];
+} Blok;
+
+/**
+ * Numery faz liczenia generacji w tablicy czasów funkcji nastepna_generacja
+ */
+#define FAZA_ZLICZ 0
+#define FAZA_AKTUALIZUJ 1
+#define FAZA_USUN 2
+#define FAZA_ZERUJ 3
+#define FAZA_TWORZ 4
+#define ILE_FAZ 5
+
+/**
+ * Reprezentuje liczniki liczenia generacji na planszy listowej
+ *
+ * Liczniki istnieją i są uaktualniane tylko w programie skompilowanym z flagą STATYSTYKI.
+ *
+ * 'generacje' - liczba policzonych generacji
+ * 'nowe_komorki' - liczba komórek utworzonych przy liczeniu generacji
+ * 'nowe_wiersze' - liczba wierszy utworzonych przy liczeniu generacji
+ * 'usuniete_komorki' - liczba komórek usuniętych przy liczeniu generacji
+ * 'usuniete_wiersze' - liczba wierszy usuniętych przy liczeniu generacji
+ * 'czasy' - łączne czasy faz nastepna_generacja w sekundach (zob. FAZA_*)
+ */
+typedef struct Liczniki_
+{
+    long long generacje;
+    long long nowe_komorki;
+    long long nowe_wiersze;
+    long long usuniete_komorki;
+    long long usuniete_wiersze;
+    double czasy[ILE_FAZ];
+} Liczniki;
+
+/**
+ * Reprezentuje pulę węzłów planszy
+ *
+ * Węzły zwolnione w jednej generacji są ponownie używane w następnych,
+ * a całą pamięć oddaje się naraz w zwolnij_pule.
+ *
+ * 'bloki' - lista bloków, pierwszy z nich jest aktualnie zapełniany
+ * 'uzyte' - liczba węzłów wydanych z pierwszego bloku
+ * 'wolne' - lista zwolnionych węzłów
+ * 'przydzielone' - liczba węzłów wydanych z bloków
+ * 'ponownie_uzyte' - liczba węzłów wydanych z listy zwolnionych
+ * 'w_uzyciu' - liczba węzłów aktualnie w użyciu
+ * 'szczyt' - największa liczba węzłów w użyciu jednocześnie
+ * 'ile_blokow' - liczba bloków
+ * 'liczniki' - liczniki liczenia generacji na planszy używającej puli (z flagą STATYSTYKI)
+ */
+typedef struct Pula_
+{
+    Blok* bloki;
+    int uzyte;
+    Wezel* wolne;
+    long long przydzielone;
+    long long ponownie_uzyte;
+    long long w_uzyciu;
+    long long szczyt;
+    long long ile_blokow;
+#ifdef STATYSTYKI
+    Liczniki liczniki;
+#endif
+} Pula;
+
+/**
+ * Dolicza 'n' do licznika 'pole' puli 'pula', tylko z flagą STATYSTYKI
+ *
+ * CZASY_FAZ('pula') to tablica czasów faz puli 'pula' lub NULL bez flagi STATYSTYKI
+ */
+#ifdef STATYSTYKI
+#define DOLICZ(pula, pole, n) ((pula) -> liczniki.pole += (n))
+#define CZASY_FAZ(pula) ((pula) -> liczniki.czasy)
+#else
+#define DOLICZ(pula, pole, n) ((void) 0)
+#define CZASY_FAZ(pula) ((double*) NULL)
+#endif
+
+/**
+ * Inicjuje pustą pulę 'pula'
+ */
+static void inicjuj_pule(Pula* pula)
+{
+    pula -> bloki = NULL;
+    pula -> uzyte = ROZMIAR_BLOKU;
+    pula -> wolne = NULL;
+    pula -> przydzielone = 0;
+    pula -> ponownie_uzyte = 0;
+    pula -> w_uzyciu = 0;
+    pula -> szczyt = 0;
+    pula -> ile_blokow = 0;
+#ifdef STATYSTYKI
+    memset(&pula -> liczniki, 0, sizeof(Liczniki));
+#endif
+}
+
+/**
+ * Zwraca adres wolnego węzła z puli 'pula'
+ *
+ * Najpierw używa węzłów zwolnionych, potem kolejnych węzłów bloku
+ */
+static void* przydziel_wezel(Pula* pula)
+{
+    Wezel* w;
+    if (pula -> wolne != NULL) {
+        w = pula -> wolne;
+        pula -> wolne = w -> wolny;
+        pula -> ponownie_uzyte++;
+    }
+    else {
+        if (pula -> uzyte == ROZMIAR_BLOKU) {
+            Blok* b = (Blok*) malloc (sizeof(Blok));
+            b -> nast = pula -> bloki;
+            pula -> bloki = b;
+            pula -> uzyte = 0;
+            pula -> ile_blokow++;
+        }
+        w = &pula -> bloki -> w[pula -> uzyte++];
+        pula -> przydzielone++;
+    }
+    pula -> w_uzyciu++;
+    if (pula -> w_uzyciu > pula -> szczyt)
+        pula -> szczyt = pula -> w_uzyciu;
+    return w;
+}
+
+/**
+ * Oddaje węzeł 'x' do puli 'pula'
+ */
+static void zwolnij_wezel(Pula* pula, void* x)
+{
+    Wezel* w = (Wezel*) x;
+    w -> wolny = pula -> wolne;
+    pula -> wolne = w;
+    pula -> w_uzyciu--;
+}
+
+/**
+ * Zwalnia wszystkie bloki puli 'pula'
+ *
+ * Wszystkie węzły puli przestają być ważne
+ */
+static void zwolnij_pule(Pula* pula)
+{
+    Blok* b = pula -> bloki;
+    while (b != NULL) {
+        Blok* b2 = b -> nast;
+        free(b);
+        b = b2;
+    }
+    pula -> bloki = NULL;
+    pula -> uzyte = ROZMIAR_BLOKU;
+    pula -> wolne = NULL;
+    pula -> w_uzyciu = 0;
+    pula -> ile_blokow = 0;
+}
+
+/**
+ * Pisze do 'f' liczniki puli 'pula'
+ */
+static void pisz_statystyki_puli(Pula* pula, FILE* f)
+{
+    fprintf(f, "pula: przydzielone %lld, ponownie uzyte %lld, szczyt %lld wezlow (%lld B)\n",
+            pula -> przydzielone, pula -> ponownie_uzyte, pula -> szczyt,
+            pula -> ile_blokow * (long long) sizeof(Blok));
+}
+
+/**
+ * Tworzy i dodaje komórke na koniec wiersza bezpośrednio za 'k'
+ *
+ * Zwraca w wyniku adres nowej komórki
+ *
+ * k jest różne od NULL
+ */
+static Komorka* dodaj_komorke(Komorka* k, Pula* pula)
+{
+    assert(k != NULL);
+    Komorka* k2 = (Komorka*) przydziel_wezel(pula);
+    k -> nast = k2;
+    k2 -> poprz = k;
+    k2 -> nast = NULL;
+    return k2;
+}
+
+/**
+ * Tworzy i dodaje wiersz na koniec planszy bezpośrednio za 'p'
+ *
+ * Zwraca w wyniku adres nowego wiersza
+ *
+ * p jest różne od NULL
+ */
+static Plansza* dodaj_wiersz(Plansza* p, Pula* pula)
+{
+    assert(p != NULL);
+    Plansza* p2 = (Plansza*) przydziel_wezel(pula);
+    p -> nast = p2;
+    p2 -> poprz = p;
+    p2 -> nast = NULL;
+    return p2;
+}
+
+/**
+ * Tworzy wiersz oraz komórke w nim takie, że
+ * -numer wiersza jest równy numerowi wiersza 'pom' + 'w' oraz
+ * -numer kolumny komórki jest równy numerowi komórki 'pom2' + 'n'
+ *
+ * 'pom' i 'pom2' są różne od NULL, w = {-1, 1},  'n' = {-1, 0, 1}
+ */
+static void tworz_wiersz(Plansza* pom, Komorka* pom2, int w, int n, Pula* pula)
+{
+    assert(pom != NULL);
+    assert(pom2 != NULL);
+    assert(w == -1 || w == 1);
+    assert(n >= -1 && n <= 1);
+    Plansza* pomw = (Plansza*) przydziel_wezel(pula);
+    DOLICZ(pula, nowe_wiersze, 1);
+    DOLICZ(pula, nowe_komorki, 1);
+    if (w == -1) {
+        if (pom -> poprz != NULL)
+            pom -> poprz -> nast = pomw;
+        pomw -> poprz = pom -> poprz;
+        pomw -> nast = pom;
+        pom -> poprz = pomw;
+    }
+    else {
+        if (pom -> nast != NULL)
+            pom -> nast -> poprz = pomw;
+        pomw -> nast = pom -> nast;
+        pomw -> poprz = pom;
+        pom -> nast = pomw;
+    }
+    pomw -> wiersz = pom -> wiersz + w;
+    pomw -> k = (Komorka*) przydziel_wezel(pula);
+    pomw -> k -> stan = '.';
+    pomw -> k -> ile_sasiadow = 0;
+    pomw -> k -> kol = pom2 -> kol + n;
+    pomw -> k -> poprz = NULL;
+    pomw -> k -> nast = NULL;
+}
+
+/**
+ * Tworzy komórke w wierszu 'pomw' przed komórką 'pom3', taką że
+ * numer jej wiersza jest równy numerowi wiersza 'pom2' + 'n'
+ *
+ * 'pomw' jest rozne od NULL, 'n' = {-1, 0, 1}, 'pom3', 'pom2' są rozne od NULL
+ */
+static void tworz_komorke(Plansza* pomw, Komorka* pom3, Komorka* pom2, int n, Pula* pula)
+{
+    assert(pomw != NULL);
+    assert(n >= -1 && n <= 1);
+    assert(pom3 != NULL);
+    assert(pom2 != NULL);
+    Komorka* k2 = (Komorka*) przydziel_wezel(pula);
+    DOLICZ(pula, nowe_komorki, 1);
+    if (pom3 -> poprz != NULL)
+        pom3 -> poprz -> nast = k2;
+    k2 -> poprz = pom3 -> poprz;
+    k2 -> nast = pom3;
+    pom3 -> poprz = k2;
+    k2 -> stan = '.';
+    k2 -> ile_sasiadow = 0;
+    k2 -> kol = pom2 -> kol + n;
+    if (k2 -> poprz == NULL) {
+        pomw -> k = k2;
+    }
+}
+
+/**
+ * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu,
+ * w którym jest 'pom2' począwszy od 'pom2' takich, że:
+ * -znajdują się w wierszu 'pomw' oraz
+ * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ *
+ * 'pomw' jest różne od NULL, n = {-1, 0 , 1}
+ */
+static void tworz_sasiadow_pom_pom(Plansza* pomw, Komorka* pom2, int n, Pula* pula)
+{
+    assert(pomw != NULL);
+    assert(n >= -1 && n <= 1);
+    Komorka* pom3 = pomw -> k;
+    Komorka* pom4 = NULL;
+    while (pom2 != NULL) {
+        if (pom2 -> stan == '0') {
+            if (pom3 == NULL) {
+                pom3 = dodaj_komorke(pom4, pula);
+                DOLICZ(pula, nowe_komorki, 1);
+                pom3 -> stan = '.';
+                pom3 -> ile_sasiadow = 0;
+                pom3 -> kol = pom2 -> kol + n;
+            }
+            else if (pom2 -> kol + n < pom3 -> kol) {
+                tworz_komorke(pomw, pom3, pom2, n, pula);
+                pom2 = pom2 -> nast;
+            }
+            else if (pom2 -> kol + n == pom3 -> kol) {
+                pom2 = pom2 -> nast;
+                pom4 = pom3;
+                pom3 = pom3 -> nast;
+            }
+            else if (pom2 -> kol + n > pom3 -> kol) {
+                pom4 = pom3;
+                pom3 = pom3 -> nast;
+            }
+        }
+        else
+            pom2 = pom2 -> nast;
+    }
+}
+
+/**
+ * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom' takich, że:
+ * -znajdują się w wierszu o numerze 'pom' -> kol  +  'w' oraz
+ * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ *
+ * pom jest różne od NULL, n = {-1, 0 , 1}, w = {-1, 1}
+ */
+static void tworz_sasiadow_pom(Plansza* pom, int w, int n, Pula* pula)
+{
+    assert(pom != NULL);
+    assert(w == -1 || w == 1);
+    assert(n >= -1 && n <= 1);
+    Komorka* pom2 = pom -> k;
+    Plansza* pomw;
+    if (w == -1)
+        pomw = pom -> poprz;
+    else
+        pomw = pom -> nast;
+    int ok = 1;
+    while (pom2 != NULL && ok) {
+        if (pom2 -> stan == '0' && (pomw == NULL || pom -> wiersz + w != pomw -> wiersz)) {
+            tworz_wiersz(pom, pom2, w, n, pula);
+            ok = 0;
+        }
+        else if (pom2 -> stan == '0') {
+            ok = 0;
+            break;
+        }
+        pom2 = pom2 -> nast;
+    }
+    if (w == -1)
+        pomw = pom -> poprz;
+    else
+        pomw = pom -> nast;
+    if (ok == 0) {
+        tworz_sasiadow_pom_pom(pomw, pom2, n, pula);
+    }
+}
+
+/**
+ * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom' takich, że:
+ * -znajdują się w wierszu 'pom' oraz
+ * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ *
+ * pom jest różne od NULL, n = -1 lub n = 1
+ */
+static void tworz_sasiadow_pom2(Plansza* pom, int n, Pula* pula)
+{
+    assert(pom != NULL);
+    assert(n == -1 || n == 1);
+    Komorka* pom2 = pom -> k;
+    while (pom2 != NULL) {
+        if (pom2 -> stan == '0') {
+            if (n == -1) {
+                if (pom2 -> poprz == NULL || pom2 -> kol - 1 != pom2 -> poprz -> kol) {
+                    tworz_komorke(pom, pom2, pom2, -1, pula);
+                }
+            }
+            else {
+                if (pom2 -> nast == NULL || pom2 -> kol + 1 != pom2 -> nast -> kol) {
+                    Komorka* k2 = (Komorka*) przydziel_wezel(pula);
+                    DOLICZ(pula, nowe_komorki, 1);
+                    if (pom2 -> nast != NULL)
+                        pom2 -> nast -> poprz = k2;
+                    k2 -> nast = pom2 -> nast;
+                    k2 -> poprz = pom2;
+                    pom2 -> nast = k2;
+                    k2 -> stan = '.';
+                    k2 -> ile_sasiadow = 0;
+                    k2 -> kol = pom2 -> kol + 1;
+                }
+            }
+        }
+        pom2 = pom2 -> nast;
+    }
+}
+
+/**
+ * Tworzy wszystkich sąsiadów każdej żywej komórki w wierszu 'pom'
+ *
+ * pom jest różne od NULL
+ */
+static void tworz_sasiadow_wiersz(Plansza* pom, Pula* pula)
+{
+    assert(pom != NULL);
+    tworz_sasiadow_pom(pom, -1, -1, pula);
+    tworz_sasiadow_pom(pom, -1, 0, pula);
+    tworz_sasiadow_pom(pom, -1, 1, pula);
+    tworz_sasiadow_pom2(pom, -1, pula);
+    tworz_sasiadow_pom2(pom, 1, pula);
+    tworz_sasiadow_pom(pom, 1, -1, pula);
+    tworz_sasiadow_pom(pom, 1, 0, pula);
+    tworz_sasiadow_pom(pom, 1, 1, pula);
+}
+
+/**
+ * Tworzy wszystkich sąsiadów każdej żywej komórki na planszy 'p'
+ *
+ * 'p' może ulec zmianie
+ */
+static void tworz_sasiadow(Plansza** p, Pula* pula)
+{
+    Plansza* pom = *p;
+    while (pom != NULL) {
+        tworz_sasiadow_wiersz(pom, pula);
+        pom = pom -> nast;
+    }
+    if ((*p) != NULL && (*p) -> poprz != NULL)
+        (*p) = (*p) -> poprz;
+}
+
+/**
+ * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom', takich że:
+ * -znajdują się także w wierszu 'pom' -> kol + w oraz
+ * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ *
+ * n = {-1, 0, 1} oraz w = {-1, 1}
+ */
+static void zlicz_sasiadow_pom(Plansza* pom, int w, int n)
+{
+    assert(n >= -1 && n <= 1);
+    assert(w == -1 || w == 1);
+    int ok = 0;
+    Komorka* pom2 = pom -> k;
+    Komorka* pom3 = NULL;
+    if (w == -1 && pom -> poprz != NULL && pom -> poprz -> wiersz + 1 == pom -> wiersz) {
+        ok = 1;
+        pom3 = pom -> poprz -> k;
+    }
+    else if (w == 1 && pom -> nast != NULL && pom -> nast -> wiersz - 1 == pom -> wiersz) {
+        ok = 1;
+        pom3 = pom -> nast -> k;
+    }
+    if (ok == 1) {
+        while (pom2 != NULL && pom3 != NULL) {
+            if (pom2 -> kol + n == pom3 -> kol) {
+                if (pom3 -> stan == '0')
+                    pom2 -> ile_sasiadow++;
+                pom3 = pom3 -> nast;
+                pom2 = pom2 -> nast;
+            }
+            else if (pom2 -> kol + n < pom3 -> kol){
+                pom2 = pom2 -> nast;
+            }
+            else {
+                pom3 = pom3 -> nast;
+            }
+        }
+    }
+}
+
+/**
+ * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom', takich że:
+ * -znajdują się także w wierszu 'pom' oraz
+ * -numer kolumny sąsiada różni się od numeru komórki o 'n'
+ *
+ * n = -1 lub n = 1
+ */
+static void zlicz_sasiadow_pom2(Plansza* pom, int n)
+{
+    assert(n == -1 || n == 1);
+    Komorka* pom2 = pom -> k;
+    if (n == -1) {
+        while (pom2 != NULL) {
+            if (pom2 -> poprz != NULL && pom2 -> poprz -> kol == pom2 -> kol - 1 &&
+                pom2 -> poprz -> stan == '0')
+                pom2 -> ile_sasiadow++;
+            pom2 = pom2 -> nast;
+        }
+    }
+    else {
+        while (pom2 != NULL) {
+            if (pom2 -> nast != NULL && pom2 -> nast -> kol == pom2 -> kol + 1 &&
+                pom2 -> nast -> stan == '0')
+                pom2 -> ile_sasiadow++;
+            pom2 = pom2 -> nast;
+        }
+    }
+}
+
+/**
+ * Zlicza liczbę sąsiadów każdej komórki w wierszu 'pom'
+ *
+ * Wyniki zapisuje w ile_sasiadow każdej komórki
+ */
+static void zlicz_sasiadow_wiersz(Plansza* pom)
+{
+    zlicz_sasiadow_pom(pom, -1, -1);
+    zlicz_sasiadow_pom(pom, -1, 0);
+    zlicz_sasiadow_pom(pom, -1, 1);
+    zlicz_sasiadow_pom2(pom, -1);
+    zlicz_sasiadow_pom2(pom, 1);
+    zlicz_sasiadow_pom(pom, 1, -1);
+    zlicz_sasiadow_pom(pom, 1, 0);
+    zlicz_sasiadow_pom(pom, 1, 1);
+}
+
+/**
+ * Zlicza liczbę sąsiadów każdej komórki na planszy 'p'
+ *
+ * Wyniki zapisuje w ile_sasiadow każdej komórki
+ *
+ * ile_sasiadow każdej komórki musi być równe 0
+ */
+static void zlicz_sasiadow(Plansza* p)
+{
+    Plansza* pom = p;
+#ifndef NDEBUG
+    while (pom != NULL) {
+        Komorka* pom2 = pom -> k;
+        while (pom2 != NULL) {
+            assert(pom2 -> ile_sasiadow == 0);
+            pom2 = pom2 -> nast;
+        }
+        pom = pom -> nast;
+    }
+    pom = p;
+#endif
+    while (pom != NULL) {
+        zlicz_sasiadow_wiersz(pom);
+        pom = pom -> nast;
+    }
+}
+
+/**
+ * Aktualizuje stan wszystkich komórek planszy 'p' według reguły 'r', zeruje liczbę
+ * sąsiadów, uaktualnia odcisk 'o' haszami komórek, które zmieniły stan (zob. ZmianyOdcisku),
+ * i zapisuje w 'ob' obszar nowej generacji
+ */
+static void aktualizuj_stan_z_odciskiem(Plansza* p, const Regula* r, Odcisk* o, Obszar* ob)
+{
+    ZmianyOdcisku z;
+    zacznij_zmiany(&z);
+    memset(ob, 0, sizeof(Obszar));
+    Plansza* pom = p;
+    while (pom != NULL) {
+        Komorka* pom2 = pom -> k;
+        int n = 0;
+        int pierwsza = 0;
+        int ostatnia = 0;
+        while (pom2 != NULL) {
+            char stan = nowy_stan(r, pom2 -> stan == '0', pom2 -> ile_sasiadow) ? '0' : '.';
+            if (stan != pom2 -> stan)
+                dolicz_zmiane(&z, pom2 -> kol, pom2 -> kol, stan == '0');
+            if (stan == '0') {
+                if (n++ == 0)
+                    pierwsza = pom2 -> kol;
+                ostatnia = pom2 -> kol;
+            }
+            pom2 -> stan = stan;
+            pom2 -> ile_sasiadow = 0;
+            pom2 = pom2 -> nast;
+        }
+        if (n > 0)
+            dolicz_wiersz_do_obszaru(ob, pom -> wiersz, pierwsza, ostatnia, n);
+        zamknij_wiersz_zmian(&z, pom -> wiersz);
+        pom = pom -> nast;
+    }
+    zakoncz_zmiany(o, &z, ob);
+}
+
+/**
+ * Aktualizuje stan wszystkich komórek planszy 'p' według reguły 'r', zeruje
+ * liczbę sąsiadów i zapisuje w 'ob' populację i prostokąt nowej generacji
+ *
+ * Reguła nie może ożywiać komórek bez żywych sąsiadów, bo takich komórek nie ma na planszy.
+ * Gdy 'o' nie jest NULL, uaktualnia też odcisk 'o'.
+ * Obszar liczy się przy okazji przejścia po wszystkich komórkach, więc zapytania
+ * o populację i prostokąt nie muszą przeglądać planszy.
+ */
+static void aktualizuj_stan(Plansza* p, const Regula* r, Odcisk* o, Obszar* ob)
+{
+    assert(!(r -> narodziny & 1));
+    if (o != NULL) {
+        aktualizuj_stan_z_odciskiem(p, r, o, ob);
+        return;
+    }
+    memset(ob, 0, sizeof(Obszar));
+    Plansza* pom = p;
+    while (pom != NULL) {
+        Komorka* pom2 = pom -> k;
+        int n = 0;
+        int pierwsza = 0;
+        int ostatnia = 0;
+        while (pom2 != NULL) {
+            pom2 -> stan = nowy_stan(r, pom2 -> stan == '0', pom2 -> ile_sasiadow) ? '0' : '.';
+            pom2 -> ile_sasiadow = 0;
+            if (pom2 -> stan == '0') {
+                if (n++ == 0)
+                    pierwsza = pom2 -> kol;
+                ostatnia = pom2 -> kol;
+            }
+            pom2 = pom2 -> nast;
+        }
+        if (n > 0)
+            dolicz_wiersz_do_obszaru(ob, pom -> wiersz, pierwsza, ostatnia, n);
+        pom = pom -> nast;
+    }
+}
+
+/**
+ * Usuwa komórki na planszy 'p', gdy:
+ * -są martwe oraz
+ * -wszyscy sąsiedzi danej komórki sa martwi
+ */
+static void usun_martwe_pom(Plansza* p, Pula* pula)
+{
+    Plansza* pom = p;
+    while (pom != NULL) {
+        Komorka* pom2 = pom -> k;
+        while (pom2 != NULL) {
+            if (pom2 -> stan == '.' && pom2 -> ile_sasiadow == 0) {
+                DOLICZ(pula, usuniete_komorki, 1);
+                if (pom2 -> poprz == NULL && pom2 -> nast == NULL) {
+                    pom -> k = NULL;
+                    zwolnij_wezel(pula, pom2);
+                    pom2 = NULL;
+                }
+                else if (pom2 -> poprz == NULL) {
+                    Komorka* pom3 = pom2 -> nast;
+                    pom3 -> poprz = NULL;
+                    zwolnij_wezel(pula, pom2);
+                    pom -> k = pom3;
+                    pom2 = pom3;
+                }
+                else if (pom2 -> nast == NULL) {
+                    pom2 -> poprz -> nast = NULL;
+                    zwolnij_wezel(pula, pom2);
+                    pom2 = NULL;
+                }
+                else {
+                    Komorka* pom3 = pom2 -> poprz;
+                    pom3 -> nast = pom2 -> nast;
+                    pom2 -> nast -> poprz = pom3;
+                    zwolnij_wezel(pula, pom2);
+                    pom2 = pom3 -> nast;
+                }
+            }
+            else {
+                pom2 = pom2 -> nast;
+            }
+        }
+        pom = pom -> nast;
+    }
+}
+
+/**
+ * Usuwa wiersze planszy 'p', w których nie ma komórek
+ *
+ * 'p' może ulec zmianie
+ */
+static void usun_puste_wiersze(Plansza** p, Pula* pula)
+{
+    Plansza* pom = (*p);
+    while (pom != NULL) {
+        if (pom -> k == NULL) {
+            DOLICZ(pula, usuniete_wiersze, 1);
+            if (pom -> poprz == NULL && pom -> nast == NULL) {
+                (*p) = NULL;
+                zwolnij_wezel(pula, pom);
+                pom = NULL;
+            }
+            else if (pom -> poprz == NULL) {
+                Plansza* pom3 = pom -> nast;
+                pom3 -> poprz = NULL;
+                zwolnij_wezel(pula, pom);
+                pom = pom3;
+                *p = pom3;
+            }
+            else if (pom -> nast == NULL) {
+                pom -> poprz -> nast = NULL;
+                zwolnij_wezel(pula, pom);
+                pom = NULL;
+            }
+            else {
+                Plansza* pom3 = pom -> poprz;
+                pom3 -> nast = pom -> nast;
+                pom -> nast -> poprz = pom3;
+                zwolnij_wezel(pula, pom);
+                pom = pom3 -> nast;
+            }
+        }
+        else
+            pom = pom -> nast;
+    }
+}
+
+/**
+ * Usuwa komórki na planszy 'p', gdy:
+ * -są martwe oraz
+ * -wszyscy sąsiedzi danej komórki sa martwi
+ *
+ * Usuwa puste wiersze
+ *
+ * 'p' może ulec zmianie
+ */
+static void usun_martwe(Plansza** p, Pula* pula)
+{
+    usun_martwe_pom(*p, pula);
+    usun_puste_wiersze(p, pula);
+}
+
+/**
+ * Zeruje liczbe sąsiadów każdej komórki na planszy 'p'
+ */
+static void zeruj_sasiadow(Plansza* p)
+{
+    Plansza* pom = p;
+    while (pom != NULL) {
+        Komorka* pom2 = pom -> k;
+        while (pom2 != NULL) {
+            pom2 -> ile_sasiadow = 0;
+            pom2 = pom2 -> nast;
+        }
+        pom = pom -> nast;
+    }
+}
+
+/**
+ * Nazwy faz liczenia generacji, w kolejności numerów FAZA_*
+ */
+static const char* const fazy_listy[] = {"zlicz_sasiadow", "aktualizuj_stan", "usun_martwe",
+                                  "zeruj_sasiadow", "tworz_sasiadow", NULL};
+
+/**
+ * Zwraca czas w sekundach od pewnej ustalonej chwili
+ */
+static double teraz(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double) t.tv_sec + 1e-9 * (double) t.tv_nsec;
+}
+
+/**
+ * Dolicza do czasu fazy 'faza' w 'czasy' czas od chwili '*t' i ustawia '*t' na teraz
+ *
+ * Nic nie robi, gdy 'czasy' jest NULL
+ */
+static void zmierz(double* czasy, int faza, double* t)
+{
+    if (czasy == NULL)
+        return;
+    double u = teraz();
+    czasy[faza] += u - *t;
+    *t = u;
+}
+
+/**
+ * Oblicza następną generacje komórek planszy 'p'
+ *
+ * Zapisuje następną generację na planszy 'p'
+ * Stan komórek zmienia się według reguły 'r'. Gdy 'o' nie jest NULL, jest odciskiem
+ * aktualnej generacji i zostaje uaktualniony do następnej. Obszar następnej generacji
+ * zapisuje w 'ob'.
+ * Gdy 'czasy' nie jest NULL, dolicza do niego czasy faz (zob. FAZA_*)
+ *
+ * 'p' może ulec zmianie
+ */
+static void nastepna_generacja(Plansza** p, Pula* pula, const Regula* r, Odcisk* o, Obszar* ob,
+                        double* czasy)
+{
+    double t = czasy != NULL ? teraz() : 0;
+    zlicz_sasiadow(*p);
+    zmierz(czasy, FAZA_ZLICZ, &t);
+    aktualizuj_stan(*p, r, o, ob);
+    zmierz(czasy, FAZA_AKTUALIZUJ, &t);
+    zlicz_sasiadow(*p);
+    zmierz(czasy, FAZA_ZLICZ, &t);
+    usun_martwe(p, pula);
+    zmierz(czasy, FAZA_USUN, &t);
+    zeruj_sasiadow(*p);
+    zmierz(czasy, FAZA_ZERUJ, &t);
+    tworz_sasiadow(p, pula);
+    zmierz(czasy, FAZA_TWORZ, &t);
+}
+
+/**
+ * Usuwa wszystkie komórki i wiersze planszy, oddając naraz całą pulę 'pula'
+ */
+static void czysc_plansze(Pula* pula)
+{
+#ifdef STATYSTYKI
+    pisz_statystyki_puli(pula, stderr);
+#endif
+    zwolnij_pule(pula);
+}
+
+
+/**
+ * Zwraca tablicę 't' o elementach wielkości 'wielkosc' powiększoną tak,
+ * aby mieściła co najmniej 'n' elementów
+ *
+ * '*rozmiar' to aktualna pojemność tablicy, jest uaktualniana
+ */
+static void* powieksz(void* t, int* rozmiar, int n, size_t wielkosc)
+{
+    if (n <= *rozmiar)
+        return t;
+    int nowy = *rozmiar > 0 ? *rozmiar : 16;
+    while (nowy < n)
+        nowy *= 2;
+    *rozmiar = nowy;
+    return realloc(t, (size_t) nowy * wielkosc);
+}
+
+/**
+ * Funkcja odbierająca kolejne niepuste wiersze planszy
+ *
+ * 'kontekst' - dane odbiorcy
+ * 'wiersz' - numer wiersza
+ * 'kol' - rosnące numery kolumn żywych komórek wiersza
+ * 'n' - liczba żywych komórek wiersza, n > 0
+ */
+typedef void (*OdbiorcaWiersza)(void* kontekst, int wiersz, const int* kol, int n);
+
+/**
+ * Reprezentuje ustawienia planszy podane przy tworzeniu gry
+ *
+ * 'watki' - liczba wątków liczących generację
+ * 'regula' - reguła, według której plansza zaczyna liczyć generacje
+ */
+typedef struct Ustawienia_
+{
+    int watki;
+    Regula regula;
+} Ustawienia;
+
+/**
+ * Reprezentuje silnik liczący generacje na planszy o pewnej reprezentacji
+ *
+ * 'nazwa' - nazwa silnika podawana w opcji -s
+ * 'tworz' - tworzy pustą plansze o ustawieniach 'u'
+ * 'dodaj_wiersz' - dodaje na koniec planszy niepusty wiersz żywych komórek,
+ *                  wiersze przychodzą w kolejności rosnących numerów
+ * 'przygotuj' - wywoływane raz po dodaniu wszystkich wierszy
+ * 'krok' - oblicza 'n' kolejnych generacji
+ * 'przegladaj' - przekazuje odbiorcy 'f' rosnąco wiersze o numerach od 'od' do 'do_'
+ *                włącznie, ograniczone do kolumn od 'kol_od' do 'kol_do' włącznie,
+ *                pomijając wiersze bez żywych komórek w tych kolumnach
+ * 'czysc' - usuwa plansze
+ * 'ustaw_regule' - zmienia regułę liczenia kolejnych generacji na 'r', która nie
+ *                  ożywia komórek bez żywych sąsiadów
+ * 'odcisk' - zapisuje w 'o' odcisk aktualnej generacji, NULL, gdy silnik nie szuka
+ *            cykli, bo i tak liczy wiele generacji naraz
+ * 'przesun' - przesuwa wszystkie komórki o 'dy' wierszy i 'dx' kolumn
+ * 'wielowatkowy' - 1, gdy silnik umie liczyć generację wieloma wątkami
+ * 'fazy' - nazwy faz liczenia generacji zakończone NULL, lub NULL, gdy silnik ich nie mierzy
+ * 'krok_mierzony' - oblicza następną generację, doliczając do 'czasy' czasy kolejnych faz
+ * 'statystyki' - pisze do 'f' liczniki silnika, NULL, gdy silnik ich nie ma
+ * 'zmienione_wiersze' - ustawia 'zmienione'[y - od] na 1 dla wierszy y od 'od' do 'do_',
+ *                       w których ostatni krok mógł zmienić komórki w kolumnach od
+ *                       'kol_od' do 'kol_do', NULL, gdy silnik nie śledzi zmian
+ * 'obszar' - zapisuje w 'o' populację i prostokąt żywych komórek bez przeglądania
+ *            całej planszy, NULL, gdy silnik ich nie śledzi
+ * 'skok' - próbuje obliczyć 'n' generacji naraz, także ponad zakres int, i przesunąć
+ *          plansze do (0, 0) (zob. skok_daleki_hashlife), NULL, gdy silnik tego nie umie
+ */
+typedef struct Silnik_
+{
+    const char* nazwa;
+    void* (*tworz)(const Ustawienia* u);
+    void (*dodaj_wiersz)(void* s, int wiersz, const int* kol, int n);
+    void (*przygotuj)(void* s);
+    void (*krok)(void* s, int n);
+    void (*przegladaj)(void* s, int od, int do_, int kol_od, int kol_do,
+                       OdbiorcaWiersza f, void* kontekst);
+    void (*czysc)(void* s);
+    void (*ustaw_regule)(void* s, const Regula* r);
+    void (*odcisk)(void* s, Odcisk* o);
+    void (*przesun)(void* s, int dy, int dx);
+    int wielowatkowy;
+    const char* const* fazy;
+    void (*krok_mierzony)(void* s, double* czasy);
+    void (*statystyki)(void* s, FILE* f);
+    void (*zmienione_wiersze)(void* s, int od, int do_, int kol_od, int kol_do, char* zmienione);
+    void (*obszar)(void* s, Obszar* o);
+    int (*skok)(void* s, long long n, long long rozpietosc, long long* dy, long long* dx, int zapisz);
+} Silnik;
+
+/**
+ * Reprezentuje kolejkę zadań jednego wątku zespołu
+ *
+ * Właściciel bierze zadania z końca, pozostałe wątki podkradają je z początku.
+ *
+ * 'm' - zamek kolejki
+ * 'zadania' - numery zadań
+ * 'poczatek', 'koniec' - zadania czekające to 'zadania'[poczatek..koniec - 1]
+ * 'rozmiar' - pojemność tablicy 'zadania'
+ */
+typedef struct Kolejka_
+{
+    pthread_mutex_t m;
+    int* zadania;
+    int poczatek;
+    int koniec;
+    int rozmiar;
+} Kolejka;
+
+/**
+ * Reprezentuje zespół wątków z podkradaniem zadań
+ *
+ * Wątek 0 to wątek wywołujący uruchom_zespol, pozostałe czekają na kolejne rundy.
+ *
+ * 'ile' - liczba wątków razem z wątkiem 0
+ * 'watki' - wątki 1..ile - 1
+ * 'kolejki' - kolejki zadań wszystkich wątków
+ * 'm' - zamek pól poniżej
+ * 'start' - sygnalizuje początek rundy albo zakończenie pracy
+ * 'koniec' - sygnalizuje wykonanie wszystkich zadań rundy
+ * 'runda' - numer aktualnej rundy
+ * 'pozostale' - liczba niewykonanych zadań rundy
+ * 'zakoncz' - 1, gdy wątki mają zakończyć pracę
+ * 'zadanie' - funkcja wykonująca zadanie 'nr' w wątku 'watek'
+ * 'kontekst' - dane przekazywane do 'zadanie'
+ */
+typedef struct Zespol_
+{
+    int ile;
+    pthread_t* watki;
+    Kolejka* kolejki;
+    pthread_mutex_t m;
+    pthread_cond_t start;
+    pthread_cond_t koniec;
+    int runda;
+    int pozostale;
+    int zakoncz;
+    void (*zadanie)(void* kontekst, int nr, int watek);
+    void* kontekst;
+} Zespol;
+
+/**
+ * Reprezentuje wątek zespołu przekazywany do pracuj
+ *
+ * 'z' - zespół
+ * 'nr' - numer wątku
+ */
+typedef struct WatekZespolu_
+{
+    Zespol* z;
+    int nr;
+} WatekZespolu;
+
+/**
+ * Zwraca w '*nr' zadanie z kolejki wątku 'watek', a gdy jest pusta - podkradzione
+ * z kolejki innego wątku
+ *
+ * Zwraca 0, gdy wszystkie kolejki są puste
+ */
+static int wez_zadanie(Zespol* z, int watek, int* nr)
+{
+    Kolejka* q = &z -> kolejki[watek];
+    pthread_mutex_lock(&q -> m);
+    int jest = q -> poczatek < q -> koniec;
+    if (jest)
+        *nr = q -> zadania[--q -> koniec];
+    pthread_mutex_unlock(&q -> m);
+    for (int i = 1; i < z -> ile && !jest; i++) {
+        q = &z -> kolejki[(watek + i) % z -> ile];
+        pthread_mutex_lock(&q -> m);
+        jest = q -> poczatek < q -> koniec;
+        if (jest)
+            *nr = q -> zadania[q -> poczatek++];
+        pthread_mutex_unlock(&q -> m);
+    }
+    return jest;
+}
+
+/**
+ * Wykonuje w wątku 'watek' zadania zespołu 'z', dopóki jakieś zostały
+ */
+static void wykonuj_zadania(Zespol* z, int watek)
+{
+    int nr;
+    while (wez_zadanie(z, watek, &nr)) {
+        z -> zadanie(z -> kontekst, nr, watek);
+        pthread_mutex_lock(&z -> m);
+        if (--z -> pozostale == 0)
+            pthread_cond_signal(&z -> koniec);
+        pthread_mutex_unlock(&z -> m);
+    }
+}
+
+/**
+ * Pętla wątku zespołu: czeka na rundę i wykonuje jej zadania
+ */
+static void* pracuj(void* x)
+{
+    WatekZespolu* wz = (WatekZespolu*) x;
+    Zespol* z = wz -> z;
+    int runda = 0;
+    while (1) {
+        pthread_mutex_lock(&z -> m);
+        while (z -> runda == runda && !z -> zakoncz)
+            pthread_cond_wait(&z -> start, &z -> m);
+        runda = z -> runda;
+        int zakoncz = z -> zakoncz;
+        pthread_mutex_unlock(&z -> m);
+        if (zakoncz)
+            break;
+        wykonuj_zadania(z, wz -> nr);
+    }
+    free(wz);
+    return NULL;
+}
+
+/**
+ * Tworzy zespół 'ile' wątków, wliczając wątek wywołujący
+ */
+static Zespol* tworz_zespol(int ile)
+{
+    Zespol* z = (Zespol*) calloc (1, sizeof(Zespol));
+    z -> ile = ile;
+    z -> kolejki = (Kolejka*) calloc ((size_t) ile, sizeof(Kolejka));
+    for (int i = 0; i < ile; i++)
+        pthread_mutex_init(&z -> kolejki[i].m, NULL);
+    pthread_mutex_init(&z -> m, NULL);
+    pthread_cond_init(&z -> start, NULL);
+    pthread_cond_init(&z -> koniec, NULL);
+    z -> watki = (pthread_t*) malloc ((size_t) ile * sizeof(pthread_t));
+    for (int i = 1; i < ile; i++) {
+        WatekZespolu* wz = (WatekZespolu*) malloc (sizeof(WatekZespolu));
+        wz -> z = z;
+        wz -> nr = i;
+        pthread_create(&z -> watki[i], NULL, pracuj, wz);
+    }
+    return z;
+}
+
+/**
+ * Wykonuje zespołem 'z' zadania 0..'ile_zadan' - 1 funkcją 'zadanie' i czeka na ich koniec
+ *
+ * Zadania są dzielone między kolejki wątków w spójnych kawałkach
+ */
+static void uruchom_zespol(Zespol* z, int ile_zadan, void (*zadanie)(void*, int, int), void* kontekst)
+{
+    pthread_mutex_lock(&z -> m);
+    z -> zadanie = zadanie;
+    z -> kontekst = kontekst;
+    z -> pozostale = ile_zadan;
+    pthread_mutex_unlock(&z -> m);
+    for (int i = 0; i < z -> ile; i++) {
+        Kolejka* q = &z -> kolejki[i];
+        int od = (int) ((long long) ile_zadan * i / z -> ile);
+        int do_ = (int) ((long long) ile_zadan * (i + 1) / z -> ile);
+        pthread_mutex_lock(&q -> m);
+        q -> zadania = (int*) powieksz(q -> zadania, &q -> rozmiar, do_ - od, sizeof(int));
+        q -> poczatek = 0;
+        q -> koniec = 0;
+        for (int j = do_ - 1; j >= od; j--)
+            q -> zadania[q -> koniec++] = j;
+        pthread_mutex_unlock(&q -> m);
+    }
+    pthread_mutex_lock(&z -> m);
+    z -> runda++;
+    pthread_cond_broadcast(&z -> start);
+    pthread_mutex_unlock(&z -> m);
+    wykonuj_zadania(z, 0);
+    pthread_mutex_lock(&z -> m);
+    while (z -> pozostale > 0)
+        pthread_cond_wait(&z -> koniec, &z -> m);
+    pthread_mutex_unlock(&z -> m);
+}
+
+/**
+ * Kończy wątki zespołu 'z' i usuwa go
+ */
+static void czysc_zespol(Zespol* z)
+{
+    pthread_mutex_lock(&z -> m);
+    z -> zakoncz = 1;
+    pthread_cond_broadcast(&z -> start);
+    pthread_mutex_unlock(&z -> m);
+    for (int i = 1; i < z -> ile; i++)
+        pthread_join(z -> watki[i], NULL);
+    for (int i = 0; i < z -> ile; i++) {
+        pthread_mutex_destroy(&z -> kolejki[i].m);
+        free(z -> kolejki[i].zadania);
+    }
+    pthread_mutex_destroy(&z -> m);
+    pthread_cond_destroy(&z -> start);
+    pthread_cond_destroy(&z -> koniec);
+    free(z -> kolejki);
+    free(z -> watki);
+    free(z);
+}
+
+/**
+ * Liczba pasów wierszy na jeden wątek przy liczeniu generacji zespołem,
+ * nadmiar pozwala wyrównać nierówne pasy podkradaniem
+ */
+#ifndef PASY_NA_WATEK
+#define PASY_NA_WATEK 4
+#endif
+
+/**
+ * Reprezentuje plansze listową wraz z pulą jej węzłów
+ *
+ * 'p' - pierwszy wiersz planszy
+ * 'ostatni' - ostatni wiersz, używany przy wczytywaniu
+ * 'pula' - pula węzłów planszy, używana też przez wątek 0 zespołu
+ * 'bufor' - kolumny żywych komórek wiersza przekazywanego odbiorcy
+ * 'rozmiar_bufora' - pojemność bufora
+ * 'zespol' - zespół wątków liczących generację lub NULL dla jednego wątku
+ * 'pule' - pule węzłów wątków 1..ile - 1 zespołu
+ * 'wiersze' - indeks wierszy: wiersze planszy w kolejności numerów, używane przy
+ *             wyszukiwaniu wierszy i podziale na pasy
+ * 'rozmiar_wierszy' - pojemność tablicy 'wiersze'
+ * 'ile_wierszy' - liczba wierszy w indeksie lub -1, gdy plansza zmieniła się od jego budowy
+ * 'regula' - reguła liczenia generacji
+ * 'odcisk' - odcisk aktualnej generacji, uaktualniany w krokach
+ * 'odcisk_znany' - 1, gdy 'odcisk' jest aktualny
+ * 'obszar' - obszar aktualnej generacji, liczony w krokach silników "lista" i "przebieg"
+ * 'obszar_znany' - 1, gdy 'obszar' jest aktualny
+ */
+typedef struct PlanszaListowa_
+{
+    Plansza* p;
+    Plansza* ostatni;
+    Pula pula;
+    int* bufor;
+    int rozmiar_bufora;
+    Zespol* zespol;
+    Pula* pule;
+    Plansza** wiersze;
+    int rozmiar_wierszy;
+    int ile_wierszy;
+    Regula regula;
+    Odcisk odcisk;
+    int odcisk_znany;
+    Obszar obszar;
+    int obszar_znany;
+} PlanszaListowa;
+
+/**
+ * Tworzy pustą plansze listową o ustawieniach 'u'
+ *
+ * Dla więcej niż jednego wątku tworzy zespół i pule węzłów jego wątków
+ */
+static void* tworz_liste(const Ustawienia* u)
+{
+    PlanszaListowa* l = (PlanszaListowa*) malloc (sizeof(PlanszaListowa));
+    l -> p = NULL;
+    l -> ostatni = NULL;
+    inicjuj_pule(&l -> pula);
+    l -> bufor = NULL;
+    l -> rozmiar_bufora = 0;
+    l -> zespol = NULL;
+    l -> pule = NULL;
+    l -> wiersze = NULL;
+    l -> rozmiar_wierszy = 0;
+    l -> ile_wierszy = -1;
+    l -> regula = u -> regula;
+    l -> odcisk_znany = 0;
+    l -> obszar_znany = 0;
+    if (u -> watki > 1) {
+        l -> zespol = tworz_zespol(u -> watki);
+        l -> pule = (Pula*) malloc ((size_t) (u -> watki - 1) * sizeof(Pula));
+        for (int i = 0; i < u -> watki - 1; i++)
+            inicjuj_pule(&l -> pule[i]);
+    }
+    return l;
+}
+
+/**
+ * Dodaje na koniec planszy listowej 's' wiersz 'wiersz' z 'n' żywymi komórkami
+ * w kolumnach 'kol'
+ */
+static void dodaj_wiersz_listy(void* s, int wiersz, const int* kol, int n)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    assert(n > 0);
+    Plansza* pom;
+    if (l -> ostatni == NULL) {
+        pom = (Plansza*) przydziel_wezel(&l -> pula);
+        pom -> poprz = NULL;
+        pom -> nast = NULL;
+        l -> p = pom;
+    }
+    else
+        pom = dodaj_wiersz(l -> ostatni, &l -> pula);
+    l -> ostatni = pom;
+    pom -> wiersz = wiersz;
+    Komorka* pom2 = (Komorka*) przydziel_wezel(&l -> pula);
+    pom2 -> poprz = NULL;
+    pom2 -> nast = NULL;
+    pom -> k = pom2;
+    for (int i = 0; i < n; i++) {
+        if (i > 0)
+            pom2 = dodaj_komorke(pom2, &l -> pula);
+        pom2 -> stan = '0';
+        pom2 -> ile_sasiadow = 0;
+        pom2 -> kol = kol[i];
+    }
+    l -> ile_wierszy = -1;
+    l -> odcisk_znany = 0;
+    l -> obszar_znany = 0;
+}
+
+/**
+ * Tworzy sąsiadów żywych komórek wczytanej planszy listowej 's'
+ */
+static void przygotuj_liste(void* s)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    tworz_sasiadow(&l -> p, &l -> pula);
+    l -> ile_wierszy = -1;
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy listowej 's'
+ */
+static void krok_listy(void* s, int n)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    Odcisk* o = l -> odcisk_znany ? &l -> odcisk : NULL;
+    for (int i = 0; i < n; i++) {
+        nastepna_generacja(&l -> p, &l -> pula, &l -> regula, o, &l -> obszar,
+                           CZASY_FAZ(&l -> pula));
+        DOLICZ(&l -> pula, generacje, 1);
+    }
+    l -> ile_wierszy = -1;
+    l -> obszar_znany = 1;
+}
+
+/**
+ * Oblicza następną generację planszy listowej 's', doliczając do 'czasy' czasy faz
+ */
+static void krok_listy_mierzony(void* s, double* czasy)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    Odcisk* o = l -> odcisk_znany ? &l -> odcisk : NULL;
+    nastepna_generacja(&l -> p, &l -> pula, &l -> regula, o, &l -> obszar, czasy);
+    l -> ile_wierszy = -1;
+    l -> obszar_znany = 1;
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy listowej 's' na 'r'
+ */
+static void ustaw_regule_listy(void* s, const Regula* r)
+{
+    ((PlanszaListowa*) s) -> regula = *r;
+}
+
+/**
+ * Zwraca liczbę wierszy planszy listowej 'l', budując jej indeks wierszy,
+ * gdy plansza zmieniła się od ostatniej budowy
+ *
+ * Indeks buduje się co najwyżej raz na generację i tylko wtedy, gdy ktoś go potrzebuje.
+ * Przesunięcie planszy nie zmienia kolejności wierszy, więc nie unieważnia indeksu.
+ */
+static int indeksuj_wiersze(PlanszaListowa* l)
+{
+    if (l -> ile_wierszy < 0) {
+        int n = 0;
+        for (Plansza* pom = l -> p; pom != NULL; pom = pom -> nast) {
+            l -> wiersze = (Plansza**) powieksz(l -> wiersze, &l -> rozmiar_wierszy, n + 1, sizeof(Plansza*));
+            l -> wiersze[n++] = pom;
+        }
+        l -> ile_wierszy = n;
+    }
+    return l -> ile_wierszy;
+}
+
+/**
+ * Zwraca pierwszy wiersz planszy listowej 'l' o numerze nie mniejszym niż 'wiersz'
+ * lub NULL, gdy takiego nie ma, szukając binarnie w indeksie wierszy
+ */
+static Plansza* szukaj_wiersza_listy(PlanszaListowa* l, int wiersz)
+{
+    int lewy = 0;
+    int prawy = indeksuj_wiersze(l);
+    while (lewy < prawy) {
+        int srodek = lewy + (prawy - lewy) / 2;
+        if (l -> wiersze[srodek] -> wiersz < wiersz)
+            lewy = srodek + 1;
+        else
+            prawy = srodek;
+    }
+    return lewy < l -> ile_wierszy ? l -> wiersze[lewy] : NULL;
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy listowej 's'
+ * o numerach od 'od' do 'do_'
+ *
+ * Przeglądanie od wiersza innego niż pierwszy zaczyna się od wyszukania go w indeksie wierszy.
+ */
+static void przegladaj_liste(void* s, int od, int do_, int kol_od, int kol_do,
+                      OdbiorcaWiersza f, void* kontekst)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    Plansza* pom = l -> p;
+    if (pom != NULL && pom -> wiersz < od)
+        pom = szukaj_wiersza_listy(l, od);
+    while (pom != NULL && pom -> wiersz <= do_) {
+        if (pom -> wiersz >= od) {
+            int n = 0;
+            for (Komorka* pom2 = pom -> k; pom2 != NULL && pom2 -> kol <= kol_do; pom2 = pom2 -> nast) {
+                if (pom2 -> stan == '0' && pom2 -> kol >= kol_od) {
+                    l -> bufor = (int*) powieksz(l -> bufor, &l -> rozmiar_bufora, n + 1, sizeof(int));
+                    l -> bufor[n++] = pom2 -> kol;
+                }
+            }
+            if (n > 0)
+                f(kontekst, pom -> wiersz, l -> bufor, n);
+        }
+        pom = pom -> nast;
+    }
+}
+
+/**
+ * Zapisuje w 'o' odcisk aktualnej generacji planszy listowej 's'
+ *
+ * Za pierwszym razem liczy odcisk, przeglądając plansze, a potem kroki silników "lista"
+ * i "przebieg" tylko go uaktualniają
+ */
+static void odcisk_listy(void* s, Odcisk* o)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    if (!l -> odcisk_znany) {
+        memset(&l -> odcisk, 0, sizeof(Odcisk));
+        przegladaj_liste(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_do_odcisku, &l -> odcisk);
+        l -> odcisk_znany = 1;
+    }
+    *o = l -> odcisk;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek aktualnej generacji planszy
+ * listowej 's'
+ *
+ * Silniki "lista" i "przebieg" liczą obszar w każdym kroku (zob. aktualizuj_stan
+ * i licz_wiersz_listy), więc plansze przegląda się tylko zaraz po wczytaniu
+ */
+static void obszar_listy(void* s, Obszar* o)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    if (!l -> obszar_znany) {
+        memset(&l -> obszar, 0, sizeof(Obszar));
+        przegladaj_liste(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_obszar, &l -> obszar);
+        l -> obszar_znany = 1;
+    }
+    *o = l -> obszar;
+}
+
+/**
+ * Przesuwa wszystkie komórki planszy listowej 's' o 'dy' wierszy i 'dx' kolumn
+ */
+static void przesun_liste(void* s, int dy, int dx)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    for (Plansza* pom = l -> p; pom != NULL; pom = pom -> nast) {
+        pom -> wiersz += dy;
+        for (Komorka* pom2 = pom -> k; pom2 != NULL; pom2 = pom2 -> nast)
+            pom2 -> kol += dx;
+    }
+    przesun_odcisk(&l -> odcisk, dy, dx);
+    przesun_obszar(&l -> obszar, dy, dx);
+}
+
+/**
+ * Nie robi nic, dla plansz które nie potrzebują przygotowania po wczytaniu
+ */
+static void bez_przygotowania(void* s)
+{
+    (void) s;
+}
+
+/**
+ * Oddaje do puli 'pula' wiersz 'pom' wraz z jego komórkami
+ */
+static void zwolnij_wiersz(Plansza* pom, Pula* pula)
+{
+    Komorka* pom2 = pom -> k;
+    while (pom2 != NULL) {
+        Komorka* pom3 = pom2 -> nast;
+        zwolnij_wezel(pula, pom2);
+        DOLICZ(pula, usuniete_komorki, 1);
+        pom2 = pom3;
+    }
+    zwolnij_wezel(pula, pom);
+    DOLICZ(pula, usuniete_wiersze, 1);
+}
+
+/**
+ * Zwraca wiersz 'wiersz' następnej generacji z samymi żywymi komórkami
+ * lub NULL, gdy nie ma w nim żywych komórek
+ *
+ * 'a', 'b', 'c' to pierwsze komórki wierszy 'wiersz' - 1, 'wiersz' i 'wiersz' + 1
+ * aktualnej generacji (NULL dla wiersza pustego). Wiersze zawierają tylko żywe komórki.
+ * Kandydatów na komórki następnej generacji tworzy się w locie podczas scalania
+ * trzech wierszy, a martwych nie zapisuje się wcale. Stan komórek zmienia się według
+ * reguły 'r', która nie może ożywiać komórek bez żywych sąsiadów. Niepusty wiersz
+ * dolicza się do obszaru 'ob', a komórki, które zmieniły stan, do otwartego wiersza
+ * zmian 'z', o ile nie jest NULL.
+ */
+static Plansza* licz_wiersz_listy(Komorka* a, Komorka* b, Komorka* c, int wiersz,
+                           const Regula* r, Pula* pula, Obszar* ob, ZmianyOdcisku* z)
+{
+    Plansza* wynik = NULL;
+    Komorka* ostatnia = NULL;
+    int ile = 0;
+    int m = INT_MAX;
+    if (a != NULL && a -> kol < m)
+        m = a -> kol;
+    if (b != NULL && b -> kol < m)
+        m = b -> kol;
+    if (c != NULL && c -> kol < m)
+        m = c -> kol;
+    if (m == INT_MAX)
+        return NULL;
+    int x = m - 1;
+    while (1) {
+        while (a != NULL && a -> kol < x - 1)
+            a = a -> nast;
+        while (b != NULL && b -> kol < x - 1)
+            b = b -> nast;
+        while (c != NULL && c -> kol < x - 1)
+            c = c -> nast;
+        int sasiedzi = 0;
+        int zywa = 0;
+        for (Komorka* pom = a; pom != NULL && pom -> kol <= x + 1; pom = pom -> nast)
+            sasiedzi++;
+        for (Komorka* pom = c; pom != NULL && pom -> kol <= x + 1; pom = pom -> nast)
+            sasiedzi++;
+        for (Komorka* pom = b; pom != NULL && pom -> kol <= x + 1; pom = pom -> nast) {
+            if (pom -> kol == x)
+                zywa = 1;
+            else
+                sasiedzi++;
+        }
+        int nowa = nowy_stan(r, zywa, sasiedzi);
+        if (z != NULL && nowa != zywa)
+            dolicz_zmiane(z, x, x, nowa);
+        if (nowa) {
+            Komorka* k2 = (Komorka*) przydziel_wezel(pula);
+            DOLICZ(pula, nowe_komorki, 1);
+            k2 -> stan = '0';
+            k2 -> ile_sasiadow = 0;
+            k2 -> kol = x;
+            k2 -> poprz = ostatnia;
+            k2 -> nast = NULL;
+            if (ostatnia == NULL) {
+                wynik = (Plansza*) przydziel_wezel(pula);
+                DOLICZ(pula, nowe_wiersze, 1);
+                wynik -> wiersz = wiersz;
+                wynik -> k = k2;
+            }
+            else
+                ostatnia -> nast = k2;
+            ostatnia = k2;
+            ile++;
+        }
+        m = INT_MAX;
+        Komorka* pom = a;
+        while (pom != NULL && pom -> kol < x)
+            pom = pom -> nast;
+        if (pom != NULL && pom -> kol < m)
+            m = pom -> kol;
+        pom = b;
+        while (pom != NULL && pom -> kol < x)
+            pom = pom -> nast;
+        if (pom != NULL && pom -> kol < m)
+            m = pom -> kol;
+        pom = c;
+        while (pom != NULL && pom -> kol < x)
+            pom = pom -> nast;
+        if (pom != NULL && pom -> kol < m)
+            m = pom -> kol;
+        if (m == INT_MAX)
+            break;
+        x = m - 1 > x + 1 ? m - 1 : x + 1;
+    }
+    if (wynik != NULL)
+        dolicz_wiersz_do_obszaru(ob, wiersz, wynik -> k -> kol, ostatnia -> kol, ile);
+    return wynik;
+}
+
+/**
+ * Dopisuje na koniec listy wierszy od '*pierwszy' do '*ostatni' wiersze następnej
+ * generacji o numerach od 'y' do 'y_do' - 1, doliczając je do obszaru 'ob' i, o ile
+ * 'z' nie jest NULL, do zmian 'z'
+ *
+ * 'i' to pierwszy wiersz aktualnej generacji o numerze co najmniej 'y' - 1.
+ * Okno trzech kolejnych wierszy aktualnej generacji przesuwa się w dół planszy.
+ * Gdy 'zwalniaj' jest niezerowe, wiersze, które opuściły okno, są od razu oddawane
+ * do puli 'pula' i używane ponownie dla wierszy następnej generacji.
+ * Stan komórek zmienia się według reguły 'r'.
+ */
+static void licz_pas(Plansza* i, int y, int y_do, const Regula* r, Pula* pula, int zwalniaj,
+              Plansza** pierwszy, Plansza** ostatni, Obszar* ob, ZmianyOdcisku* z)
+{
+    if (i != NULL && i -> wiersz - 1 > y)
+        y = i -> wiersz - 1;
+    while (i != NULL && y < y_do) {
+        Komorka* kol[3] = {NULL, NULL, NULL};
+        Plansza* j = i;
+        for (int d = 0; d < 3; d++) {
+            if (j != NULL && j -> wiersz == y - 1 + d) {
+                kol[d] = j -> k;
+                j = j -> nast;
+            }
+        }
+        Plansza* pom = licz_wiersz_listy(kol[0], kol[1], kol[2], y, r, pula, ob, z);
+        if (z != NULL)
+            zamknij_wiersz_zmian(z, y);
+        if (pom != NULL) {
+            pom -> poprz = *ostatni;
+            pom -> nast = NULL;
+            if (*ostatni == NULL)
+                *pierwszy = pom;
+            else
+                (*ostatni) -> nast = pom;
+            *ostatni = pom;
+        }
+        y++;
+        while (i != NULL && i -> wiersz < y - 1) {
+            Plansza* pom2 = i -> nast;
+            if (zwalniaj)
+                zwolnij_wiersz(i, pula);
+            i = pom2;
+        }
+        if (i != NULL && i -> wiersz - 1 > y)
+            y = i -> wiersz - 1;
+    }
+}
+
+/**
+ * Reprezentuje podział generacji planszy listowej na pasy liczone przez zespół
+ *
+ * Pas 'b' czyta wiersze aktualnej generacji, a zapisuje wiersze następnej generacji
+ * od numeru pierwszego swojego wiersza minus 1 do numeru pierwszego wiersza
+ * następnego pasa minus 2, więc pasy wynikowe są rozłączne i wystarczy je połączyć.
+ *
+ * 'l' - plansza
+ * 'ile_wierszy' - liczba wierszy aktualnej generacji w 'l' -> wiersze
+ * 'ile_pasow' - liczba pasów
+ * 'granice' - pas 'b' to wiersze o indeksach od 'granice'[b] do 'granice'[b + 1] - 1
+ * 'pierwsze', 'ostatnie' - wynikowe wiersze każdego pasu
+ * 'obszary' - obszary wynikowych wierszy każdego pasu
+ * 'zmiany' - zmiany odcisku każdego pasu lub NULL, gdy odcisk nie jest śledzony
+ */
+typedef struct Pasy_
+{
+    PlanszaListowa* l;
+    int ile_wierszy;
+    int ile_pasow;
+    int* granice;
+    Plansza** pierwsze;
+    Plansza** ostatnie;
+    Obszar* obszary;
+    ZmianyOdcisku* zmiany;
+} Pasy;
+
+/**
+ * Zwraca pulę węzłów wątku 'watek' zespołu planszy 'l'
+ */
+static Pula* pula_watku(PlanszaListowa* l, int watek)
+{
+    return watek == 0 ? &l -> pula : &l -> pule[watek - 1];
+}
+
+/**
+ * Liczy wiersze następnej generacji pasa 'nr' podziału 'x' w wątku 'watek'
+ */
+static void licz_pas_zadanie(void* x, int nr, int watek)
+{
+    Pasy* p = (Pasy*) x;
+    Plansza** w = p -> l -> wiersze;
+    int i = p -> granice[nr];
+    int y = w[i] -> wiersz - 1;
+    int y_do = nr + 1 < p -> ile_pasow ? w[p -> granice[nr + 1]] -> wiersz - 1 : INT_MAX;
+    while (i > 0 && w[i - 1] -> wiersz >= y - 1)
+        i--;
+    p -> pierwsze[nr] = NULL;
+    p -> ostatnie[nr] = NULL;
+    memset(&p -> obszary[nr], 0, sizeof(Obszar));
+    ZmianyOdcisku* z = NULL;
+    if (p -> zmiany != NULL) {
+        z = &p -> zmiany[nr];
+        zacznij_zmiany(z);
+    }
+    licz_pas(w[i], y, y_do, &p -> l -> regula, pula_watku(p -> l, watek), 0,
+             &p -> pierwsze[nr], &p -> ostatnie[nr], &p -> obszary[nr], z);
+}
+
+/**
+ * Oddaje do puli wątku 'watek' wiersze aktualnej generacji pasa 'nr' podziału 'x'
+ */
+static void zwolnij_pas_zadanie(void* x, int nr, int watek)
+{
+    Pasy* p = (Pasy*) x;
+    for (int i = p -> granice[nr]; i < p -> granice[nr + 1]; i++)
+        zwolnij_wiersz(p -> l -> wiersze[i], pula_watku(p -> l, watek));
+}
+
+/**
+ * Oblicza następną generację planszy listowej 'l' zespołem wątków
+ *
+ * Wiersze dzieli się na pasy. Najpierw wątki liczą pasy następnej generacji,
+ * czytając wspólną aktualną generację, potem pasy łączy się w kolejności,
+ * a na końcu wątki oddają wiersze aktualnej generacji do swoich pul. Obszary i zmiany
+ * odcisku pasów łączy się razem z pasami. Wynik nie zależy od liczby wątków ani
+ * od kolejności wykonania zadań.
+ */
+static void nastepna_generacja_zespolem(PlanszaListowa* l)
+{
+    int n = indeksuj_wiersze(l);
+    Pasy p;
+    p.l = l;
+    p.ile_wierszy = n;
+    p.ile_pasow = l -> zespol -> ile * PASY_NA_WATEK < n ? l -> zespol -> ile * PASY_NA_WATEK : n;
+    p.granice = (int*) malloc ((size_t) (p.ile_pasow + 1) * sizeof(int));
+    p.pierwsze = (Plansza**) malloc ((size_t) p.ile_pasow * sizeof(Plansza*));
+    p.ostatnie = (Plansza**) malloc ((size_t) p.ile_pasow * sizeof(Plansza*));
+    p.obszary = (Obszar*) malloc ((size_t) p.ile_pasow * sizeof(Obszar));
+    p.zmiany = NULL;
+    if (l -> odcisk_znany)
+        p.zmiany = (ZmianyOdcisku*) malloc ((size_t) p.ile_pasow * sizeof(ZmianyOdcisku));
+    for (int b = 0; b <= p.ile_pasow; b++)
+        p.granice[b] = (int) ((long long) n * b / p.ile_pasow);
+    uruchom_zespol(l -> zespol, p.ile_pasow, licz_pas_zadanie, &p);
+    Plansza* nowa = NULL;
+    Plansza* ostatni = NULL;
+    ZmianyOdcisku z;
+    zacznij_zmiany(&z);
+    memset(&l -> obszar, 0, sizeof(Obszar));
+    for (int b = 0; b < p.ile_pasow; b++) {
+        if (p.zmiany != NULL)
+            z.hasz = (z.hasz + p.zmiany[b].hasz) % MODUL_HASZU;
+        if (p.pierwsze[b] == NULL)
+            continue;
+        dolicz_obszar_pasa(&l -> obszar, &p.obszary[b]);
+        p.pierwsze[b] -> poprz = ostatni;
+        if (ostatni == NULL)
+            nowa = p.pierwsze[b];
+        else
+            ostatni -> nast = p.pierwsze[b];
+        ostatni = p.ostatnie[b];
+    }
+    uruchom_zespol(l -> zespol, p.ile_pasow, zwolnij_pas_zadanie, &p);
+    l -> p = nowa;
+    l -> ile_wierszy = -1;
+    l -> obszar_znany = 1;
+    if (l -> odcisk_znany)
+        zakoncz_zmiany(&l -> odcisk, &z, &l -> obszar);
+    free(p.granice);
+    free(p.pierwsze);
+    free(p.ostatnie);
+    free(p.obszary);
+    free(p.zmiany);
+}
+
+/**
+ * Oblicza następną generację planszy listowej 'l' jednym przejściem
+ *
+ * Plansza zawiera tylko żywe komórki. Gdy plansza ma zespół wątków,
+ * generację liczy zespół, inaczej robi to jeden pas obejmujący całą plansze.
+ */
+static void nastepna_generacja_przebiegiem(PlanszaListowa* l)
+{
+    if (l -> zespol != NULL && l -> p != NULL) {
+        nastepna_generacja_zespolem(l);
+        return;
+    }
+    Plansza* nowa = NULL;
+    Plansza* ostatni = NULL;
+    int y = l -> p != NULL ? l -> p -> wiersz - 1 : 0;
+    ZmianyOdcisku z;
+    zacznij_zmiany(&z);
+    memset(&l -> obszar, 0, sizeof(Obszar));
+    licz_pas(l -> p, y, INT_MAX, &l -> regula, &l -> pula, 1, &nowa, &ostatni, &l -> obszar,
+             l -> odcisk_znany ? &z : NULL);
+    l -> p = nowa;
+    l -> ile_wierszy = -1;
+    l -> obszar_znany = 1;
+    if (l -> odcisk_znany)
+        zakoncz_zmiany(&l -> odcisk, &z, &l -> obszar);
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy listowej 's' liczonej jednym przejściem
+ */
+static void krok_przebiegu(void* s, int n)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    for (int i = 0; i < n; i++) {
+        nastepna_generacja_przebiegiem(l);
+        DOLICZ(&l -> pula, generacje, 1);
+    }
+}
+
+#ifdef STATYSTYKI
+/**
+ * Pisze do 'f' liczniki liczenia generacji planszy listowej 'l',
+ * zsumowane po pulach wszystkich wątków
+ */
+void pisz_liczniki_listy(PlanszaListowa* l, FILE* f)
+{
+    Liczniki suma = l -> pula.liczniki;
+    int ile_pul = l -> zespol != NULL ? l -> zespol -> ile - 1 : 0;
+    for (int i = 0; i < ile_pul; i++) {
+        suma.nowe_komorki += l -> pule[i].liczniki.nowe_komorki;
+        suma.nowe_wiersze += l -> pule[i].liczniki.nowe_wiersze;
+        suma.usuniete_komorki += l -> pule[i].liczniki.usuniete_komorki;
+        suma.usuniete_wiersze += l -> pule[i].liczniki.usuniete_wiersze;
+    }
+    fprintf(f, "generacje %lld, nowe komorki %lld, nowe wiersze %lld, "
+            "usuniete komorki %lld, usuniete wiersze %lld\n", suma.generacje, suma.nowe_komorki,
+            suma.nowe_wiersze, suma.usuniete_komorki, suma.usuniete_wiersze);
+    double razem = 0;
+    for (int i = 0; i < ILE_FAZ; i++)
+        razem += suma.czasy[i];
+    if (razem > 0) {
+        fprintf(f, "czasy faz [s]:");
+        for (int i = 0; i < ILE_FAZ; i++)
+            fprintf(f, " %s %.6f", fazy_listy[i], suma.czasy[i]);
+        fprintf(f, "\n");
+    }
+}
+#endif
+
+/**
+ * Pisze do 'f' liczniki puli planszy listowej 's' oraz, z flagą STATYSTYKI,
+ * liczniki liczenia generacji
+ */
+static void pisz_statystyki_listy(void* s, FILE* f)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+    pisz_statystyki_puli(&l -> pula, f);
+#ifdef STATYSTYKI
+    pisz_liczniki_listy(l, f);
+#endif
+}
+
+/**
+ * Usuwa plansze listową 's'
+ */
+static void czysc_liste(void* s)
+{
+    PlanszaListowa* l = (PlanszaListowa*) s;
+#ifdef STATYSTYKI
+    pisz_liczniki_listy(l, stderr);
+#endif
+    if (l -> zespol != NULL) {
+        for (int i = 0; i < l -> zespol -> ile - 1; i++)
+            czysc_plansze(&l -> pule[i]);
+        czysc_zespol(l -> zespol);
+        free(l -> pule);
+    }
+    czysc_plansze(&l -> pula);
+    free(l -> bufor);
+    free(l -> wiersze);
+    free(l);
+}
+
+/**
+ * Reprezentuje wiersz planszy tablicowej
+ *
+ * 'wiersz' - numer wiersza
+ * 'od' - indeks pierwszej kolumny wiersza w tablicy kolumn planszy
+ * 'ile' - liczba żywych komórek wiersza
+ */
+typedef struct WierszTablicy_
+{
+    int wiersz;
+    int od;
+    int ile;
+} WierszTablicy;
+
+/**
+ * Reprezentuje jedną generację planszy tablicowej
+ *
+ * Przechowuje tylko żywe komórki, po 4 bajty na komórkę.
+ *
+ * 'w' - tablica niepustych wierszy w kolejności rosnących numerów
+ * 'ile_w' - liczba wierszy
+ * 'rozmiar_w' - pojemność tablicy 'w'
+ * 'kol' - kolumny żywych komórek kolejnych wierszy, rosnąco w obrębie wiersza
+ * 'ile_kol' - liczba żywych komórek
+ * 'rozmiar_kol' - pojemność tablicy 'kol'
+ */
+typedef struct Tablice_
+{
+    WierszTablicy* w;
+    int ile_w;
+    int rozmiar_w;
+    int* kol;
+    int ile_kol;
+    int rozmiar_kol;
+} Tablice;
+
+/**
+ * Reprezentuje plansze tablicową
+ *
+ * Pola od 'poprz' używa tylko silnik "aktywne". Przedziały kolumn przechowuje się
+ * w Tablice jako kolejne pary liczb [a, b] w 'kol', a 'ile' wiersza to liczba liczb.
+ *
+ * 'akt' - aktualna generacja
+ * 'nast' - miejsce na następną generację, zamieniane z 'akt' po każdym kroku
+ * 'poprz' - poprzednia generacja
+ * 'zmiany' - przedziały kolumn, poza którymi 'akt' nie różni się od 'poprz'
+ * 'zmiany2' - przedziały kolumn, poza którymi 'akt' nie różni się od generacji
+ *             sprzed dwóch kroków
+ * 'nowe_zmiany', 'nowe_zmiany2' - miejsce na zmiany następnej generacji
+ * 'poprz_znana' - 1, gdy 'poprz' zawiera poprzednią generację
+ * 'zmiany2_wszedzie' - 1, gdy 'zmiany2' nie są znane i trzeba je traktować jak całą plansze
+ * 'd1', 'd2', 'kawalki', 'licz' - bufory robocze kroku i ich pojemności 'rozmiar_*'
+ * 'aktywne' - liczba komórek liczonych od nowa w ostatnim kroku
+ * 'suma_aktywnych' - liczba komórek liczonych od nowa we wszystkich krokach
+ * 'suma_wszystkich' - suma populacji wszystkich policzonych generacji
+ * 'regula' - reguła liczenia generacji
+ * 'odcisk' - odcisk aktualnej generacji, uaktualniany w krokach
+ * 'odcisk_znany' - 1, gdy 'odcisk' jest aktualny
+ * 'obszar' - obszar aktualnej generacji, liczony w krokach
+ * 'obszar_znany' - 1, gdy 'obszar' jest aktualny
+ */
+typedef struct PlanszaTablicowa_
+{
+    Tablice akt;
+    Tablice nast;
+    Tablice poprz;
+    Tablice zmiany;
+    Tablice zmiany2;
+    Tablice nowe_zmiany;
+    Tablice nowe_zmiany2;
+    int poprz_znana;
+    int zmiany2_wszedzie;
+    int* d1;
+    int rozmiar_d1;
+    int* d2;
+    int rozmiar_d2;
+    int* kawalki;
+    int rozmiar_kawalkow;
+    int* licz;
+    int rozmiar_licz;
+    long long aktywne;
+    long long suma_aktywnych;
+    long long suma_wszystkich;
+    Regula regula;
+    Odcisk odcisk;
+    int odcisk_znany;
+    Obszar obszar;
+    int obszar_znany;
+} PlanszaTablicowa;
+
+/**
+ * Tworzy pustą plansze tablicową o ustawieniach 'u'
+ */
+static void* tworz_tablice(const Ustawienia* u)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) calloc (1, sizeof(PlanszaTablicowa));
+    t -> regula = u -> regula;
+    return t;
+}
+
+/**
+ * Zapisuje jako wiersz 'wiersz' tablic 'b' 'ile' liczb dopisanych już na koniec 'b' -> kol
+ *
+ * Dla 'ile' równego 0 nie robi nic
+ */
+static void zamknij_wiersz_tablic(Tablice* b, int wiersz, int ile)
+{
+    if (ile == 0)
+        return;
+    b -> w = (WierszTablicy*) powieksz(b -> w, &b -> rozmiar_w, b -> ile_w + 1, sizeof(WierszTablicy));
+    b -> w[b -> ile_w].wiersz = wiersz;
+    b -> w[b -> ile_w].od = b -> ile_kol;
+    b -> w[b -> ile_w].ile = ile;
+    b -> ile_w++;
+    b -> ile_kol += ile;
+}
+
+/**
+ * Zamyka jak zamknij_wiersz_tablic wiersz 'wiersz' z 'ile' żywymi komórkami, doliczając
+ * go do obszaru 'ob'
+ */
+static void zamknij_wiersz_komorek(Tablice* b, int wiersz, int ile, Obszar* ob)
+{
+    if (ile == 0)
+        return;
+    dolicz_wiersz_do_obszaru(ob, wiersz, b -> kol[b -> ile_kol], b -> kol[b -> ile_kol + ile - 1], ile);
+    zamknij_wiersz_tablic(b, wiersz, ile);
+}
+
+/**
+ * Dopisuje liczbę 'x' jako ('*ile' + 1)-szą liczbę otwartego wiersza tablic 'b'
+ */
+static void dopisz_do_wiersza(Tablice* b, int* ile, int x)
+{
+    b -> kol = (int*) powieksz(b -> kol, &b -> rozmiar_kol, b -> ile_kol + *ile + 1, sizeof(int));
+    b -> kol[b -> ile_kol + (*ile)++] = x;
+}
+
+/**
+ * Dopisuje 'n' liczb 'x' na koniec otwartego wiersza tablic 'b' o '*ile' liczbach
+ */
+static void dopisz_kolumny(Tablice* b, int* ile, const int* x, int n)
+{
+    if (n <= 0)
+        return;
+    b -> kol = (int*) powieksz(b -> kol, &b -> rozmiar_kol, b -> ile_kol + *ile + n, sizeof(int));
+    memcpy(b -> kol + b -> ile_kol + *ile, x, (size_t) n * sizeof(int));
+    *ile += n;
+}
+
+/**
+ * Dopisuje na koniec tablic 'kontekst' wiersz 'wiersz' z 'n' żywymi komórkami
+ * w kolumnach 'kol'
+ */
+static void dopisz_do_tablic(void* kontekst, int wiersz, const int* kol, int n)
+{
+    Tablice* a = (Tablice*) kontekst;
+    assert(n > 0);
+    a -> kol = (int*) powieksz(a -> kol, &a -> rozmiar_kol, a -> ile_kol + n, sizeof(int));
+    memcpy(a -> kol + a -> ile_kol, kol, (size_t) n * sizeof(int));
+    zamknij_wiersz_tablic(a, wiersz, n);
+}
+
+/**
+ * Dodaje na koniec planszy tablicowej 's' wiersz 'wiersz' z 'n' żywymi komórkami
+ * w kolumnach 'kol'
+ */
+static void dodaj_wiersz_tablicy(void* s, int wiersz, const int* kol, int n)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    dopisz_do_tablic(&t -> akt, wiersz, kol, n);
+    t -> odcisk_znany = 0;
+    t -> obszar_znany = 0;
+}
+
+/**
+ * Zapisuje w 'wynik' rosnąco kolumny żywych komórek następnej generacji wiersza,
+ * którego żywe komórki to 'b', a wierszy nad i pod nim to 'a' i 'c'
+ *
+ * 'na', 'nb', 'nc' to długości tablic, 'wynik' mieści 3 * (na + nb + nc) liczb.
+ * Stan komórek zmienia się według reguły 'r', która nie może ożywiać komórek
+ * bez żywych sąsiadów. Komórki, które zmieniły stan, dolicza się do otwartego
+ * wiersza zmian 'z', o ile nie jest NULL.
+ *
+ * Zwraca liczbę zapisanych kolumn
+ */
+static int licz_wiersz_tablicy(const int* a, int na, const int* b, int nb,
+                        const int* c, int nc, const Regula* r, int* wynik, ZmianyOdcisku* z)
+{
+    int ia = 0;
+    int ib = 0;
+    int ic = 0;
+    int ile = 0;
+    int m = INT_MAX;
+    if (na > 0 && a[0] < m)
+        m = a[0];
+    if (nb > 0 && b[0] < m)
+        m = b[0];
+    if (nc > 0 && c[0] < m)
+        m = c[0];
+    if (m == INT_MAX)
+        return 0;
+    int x = m - 1;
+    while (1) {
+        while (ia < na && a[ia] < x - 1)
+            ia++;
+        while (ib < nb && b[ib] < x - 1)
+            ib++;
+        while (ic < nc && c[ic] < x - 1)
+            ic++;
+        int sasiedzi = 0;
+        int zywa = 0;
+        for (int i = ia; i < na && a[i] <= x + 1; i++)
+            sasiedzi++;
+        for (int i = ic; i < nc && c[i] <= x + 1; i++)
+            sasiedzi++;
+        for (int i = ib; i < nb && b[i] <= x + 1; i++) {
+            if (b[i] == x)
+                zywa = 1;
+            else
+                sasiedzi++;
+        }
+        int nowa = nowy_stan(r, zywa, sasiedzi);
+        if (nowa)
+            wynik[ile++] = x;
+        if (z != NULL && nowa != zywa)
+            dolicz_zmiane(z, x, x, nowa);
+        m = INT_MAX;
+        int j = ia;
+        while (j < na && a[j] < x)
+            j++;
+        if (j < na && a[j] < m)
+            m = a[j];
+        j = ib;
+        while (j < nb && b[j] < x)
+            j++;
+        if (j < nb && b[j] < m)
+            m = b[j];
+        j = ic;
+        while (j < nc && c[j] < x)
+            j++;
+        if (j < nc && c[j] < m)
+            m = c[j];
+        if (m == INT_MAX)
+            break;
+        x = m - 1 > x + 1 ? m - 1 : x + 1;
+    }
+    return ile;
+}
+
+/**
+ * Oblicza następną generację planszy tablicowej 't'
+ *
+ * Każdy wiersz następnej generacji powstaje przez scalenie trzech sąsiednich
+ * wierszy aktualnej generacji. Obszar nowej generacji i, gdy odcisk jest znany,
+ * zmiany odcisku dolicza się wiersz po wierszu.
+ */
+static void nastepna_generacja_tablicy(PlanszaTablicowa* t)
+{
+    Tablice* a = &t -> akt;
+    Tablice* b = &t -> nast;
+    b -> ile_w = 0;
+    b -> ile_kol = 0;
+    ZmianyOdcisku zmiany;
+    ZmianyOdcisku* z = t -> odcisk_znany ? &zmiany : NULL;
+    zacznij_zmiany(&zmiany);
+    memset(&t -> obszar, 0, sizeof(Obszar));
+    int i = 0;
+    int y = a -> ile_w > 0 ? a -> w[0].wiersz - 1 : 0;
+    while (i < a -> ile_w) {
+        const int* kol[3] = {NULL, NULL, NULL};
+        int n[3] = {0, 0, 0};
+        int j = i;
+        for (int d = 0; d < 3; d++) {
+            if (j < a -> ile_w && a -> w[j].wiersz == y - 1 + d) {
+                kol[d] = a -> kol + a -> w[j].od;
+                n[d] = a -> w[j].ile;
+                j++;
+            }
+        }
+        b -> kol = (int*) powieksz(b -> kol, &b -> rozmiar_kol,
+                                   b -> ile_kol + 3 * (n[0] + n[1] + n[2]), sizeof(int));
+        int ile = licz_wiersz_tablicy(kol[0], n[0], kol[1], n[1], kol[2], n[2], &t -> regula,
+                                      b -> kol + b -> ile_kol, z);
+        if (z != NULL)
+            zamknij_wiersz_zmian(z, y);
+        zamknij_wiersz_komorek(b, y, ile, &t -> obszar);
+        y++;
+        while (i < a -> ile_w && a -> w[i].wiersz < y - 1)
+            i++;
+        if (i < a -> ile_w && a -> w[i].wiersz - 1 > y)
+            y = a -> w[i].wiersz - 1;
+    }
+    Tablice pom = t -> akt;
+    t -> akt = t -> nast;
+    t -> nast = pom;
+    t -> obszar_znany = 1;
+    if (z != NULL)
+        zakoncz_zmiany(&t -> odcisk, z, &t -> obszar);
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy tablicowej 's'
+ */
+static void krok_tablicy(void* s, int n)
+{
+    for (int i = 0; i < n; i++)
+        nastepna_generacja_tablicy((PlanszaTablicowa*) s);
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy tablicowej 's' na 'r'
+ */
+static void ustaw_regule_tablicy(void* s, const Regula* r)
+{
+    ((PlanszaTablicowa*) s) -> regula = *r;
+}
+
+/**
+ * Zwraca indeks pierwszej liczby nie mniejszej niż 'x' w rosnącej tablicy 'a' długości 'n'
+ */
+static int szukaj_kolumny(const int* a, int n, int x)
+{
+    int l = 0;
+    int p = n;
+    while (l < p) {
+        int s = l + (p - l) / 2;
+        if (a[s] < x)
+            l = s + 1;
+        else
+            p = s;
+    }
+    return l;
+}
+
+/**
+ * Zwraca indeks pierwszego wiersza tablicy 'a' o numerze nie mniejszym niż 'wiersz'
+ */
+static int szukaj_wiersza_tablicy(const Tablice* a, int wiersz)
+{
+    int l = 0;
+    int p = a -> ile_w;
+    while (l < p) {
+        int s = l + (p - l) / 2;
+        if (a -> w[s].wiersz < wiersz)
+            l = s + 1;
+        else
+            p = s;
+    }
+    return l;
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy tablicowej 's'
+ * o numerach od 'od' do 'do_'
+ */
+static void przegladaj_tablice(void* s, int od, int do_, int kol_od, int kol_do,
+                        OdbiorcaWiersza f, void* kontekst)
+{
+    Tablice* a = &((PlanszaTablicowa*) s) -> akt;
+    for (int i = szukaj_wiersza_tablicy(a, od); i < a -> ile_w && a -> w[i].wiersz <= do_; i++) {
+        const int* kol = a -> kol + a -> w[i].od;
+        int n = a -> w[i].ile;
+        int l = kol_od == INT_MIN ? 0 : szukaj_kolumny(kol, n, kol_od);
+        int p = kol_do == INT_MAX ? n : szukaj_kolumny(kol, n, kol_do + 1);
+        if (l < p)
+            f(kontekst, a -> w[i].wiersz, kol + l, p - l);
+    }
+}
+
+/**
+ * Zapisuje w 'o' odcisk aktualnej generacji planszy tablicowej 's'
+ *
+ * Gdy odcisk nie jest jeszcze znany, liczy go, przeglądając plansze, a potem kroki
+ * tylko go uaktualniają
+ */
+static void odcisk_tablicy(void* s, Odcisk* o)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    if (!t -> odcisk_znany) {
+        memset(&t -> odcisk, 0, sizeof(Odcisk));
+        przegladaj_tablice(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_do_odcisku, &t -> odcisk);
+        t -> odcisk_znany = 1;
+    }
+    *o = t -> odcisk;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek aktualnej generacji planszy
+ * tablicowej 's'
+ *
+ * Kroki silników "tablica" i "aktywne" liczą obszar przy okazji, więc plansze
+ * przegląda się tylko zaraz po wczytaniu
+ */
+static void obszar_tablicy(void* s, Obszar* o)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    if (!t -> obszar_znany) {
+        memset(&t -> obszar, 0, sizeof(Obszar));
+        przegladaj_tablice(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_obszar, &t -> obszar);
+        t -> obszar_znany = 1;
+    }
+    *o = t -> obszar;
+}
+
+/**
+ * Przesuwa wszystkie liczby tablic 'a' o 'dy' wierszy i 'dx' kolumn
+ */
+static void przesun_tablice(Tablice* a, int dy, int dx)
+{
+    for (int i = 0; i < a -> ile_w; i++)
+        a -> w[i].wiersz += dy;
+    for (int i = 0; i < a -> ile_kol; i++)
+        a -> kol[i] += dx;
+}
+
+/**
+ * Przesuwa wszystkie komórki planszy tablicowej 's' o 'dy' wierszy i 'dx' kolumn
+ *
+ * Razem z generacją przesuwa poprzednią generację i zmiany silnika "aktywne"
+ */
+static void przesun_tablice_planszy(void* s, int dy, int dx)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    przesun_tablice(&t -> akt, dy, dx);
+    przesun_tablice(&t -> poprz, dy, dx);
+    przesun_tablice(&t -> zmiany, dy, dx);
+    przesun_tablice(&t -> zmiany2, dy, dx);
+    przesun_odcisk(&t -> odcisk, dy, dx);
+    przesun_obszar(&t -> obszar, dy, dx);
+}
+
+/**
+ * Usuwa plansze tablicową 's'
+ */
+static void czysc_tablice(void* s)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    Tablice* tab[7] = {&t -> akt, &t -> nast, &t -> poprz, &t -> zmiany, &t -> zmiany2,
+                       &t -> nowe_zmiany, &t -> nowe_zmiany2};
+    for (int i = 0; i < 7; i++) {
+        free(tab[i] -> w);
+        free(tab[i] -> kol);
+    }
+    free(t -> d1);
+    free(t -> d2);
+    free(t -> kawalki);
+    free(t -> licz);
+    free(t);
+}
+
+/**
+ * Zapisuje w '*bufor' rosnące, rozłączne przedziały kolumn (pary liczb) zawierające
+ * wszystkie komórki odległe o co najwyżej 1 od przedziałów wierszy 'y' - 1, 'y', 'y' + 1
+ * tablic przedziałów 'z'
+ *
+ * '*i' to indeks wiersza 'z', od którego zacząć szukanie, jest uaktualniany.
+ * '*rozmiar' to pojemność bufora, jest uaktualniana.
+ *
+ * Zwraca liczbę przedziałów
+ */
+static int otocz_przedzialy(const Tablice* z, int* i, int y, int** bufor, int* rozmiar)
+{
+    while (*i < z -> ile_w && z -> w[*i].wiersz < y - 1)
+        (*i)++;
+    const int* p[3];
+    int n[3];
+    int idx[3] = {0, 0, 0};
+    int ile_w = 0;
+    int suma = 0;
+    for (int j = *i; j < z -> ile_w && z -> w[j].wiersz <= y + 1; j++) {
+        p[ile_w] = z -> kol + z -> w[j].od;
+        n[ile_w] = z -> w[j].ile / 2;
+        suma += n[ile_w];
+        ile_w++;
+    }
+    *bufor = (int*) powieksz(*bufor, rozmiar, 2 * suma, sizeof(int));
+    int* d = *bufor;
+    int ile = 0;
+    while (1) {
+        int r = -1;
+        for (int j = 0; j < ile_w; j++)
+            if (idx[j] < n[j] && (r < 0 || p[j][2 * idx[j]] < p[r][2 * idx[r]]))
+                r = j;
+        if (r < 0)
+            break;
+        int a = p[r][2 * idx[r]] - 1;
+        int b = p[r][2 * idx[r] + 1] + 1;
+        idx[r]++;
+        if (ile > 0 && a <= d[2 * ile - 1] + 1) {
+            if (b > d[2 * ile - 1])
+                d[2 * ile - 1] = b;
+        }
+        else {
+            d[2 * ile] = a;
+            d[2 * ile + 1] = b;
+            ile++;
+        }
+    }
+    return ile;
+}
+
+/**
+ * Dzieli 'n1' przedziałów 'd1' na kawałki do policzenia od nowa (leżące w którymś
+ * z 'n2' przedziałów 'd2' lub wszystkie, gdy 'wszedzie' jest niezerowe) i kawałki
+ * do przepisania z poprzedniej generacji (pozostałe)
+ *
+ * Zapisuje w '*bufor' trójki [a, b, rodzaj], rodzaj 2 oznacza liczenie, a 1 przepisanie.
+ * Zwraca liczbę kawałków.
+ */
+static int podziel_przedzialy(const int* d1, int n1, const int* d2, int n2, int wszedzie,
+                       int** bufor, int* rozmiar)
+{
+    *bufor = (int*) powieksz(*bufor, rozmiar, 3 * (2 * n1 + 2 * n2 + 1), sizeof(int));
+    int* k = *bufor;
+    int ile = 0;
+    int j = 0;
+    for (int i = 0; i < n1; i++) {
+        int a = d1[2 * i];
+        int b = d1[2 * i + 1];
+        if (wszedzie) {
+            k[3 * ile] = a;
+            k[3 * ile + 1] = b;
+            k[3 * ile + 2] = 2;
+            ile++;
+            continue;
+        }
+        int x = a;
+        while (1) {
+            while (j < n2 && d2[2 * j + 1] < x)
+                j++;
+            int koniec;
+            int rodzaj;
+            if (j < n2 && d2[2 * j] <= x) {
+                koniec = d2[2 * j + 1] < b ? d2[2 * j + 1] : b;
+                rodzaj = 2;
+            }
+            else {
+                koniec = j < n2 && d2[2 * j] - 1 < b ? d2[2 * j] - 1 : b;
+                rodzaj = 1;
+            }
+            k[3 * ile] = x;
+            k[3 * ile + 1] = koniec;
+            k[3 * ile + 2] = rodzaj;
+            ile++;
+            if (koniec == b)
+                break;
+            x = koniec + 1;
+        }
+    }
+    return ile;
+}
+
+/**
+ * Dopisuje do otwartego wiersza tablic przedziałów 'z' ('*ile' liczb) kolumny z przedziału
+ * ['a', 'b'], w których różnią się rosnące tablice 'x' i 'y' długości 'nx' i 'ny'
+ *
+ * Kolumny odległe o najwyżej 2 łączy w jeden przedział. Gdy 'zo' nie jest NULL, dolicza
+ * do otwartego wiersza zmian 'zo' kolumny tylko z 'x' jako ożywione, a tylko z 'y'
+ * jako martwe.
+ */
+static void dopisz_roznice(Tablice* z, int* ile, const int* x, int nx, const int* y, int ny, int a, int b,
+                    ZmianyOdcisku* zo)
+{
+    int i = szukaj_kolumny(x, nx, a);
+    int j = szukaj_kolumny(y, ny, a);
+    while (1) {
+        int vx = i < nx && x[i] <= b ? x[i] : INT_MAX;
+        int vy = j < ny && y[j] <= b ? y[j] : INT_MAX;
+        if (vx == INT_MAX && vy == INT_MAX)
+            break;
+        int c;
+        if (vx == vy) {
+            i++;
+            j++;
+            continue;
+        }
+        if (vx < vy) {
+            c = vx;
+            i++;
+        }
+        else {
+            c = vy;
+            j++;
+        }
+        if (zo != NULL)
+            dolicz_zmiane(zo, c, c, vx < vy);
+        if (*ile > 0 && c <= z -> kol[z -> ile_kol + *ile - 1] + 2)
+            z -> kol[z -> ile_kol + *ile - 1] = c;
+        else {
+            dopisz_do_wiersza(z, ile, c);
+            dopisz_do_wiersza(z, ile, c);
+        }
+    }
+}
+
+/**
+ * Zeruje tablice 't'
+ */
+static void oproznij_tablice(Tablice* t)
+{
+    t -> ile_w = 0;
+    t -> ile_kol = 0;
+}
+
+/**
+ * Przygotowuje wczytaną plansze silnika "aktywne" 's'
+ *
+ * Poprzednia generacja nie jest znana, więc za zmienione uznaje się
+ * całe wiersze od pierwszej do ostatniej żywej komórki
+ */
+static void przygotuj_aktywne(void* s)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    Tablice* a = &t -> akt;
+    oproznij_tablice(&t -> zmiany);
+    for (int i = 0; i < a -> ile_w; i++) {
+        int ile = 0;
+        dopisz_do_wiersza(&t -> zmiany, &ile, a -> kol[a -> w[i].od]);
+        dopisz_do_wiersza(&t -> zmiany, &ile, a -> kol[a -> w[i].od + a -> w[i].ile - 1]);
+        zamknij_wiersz_tablic(&t -> zmiany, a -> w[i].wiersz, ile);
+    }
+    t -> poprz_znana = 0;
+    t -> zmiany2_wszedzie = 1;
+}
+
+/**
+ * Oblicza następną generację planszy tablicowej 't', licząc od nowa tylko komórki
+ * odległe o co najwyżej 1 od zmian ostatniego kroku
+ *
+ * Komórka, której otoczenie nie zmieniło się w ostatnim kroku, zachowuje stan,
+ * więc poza przedziałami 'zmiany' wiersze przepisuje się bez zmian. Komórka, której
+ * otoczenie jest takie jak dwa kroki temu, dostaje stan sprzed kroku, więc poza
+ * przedziałami 'zmiany2' przepisuje się poprzednią generację. Dzięki temu martwe
+ * natury i oscylatory o okresie 2 nie są liczone wcale. Zmiany odcisku to różnice
+ * liczone dla 'nowe_zmiany'.
+ */
+static void nastepna_generacja_aktywna(PlanszaTablicowa* t)
+{
+    Tablice* a = &t -> akt;
+    Tablice* p = &t -> poprz;
+    Tablice* b = &t -> nast;
+    Tablice* z1 = &t -> zmiany;
+    Tablice* z2 = &t -> zmiany2;
+    Tablice* nz1 = &t -> nowe_zmiany;
+    Tablice* nz2 = &t -> nowe_zmiany2;
+    oproznij_tablice(b);
+    oproznij_tablice(nz1);
+    oproznij_tablice(nz2);
+    ZmianyOdcisku zmiany;
+    ZmianyOdcisku* zo = t -> odcisk_znany ? &zmiany : NULL;
+    zacznij_zmiany(&zmiany);
+    memset(&t -> obszar, 0, sizeof(Obszar));
+    t -> aktywne = 0;
+    int ia = 0;
+    int ip = 0;
+    int iz1 = 0;
+    int iz2 = 0;
+    int y = INT_MAX;
+    if (a -> ile_w > 0)
+        y = a -> w[0].wiersz;
+    if (z1 -> ile_w > 0 && z1 -> w[0].wiersz - 1 < y)
+        y = z1 -> w[0].wiersz - 1;
+    while (y != INT_MAX) {
+        while (ia < a -> ile_w && a -> w[ia].wiersz < y - 1)
+            ia++;
+        int j = ia;
+        while (j < a -> ile_w && a -> w[j].wiersz < y)
+            j++;
+        int ny = j < a -> ile_w ? a -> w[j].wiersz : INT_MAX;
+        while (iz1 < z1 -> ile_w && z1 -> w[iz1].wiersz < y - 1)
+            iz1++;
+        if (iz1 < z1 -> ile_w) {
+            int c = z1 -> w[iz1].wiersz - 1 > y ? z1 -> w[iz1].wiersz - 1 : y;
+            ny = c < ny ? c : ny;
+        }
+        if (ny == INT_MAX)
+            break;
+        y = ny;
+        while (ia < a -> ile_w && a -> w[ia].wiersz < y - 1)
+            ia++;
+        const int* kol[3] = {NULL, NULL, NULL};
+        int n[3] = {0, 0, 0};
+        j = ia;
+        for (int d = 0; d < 3; d++) {
+            if (j < a -> ile_w && a -> w[j].wiersz == y - 1 + d) {
+                kol[d] = a -> kol + a -> w[j].od;
+                n[d] = a -> w[j].ile;
+                j++;
+            }
+        }
+        int ile = 0;
+        int n1 = otocz_przedzialy(z1, &iz1, y, &t -> d1, &t -> rozmiar_d1);
+        if (n1 == 0) {
+            dopisz_kolumny(b, &ile, kol[1], n[1]);
+            zamknij_wiersz_komorek(b, y, ile, &t -> obszar);
+            y++;
+            continue;
+        }
+        int n2 = t -> zmiany2_wszedzie ? 0 : otocz_przedzialy(z2, &iz2, y, &t -> d2, &t -> rozmiar_d2);
+        int nk = podziel_przedzialy(t -> d1, n1, t -> d2, n2, t -> zmiany2_wszedzie,
+                                    &t -> kawalki, &t -> rozmiar_kawalkow);
+        while (ip < p -> ile_w && p -> w[ip].wiersz < y)
+            ip++;
+        const int* py = NULL;
+        int npy = 0;
+        if (t -> poprz_znana && ip < p -> ile_w && p -> w[ip].wiersz == y) {
+            py = p -> kol + p -> w[ip].od;
+            npy = p -> w[ip].ile;
+        }
+        int ka = 0;
+        for (int k = 0; k < nk; k++) {
+            int pa = t -> kawalki[3 * k];
+            int pb = t -> kawalki[3 * k + 1];
+            int od = ka + szukaj_kolumny(kol[1] + ka, n[1] - ka, pa);
+            dopisz_kolumny(b, &ile, kol[1] + ka, od - ka);
+            ka = od + szukaj_kolumny(kol[1] + od, n[1] - od, pb + 1);
+            if (t -> kawalki[3 * k + 2] == 1) {
+                int i = szukaj_kolumny(py, npy, pa);
+                dopisz_kolumny(b, &ile, py + i, szukaj_kolumny(py, npy, pb + 1) - i);
+                continue;
+            }
+            const int* sub[3];
+            int nsub[3];
+            for (int d = 0; d < 3; d++) {
+                int od = szukaj_kolumny(kol[d], n[d], pa - 1);
+                sub[d] = kol[d] + od;
+                nsub[d] = szukaj_kolumny(kol[d], n[d], pb + 2) - od;
+            }
+            t -> licz = (int*) powieksz(t -> licz, &t -> rozmiar_licz,
+                                        3 * (nsub[0] + nsub[1] + nsub[2]) + 1, sizeof(int));
+            int m = licz_wiersz_tablicy(sub[0], nsub[0], sub[1], nsub[1], sub[2], nsub[2],
+                                        &t -> regula, t -> licz, NULL);
+            for (int i = 0; i < m; i++)
+                if (t -> licz[i] >= pa && t -> licz[i] <= pb)
+                    dopisz_do_wiersza(b, &ile, t -> licz[i]);
+            t -> aktywne += (long long) pb - pa + 1;
+        }
+        dopisz_kolumny(b, &ile, kol[1] + ka, n[1] - ka);
+        const int* by = b -> kol + b -> ile_kol;
+        int ile1 = 0;
+        int ile2 = 0;
+        for (int i = 0; i < n1; i++) {
+            dopisz_roznice(nz1, &ile1, by, ile, kol[1], n[1], t -> d1[2 * i], t -> d1[2 * i + 1],
+                           zo);
+            if (t -> poprz_znana)
+                dopisz_roznice(nz2, &ile2, by, ile, py, npy, t -> d1[2 * i], t -> d1[2 * i + 1],
+                               NULL);
+        }
+        if (zo != NULL)
+            zamknij_wiersz_zmian(zo, y);
+        zamknij_wiersz_komorek(b, y, ile, &t -> obszar);
+        zamknij_wiersz_tablic(nz1, y, ile1);
+        zamknij_wiersz_tablic(nz2, y, ile2);
+        y++;
+    }
+    Tablice pom = t -> poprz;
+    t -> poprz = t -> akt;
+    t -> akt = t -> nast;
+    t -> nast = pom;
+    pom = t -> zmiany;
+    t -> zmiany = t -> nowe_zmiany;
+    t -> nowe_zmiany = pom;
+    pom = t -> zmiany2;
+    t -> zmiany2 = t -> nowe_zmiany2;
+    t -> nowe_zmiany2 = pom;
+    t -> zmiany2_wszedzie = !t -> poprz_znana;
+    t -> poprz_znana = 1;
+    t -> obszar_znany = 1;
+    if (zo != NULL)
+        zakoncz_zmiany(&t -> odcisk, zo, &t -> obszar);
+    t -> suma_aktywnych += t -> aktywne;
+    t -> suma_wszystkich += t -> akt.ile_kol;
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy silnika "aktywne" 's'
+ */
+static void krok_aktywnych(void* s, int n)
+{
+    for (int i = 0; i < n; i++)
+        nastepna_generacja_aktywna((PlanszaTablicowa*) s);
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy silnika "aktywne" 's' na 'r'
+ *
+ * Zmiany ostatnich kroków nic nie mówią o następnej generacji liczonej inną regułą,
+ * więc po zmianie reguły plansza zaczyna tak, jak po wczytaniu
+ */
+static void ustaw_regule_aktywnych(void* s, const Regula* r)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    if (t -> regula.narodziny == r -> narodziny && t -> regula.przetrwanie == r -> przetrwanie)
+        return;
+    t -> regula = *r;
+    przygotuj_aktywne(s);
+}
+
+/**
+ * Pisze do 'f' liczbę komórek planszy silnika "aktywne" 's' liczonych od nowa
+ * w ostatnim kroku i we wszystkich krokach wobec populacji
+ */
+static void pisz_statystyki_aktywnych(void* s, FILE* f)
+{
+    PlanszaTablicowa* t = (PlanszaTablicowa*) s;
+    fprintf(f, "aktywne: ostatnio %lld z %d komorek, lacznie %lld z %lld\n",
+            t -> aktywne, t -> akt.ile_kol, t -> suma_aktywnych, t -> suma_wszystkich);
+}
+
+/**
+ * Ustawia 'zmienione'[y - od] na 1 dla wierszy y od 'od' do 'do_' planszy silnika
+ * "aktywne" 's', w których ostatni krok zmienił komórki w kolumnach od 'kol_od'
+ * do 'kol_do'
+ *
+ * Korzysta z przedziałów 'zmiany', które silnik i tak utrzymuje
+ */
+static void zmienione_wiersze_aktywnych(void* s, int od, int do_, int kol_od, int kol_do, char* zmienione)
+{
+    const Tablice* z = &((PlanszaTablicowa*) s) -> zmiany;
+    for (int i = szukaj_wiersza_tablicy(z, od); i < z -> ile_w && z -> w[i].wiersz <= do_; i++) {
+        const int* p = z -> kol + z -> w[i].od;
+        for (int j = 0; j < z -> w[i].ile; j += 2)
+            if (p[j] <= kol_do && p[j + 1] >= kol_od) {
+                zmienione[z -> w[i].wiersz - od] = 1;
+                break;
+            }
+    }
+}
+
+/**
+ * Usuwa plansze silnika "aktywne" 's'
+ */
+static void czysc_aktywne(void* s)
+{
+#ifdef STATYSTYKI
+    pisz_statystyki_aktywnych(s, stderr);
+#endif
+    czysc_tablice(s);
+}
+
+/**
+ * Najmniejsza średnia długość ciągu żywych komórek wiersza, przy której silnik "odcinki"
+ * trzyma wiersz jako odcinki, a nie pojedyncze komórki
+ */
+#define DLUGOSC_ODCINKA 4
+
+/**
+ * Reprezentuje plansze silnika "odcinki"
+ *
+ * Wiersze trzyma się w Tablice jak w planszy tablicowej, ale wiersz, którego żywe
+ * komórki tworzą długie ciągi, zapisuje się jako kolejne pary [a, b] kolumn pierwszej
+ * i ostatniej komórki ciągu, a 'ile' takiego wiersza to liczba liczb.
+ *
+ * 'akt' - aktualna generacja
+ * 'nast' - miejsce na następną generację, zamieniane z 'akt' po każdym kroku
+ * 'odcinkowe_akt', 'odcinkowe_nast' - 1 dla wierszy 'akt' i 'nast' zapisanych odcinkami,
+ *                                    0 dla zapisanych komórkami
+ * 'rozmiar_akt', 'rozmiar_nast' - pojemności tablic 'odcinkowe_*'
+ * 'odcinki' - bufory na odcinki trzech sąsiednich wierszy zapisanych komórkami
+ * 'rozmiar_odcinkow' - pojemności buforów 'odcinki'
+ * 'wynik' - bufor na liczony wiersz następnej generacji
+ * 'komorki' - bufor na wiersz rozwinięty do komórek dla odbiorców wierszy
+ * 'rozmiar_wyniku', 'rozmiar_komorek' - pojemności buforów 'wynik' i 'komorki'
+ * 'regula' - reguła liczenia generacji
+ * 'odcisk' - odcisk aktualnej generacji, uaktualniany w krokach
+ * 'odcisk_znany' - 1, gdy 'odcisk' jest aktualny
+ * 'obszar' - obszar aktualnej generacji, liczony w krokach
+ * 'obszar_znany' - 1, gdy 'obszar' jest aktualny
+ */
+typedef struct PlanszaOdcinkowa_
+{
+    Tablice akt;
+    Tablice nast;
+    char* odcinkowe_akt;
+    int rozmiar_akt;
+    char* odcinkowe_nast;
+    int rozmiar_nast;
+    int* odcinki[3];
+    int rozmiar_odcinkow[3];
+    int* wynik;
+    int rozmiar_wyniku;
+    int* komorki;
+    int rozmiar_komorek;
+    Regula regula;
+    Odcisk odcisk;
+    int odcisk_znany;
+    Obszar obszar;
+    int obszar_znany;
+} PlanszaOdcinkowa;
+
+/**
+ * Tworzy pustą plansze silnika "odcinki" o ustawieniach 'u'
+ */
+static void* tworz_odcinki(const Ustawienia* u)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) calloc (1, sizeof(PlanszaOdcinkowa));
+    po -> regula = u -> regula;
+    return po;
+}
+
+/**
+ * Zwraca liczbę ciągów sąsiednich komórek wśród 'n' rosnących kolumn 'kol'
+ */
+static int zlicz_ciagi(const int* kol, int n)
+{
+    int wynik = n > 0;
+    for (int i = 1; i < n; i++)
+        if (kol[i] != kol[i - 1] + 1)
+            wynik++;
+    return wynik;
+}
+
+/**
+ * Zapisuje w 'wynik' odcinki 'n' rosnących kolumn 'kol'
+ *
+ * Zwraca liczbę zapisanych liczb
+ */
+static int do_odcinkow(const int* kol, int n, int* wynik)
+{
+    int ile = 0;
+    for (int i = 0; i < n; i++) {
+        if (ile > 0 && wynik[ile - 1] == kol[i] - 1)
+            wynik[ile - 1] = kol[i];
+        else {
+            wynik[ile++] = kol[i];
+            wynik[ile++] = kol[i];
+        }
+    }
+    return ile;
+}
+
+/**
+ * Zwraca liczbę komórek odcinków zapisanych w 'n' liczbach 'odc'
+ */
+static int dlugosc_odcinkow(const int* odc, int n)
+{
+    int wynik = 0;
+    for (int i = 0; i < n; i += 2)
+        wynik += odc[i + 1] - odc[i] + 1;
+    return wynik;
+}
+
+/**
+ * Zapisuje w 'wynik' kolumny komórek odcinków zapisanych w 'n' liczbach 'odc',
+ * pomijając komórki spoza kolumn od 'kol_od' do 'kol_do'
+ *
+ * Zwraca liczbę zapisanych kolumn
+ */
+static int do_komorek(const int* odc, int n, int kol_od, int kol_do, int* wynik)
+{
+    int ile = 0;
+    for (int i = 0; i < n && odc[i] <= kol_do; i += 2) {
+        int a = odc[i] > kol_od ? odc[i] : kol_od;
+        int b = odc[i + 1] < kol_do ? odc[i + 1] : kol_do;
+        for (long long x = a; x <= b; x++)
+            wynik[ile++] = (int) x;
+    }
+    return ile;
+}
+
+/**
+ * Dopisuje na koniec tablic 't' wiersz 'wiersz' zapisany w 'n' liczbach 'x', które są
+ * odcinkami, gdy 'odcinkami' jest niezerowe, a kolumnami komórek wpp.
+ *
+ * Wiersz zapisuje się odcinkami, gdy średnia długość jego ciągów komórek to co najmniej
+ * DLUGOSC_ODCINKA, wpp. komórkami. Rodzaj zapisu dopisuje się do '*odcinkowe'
+ * o pojemności '*rozmiar'. Pusty wiersz pomija się, a niepusty dolicza do obszaru 'ob',
+ * o ile nie jest NULL.
+ */
+static void dopisz_wiersz_odcinkow(Tablice* t, char** odcinkowe, int* rozmiar, int wiersz,
+                            const int* x, int n, int odcinkami, Obszar* ob)
+{
+    if (n == 0)
+        return;
+    int ciagi = odcinkami ? n / 2 : zlicz_ciagi(x, n);
+    int komorki = odcinkami ? dlugosc_odcinkow(x, n) : n;
+    if (ob != NULL)
+        dolicz_wiersz_do_obszaru(ob, wiersz, x[0], x[n - 1], komorki);
+    int zapis = komorki >= DLUGOSC_ODCINKA * ciagi;
+    int ile = zapis ? 2 * ciagi : komorki;
+    t -> kol = (int*) powieksz(t -> kol, &t -> rozmiar_kol, t -> ile_kol + ile, sizeof(int));
+    int* cel = t -> kol + t -> ile_kol;
+    if (zapis == odcinkami)
+        memcpy(cel, x, (size_t) n * sizeof(int));
+    else if (zapis)
+        do_odcinkow(x, n, cel);
+    else
+        do_komorek(x, n, INT_MIN, INT_MAX, cel);
+    *odcinkowe = (char*) powieksz(*odcinkowe, rozmiar, t -> ile_w + 1, sizeof(char));
+    (*odcinkowe)[t -> ile_w] = (char) zapis;
+    zamknij_wiersz_tablic(t, wiersz, ile);
+}
+
+/**
+ * Dodaje na koniec planszy silnika "odcinki" 's' wiersz 'wiersz' z 'n' żywymi komórkami
+ * w kolumnach 'kol'
+ */
+static void dodaj_wiersz_odcinkow(void* s, int wiersz, const int* kol, int n)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    dopisz_wiersz_odcinkow(&po -> akt, &po -> odcinkowe_akt, &po -> rozmiar_akt, wiersz, kol, n,
+                           0, NULL);
+    po -> odcisk_znany = 0;
+    po -> obszar_znany = 0;
+}
+
+/**
+ * Zwraca liczbę żywych komórek w kolumnach od 'x' - 1 do 'x' + 1 wiersza zapisanego
+ * w 'n' liczbach odcinków 'odc', gdy 'i' to indeks pierwszego odcinka, który nie kończy
+ * się przed kolumną 'x' - 1
+ */
+static inline int zywe_w_oknie(const int* odc, int n, int i, long long x)
+{
+    int wynik = 0;
+    for (int j = i; j < n && j <= i + 2; j += 2) {
+        long long a = odc[j] > x - 1 ? odc[j] : x - 1;
+        long long b = odc[j + 1] < x + 1 ? odc[j + 1] : x + 1;
+        if (a <= b)
+            wynik += (int) (b - a + 1);
+    }
+    return wynik;
+}
+
+/**
+ * Zwraca najmniejszą kolumnę większą od 'x', w której zmienia się liczba żywych komórek
+ * wiersza zapisanego w 'n' liczbach odcinków 'odc' w oknie trzech kolumn wokół niej
+ * lub stan komórki w niej, LLONG_MAX, gdy takiej kolumny nie ma
+ *
+ * 'i' to indeks pierwszego odcinka, który nie kończy się przed kolumną 'x' - 1. Odcinek
+ * [a, b] zmienia okno w kolumnach a - 1, a, a + 1, b, b + 1 i b + 2, a kolejne odcinki
+ * zaczynają się za oknem, więc wystarczy sprawdzić dwa odcinki.
+ */
+static inline long long nastepny_punkt(const int* odc, int n, int i, long long x)
+{
+    long long wynik = LLONG_MAX;
+    for (int j = i; j < n && j <= i + 2; j += 2) {
+        long long p[6] = {(long long) odc[j] - 1, odc[j], (long long) odc[j] + 1,
+                          odc[j + 1], (long long) odc[j + 1] + 1, (long long) odc[j + 1] + 2};
+        for (int k = 0; k < 6; k++)
+            if (p[k] > x && p[k] < wynik)
+                wynik = p[k];
+    }
+    return wynik;
+}
+
+/**
+ * Zapisuje w 'wynik' odcinki następnej generacji wiersza, którego odcinki to 'b',
+ * a wierszy nad i pod nim to 'a' i 'c'
+ *
+ * 'na', 'nb', 'nc' to liczby liczb odcinków, 'wynik' mieści 6 * (na + nb + nc) liczb.
+ * Liczba sąsiadów i stan komórki zmieniają się tylko w kolumnach wskazanych przez
+ * nastepny_punkt, więc stan następnej generacji liczy się tylko w nich, a między nimi
+ * przepisuje. Stan komórek zmienia się według reguły 'r', która nie może ożywiać
+ * komórek bez żywych sąsiadów. Ciągi komórek, które zmieniły stan, dolicza się
+ * do otwartego wiersza zmian 'z', o ile nie jest NULL.
+ *
+ * Zwraca liczbę zapisanych liczb
+ */
+static int licz_wiersz_odcinkow(const int* a, int na, const int* b, int nb, const int* c, int nc,
+                         const Regula* r, int* wynik, ZmianyOdcisku* z)
+{
+    const int* odc[3] = {a, b, c};
+    int n[3] = {na, nb, nc};
+    int i[3] = {0, 0, 0};
+    long long x = LLONG_MAX;
+    for (int d = 0; d < 3; d++)
+        if (n[d] > 0 && (long long) odc[d][0] - 1 < x)
+            x = (long long) odc[d][0] - 1;
+    int ile = 0;
+    while (x != LLONG_MAX) {
+        int sasiedzi = 0;
+        long long nast = LLONG_MAX;
+        for (int d = 0; d < 3; d++) {
+            while (i[d] < n[d] && odc[d][i[d] + 1] < x - 1)
+                i[d] += 2;
+            sasiedzi += zywe_w_oknie(odc[d], n[d], i[d], x);
+            long long p = nastepny_punkt(odc[d], n[d], i[d], x);
+            if (p < nast)
+                nast = p;
+        }
+        int zywa = i[1] < n[1] && b[i[1]] <= x && x <= b[i[1] + 1];
+        int nowa = nowy_stan(r, zywa, sasiedzi - zywa);
+        if (z != NULL && nowa != zywa)
+            dolicz_zmiane(z, x, nast - 1, nowa);
+        if (nowa) {
+            if (ile > 0 && wynik[ile - 1] == x - 1)
+                wynik[ile - 1] = (int) (nast - 1);
+            else {
+                wynik[ile++] = (int) x;
+                wynik[ile++] = (int) (nast - 1);
+            }
+        }
+        x = nast;
+    }
+    return ile;
+}
+
+/**
+ * Oblicza następną generację planszy silnika "odcinki" 'po'
+ *
+ * Gdy trzy sąsiednie wiersze są zapisane komórkami, wiersz następnej generacji liczy
+ * się jak w planszy tablicowej. Wpp. wiersze zapisane komórkami zamienia się na odcinki
+ * i liczy odcinki następnej generacji, nie rozwijając ich do komórek. Obszar nowej
+ * generacji i, gdy odcisk jest znany, zmiany odcisku dolicza się wiersz po wierszu.
+ */
+static void nastepna_generacja_odcinkow(PlanszaOdcinkowa* po)
+{
+    Tablice* a = &po -> akt;
+    oproznij_tablice(&po -> nast);
+    ZmianyOdcisku zmiany;
+    ZmianyOdcisku* z = po -> odcisk_znany ? &zmiany : NULL;
+    zacznij_zmiany(&zmiany);
+    memset(&po -> obszar, 0, sizeof(Obszar));
+    int i = 0;
+    int y = a -> ile_w > 0 ? a -> w[0].wiersz - 1 : 0;
+    while (i < a -> ile_w) {
+        const int* kol[3] = {NULL, NULL, NULL};
+        int n[3] = {0, 0, 0};
+        char rodzaj[3] = {0, 0, 0};
+        int odcinkami = 0;
+        int j = i;
+        for (int d = 0; d < 3; d++) {
+            if (j < a -> ile_w && a -> w[j].wiersz == y - 1 + d) {
+                kol[d] = a -> kol + a -> w[j].od;
+                n[d] = a -> w[j].ile;
+                rodzaj[d] = po -> odcinkowe_akt[j];
+                odcinkami |= rodzaj[d];
+                j++;
+            }
+        }
+        int ile;
+        if (!odcinkami) {
+            po -> wynik = (int*) powieksz(po -> wynik, &po -> rozmiar_wyniku,
+                                          3 * (n[0] + n[1] + n[2]), sizeof(int));
+            ile = licz_wiersz_tablicy(kol[0], n[0], kol[1], n[1], kol[2], n[2], &po -> regula,
+                                      po -> wynik, z);
+        }
+        else {
+            for (int d = 0; d < 3; d++) {
+                if (n[d] > 0 && !rodzaj[d]) {
+                    po -> odcinki[d] = (int*) powieksz(po -> odcinki[d], &po -> rozmiar_odcinkow[d],
+                                                       2 * n[d], sizeof(int));
+                    n[d] = do_odcinkow(kol[d], n[d], po -> odcinki[d]);
+                    kol[d] = po -> odcinki[d];
+                }
+            }
+            po -> wynik = (int*) powieksz(po -> wynik, &po -> rozmiar_wyniku,
+                                          6 * (n[0] + n[1] + n[2]), sizeof(int));
+            ile = licz_wiersz_odcinkow(kol[0], n[0], kol[1], n[1], kol[2], n[2], &po -> regula,
+                                       po -> wynik, z);
+        }
+        if (z != NULL)
+            zamknij_wiersz_zmian(z, y);
+        dopisz_wiersz_odcinkow(&po -> nast, &po -> odcinkowe_nast, &po -> rozmiar_nast, y,
+                               po -> wynik, ile, odcinkami, &po -> obszar);
+        y++;
+        while (i < a -> ile_w && a -> w[i].wiersz < y - 1)
+            i++;
+        if (i < a -> ile_w && a -> w[i].wiersz - 1 > y)
+            y = a -> w[i].wiersz - 1;
+    }
+    Tablice pom = po -> akt;
+    po -> akt = po -> nast;
+    po -> nast = pom;
+    char* odcinkowe = po -> odcinkowe_akt;
+    po -> odcinkowe_akt = po -> odcinkowe_nast;
+    po -> odcinkowe_nast = odcinkowe;
+    int rozmiar = po -> rozmiar_akt;
+    po -> rozmiar_akt = po -> rozmiar_nast;
+    po -> rozmiar_nast = rozmiar;
+    po -> obszar_znany = 1;
+    if (z != NULL)
+        zakoncz_zmiany(&po -> odcisk, z, &po -> obszar);
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy silnika "odcinki" 's'
+ */
+static void krok_odcinkow(void* s, int n)
+{
+    for (int i = 0; i < n; i++)
+        nastepna_generacja_odcinkow((PlanszaOdcinkowa*) s);
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy silnika "odcinki" 's' na 'r'
+ */
+static void ustaw_regule_odcinkow(void* s, const Regula* r)
+{
+    ((PlanszaOdcinkowa*) s) -> regula = *r;
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy silnika "odcinki" 's'
+ * o numerach od 'od' do 'do_', obcięte do kolumn od 'kol_od' do 'kol_do'
+ *
+ * Wiersze zapisane odcinkami rozwija się do komórek
+ */
+static void przegladaj_odcinki(void* s, int od, int do_, int kol_od, int kol_do,
+                        OdbiorcaWiersza f, void* kontekst)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    Tablice* a = &po -> akt;
+    for (int i = szukaj_wiersza_tablicy(a, od); i < a -> ile_w && a -> w[i].wiersz <= do_; i++) {
+        const int* kol = a -> kol + a -> w[i].od;
+        int n = a -> w[i].ile;
+        if (po -> odcinkowe_akt[i]) {
+            int l = 0;
+            while (l < n && kol[l + 1] < kol_od)
+                l += 2;
+            po -> komorki = (int*) powieksz(po -> komorki, &po -> rozmiar_komorek,
+                                            dlugosc_odcinkow(kol + l, n - l), sizeof(int));
+            int ile = do_komorek(kol + l, n - l, kol_od, kol_do, po -> komorki);
+            if (ile > 0)
+                f(kontekst, a -> w[i].wiersz, po -> komorki, ile);
+        }
+        else {
+            int l = kol_od == INT_MIN ? 0 : szukaj_kolumny(kol, n, kol_od);
+            int p = kol_do == INT_MAX ? n : szukaj_kolumny(kol, n, kol_do + 1);
+            if (l < p)
+                f(kontekst, a -> w[i].wiersz, kol + l, p - l);
+        }
+    }
+}
+
+/**
+ * Zapisuje w 'o' odcisk aktualnej generacji planszy silnika "odcinki" 's'
+ *
+ * Gdy odcisk nie jest jeszcze znany, liczy go, przeglądając plansze, a potem kroki
+ * tylko go uaktualniają
+ */
+static void odcisk_odcinkow(void* s, Odcisk* o)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    if (!po -> odcisk_znany) {
+        memset(&po -> odcisk, 0, sizeof(Odcisk));
+        przegladaj_odcinki(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_do_odcisku, &po -> odcisk);
+        po -> odcisk_znany = 1;
+    }
+    *o = po -> odcisk;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek aktualnej generacji planszy
+ * silnika "odcinki" 's'
+ *
+ * Kroki liczą obszar przy okazji, więc plansze przegląda się tylko zaraz po wczytaniu
+ */
+static void obszar_odcinkow(void* s, Obszar* o)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    if (!po -> obszar_znany) {
+        memset(&po -> obszar, 0, sizeof(Obszar));
+        przegladaj_odcinki(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_obszar, &po -> obszar);
+        po -> obszar_znany = 1;
+    }
+    *o = po -> obszar;
+}
+
+/**
+ * Przesuwa wszystkie komórki planszy silnika "odcinki" 's' o 'dy' wierszy i 'dx' kolumn
+ *
+ * Końce odcinków to też kolumny, więc przesuwa się je jak kolumny komórek
+ */
+static void przesun_odcinki(void* s, int dy, int dx)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    przesun_tablice(&po -> akt, dy, dx);
+    przesun_obszar(&po -> obszar, dy, dx);
+    przesun_odcisk(&po -> odcisk, dy, dx);
+}
+
+/**
+ * Pisze do 'f' liczby wierszy planszy silnika "odcinki" 's' zapisanych odcinkami
+ * i komórkami oraz liczbę odcinków
+ */
+static void pisz_statystyki_odcinkow(void* s, FILE* f)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    int wiersze = 0;
+    long long odcinki = 0;
+    for (int i = 0; i < po -> akt.ile_w; i++) {
+        if (po -> odcinkowe_akt[i]) {
+            wiersze++;
+            odcinki += po -> akt.w[i].ile / 2;
+        }
+    }
+    fprintf(f, "odcinki: %d wierszy odcinkami (%lld odcinkow), %d komorkami\n",
+            wiersze, odcinki, po -> akt.ile_w - wiersze);
+}
+
+/**
+ * Usuwa plansze silnika "odcinki" 's'
+ */
+static void czysc_odcinki(void* s)
+{
+    PlanszaOdcinkowa* po = (PlanszaOdcinkowa*) s;
+    free(po -> akt.w);
+    free(po -> akt.kol);
+    free(po -> nast.w);
+    free(po -> nast.kol);
+    free(po -> odcinkowe_akt);
+    free(po -> odcinkowe_nast);
+    for (int d = 0; d < 3; d++)
+        free(po -> odcinki[d]);
+    free(po -> wynik);
+    free(po -> komorki);
+    free(po);
+}
+
+/**
+ * Słowa przetwarzane naraz przez licz_kafelek
+ *
+ * Z AVX2 liczy się naraz cztery wiersze kafelka, z SSE2 dwa, a bez nich jeden.
+ * 'W_LEWO' przesuwa bity w stronę wyższych kolumn, 'W_PRAWO' w stronę niższych.
+ * 'I_NIE(a, b)' to a & ~b, a 'JEDYNKI' to słowa z samymi jedynkami. 'DODAJ' dodaje
+ * słowa jako liczby 64-bitowe, a 'POWIEL(x)' to słowa równe 'x'.
+ */
+#if defined(__AVX2__)
+typedef __m256i Slowa;
+#define SLOWA_NARAZ 4
+#define LADUJ(p) _mm256_loadu_si256((const __m256i*) (p))
+#define ZAPISZ(p, a) _mm256_storeu_si256((__m256i*) (p), (a))
+#define I(a, b) _mm256_and_si256((a), (b))
+#define LUB(a, b) _mm256_or_si256((a), (b))
+#define XOR(a, b) _mm256_xor_si256((a), (b))
+#define I_NIE(a, b) _mm256_andnot_si256((b), (a))
+#define W_LEWO(a, n) _mm256_slli_epi64((a), (n))
+#define W_PRAWO(a, n) _mm256_srli_epi64((a), (n))
+#define JEDYNKI _mm256_set1_epi64x(-1)
+#define DODAJ(a, b) _mm256_add_epi64((a), (b))
+#define POWIEL(x) _mm256_set1_epi64x((long long) (x))
+#elif defined(__SSE2__)
+typedef __m128i Slowa;
+#define SLOWA_NARAZ 2
+#define LADUJ(p) _mm_loadu_si128((const __m128i*) (p))
+#define ZAPISZ(p, a) _mm_storeu_si128((__m128i*) (p), (a))
+#define I(a, b) _mm_and_si128((a), (b))
+#define LUB(a, b) _mm_or_si128((a), (b))
+#define XOR(a, b) _mm_xor_si128((a), (b))
+#define I_NIE(a, b) _mm_andnot_si128((b), (a))
+#define W_LEWO(a, n) _mm_slli_epi64((a), (n))
+#define W_PRAWO(a, n) _mm_srli_epi64((a), (n))
+#define JEDYNKI _mm_set1_epi64x(-1)
+#define DODAJ(a, b) _mm_add_epi64((a), (b))
+#define POWIEL(x) _mm_set1_epi64x((long long) (x))
+#else
+typedef uint64_t Slowa;
+#define SLOWA_NARAZ 1
+#define LADUJ(p) (*(p))
+#define ZAPISZ(p, a) (*(p) = (a))
+#define I(a, b) ((a) & (b))
+#define LUB(a, b) ((a) | (b))
+#define XOR(a, b) ((a) ^ (b))
+#define I_NIE(a, b) ((a) & ~(b))
+#define W_LEWO(a, n) ((a) << (n))
+#define W_PRAWO(a, n) ((a) >> (n))
+#define JEDYNKI (~0ULL)
+#define DODAJ(a, b) ((a) + (b))
+#define POWIEL(x) ((uint64_t) (x))
+#endif
+
+/**
+ * Reprezentuje kafelek 64 x 64 komórek planszy kafelkowej
+ *
+ * Bit j słowa 'w'[i] to komórka w wierszu 64 * 'ty' + i i kolumnie 64 * 'tx' + j.
+ *
+ * 'ty', 'tx' - współrzędne kafelka
+ * 'nast' - następny kafelek w kubełku mapy lub na liście wolnych kafelków
+ * 'w' - wiersze kafelka
+ */
+typedef struct Kafelek_
+{
+    int ty;
+    int tx;
+    struct Kafelek_* nast;
+    uint64_t w[64];
+} Kafelek;
+
+/**
+ * Reprezentuje zbiór kafelków jednej generacji
+ *
+ * 'kubelki' - tablica haszująca kafelków, łańcuchy przez pole 'nast'
+ * 'ile_kubelkow' - liczba kubełków, potęga dwójki
+ * 'lista' - wszystkie kafelki zbioru
+ * 'ile' - liczba kafelków
+ * 'rozmiar_listy' - pojemność listy
+ */
+typedef struct MapaKafelkow_
+{
+    Kafelek** kubelki;
+    int ile_kubelkow;
+    Kafelek** lista;
+    int ile;
+    int rozmiar_listy;
+} MapaKafelkow;
+
+/**
+ * Reprezentuje plansze kafelkową
+ *
+ * 'akt' - aktualna generacja
+ * 'nast' - miejsce na następną generację, zamieniane z 'akt' po każdym kroku
+ * 'wolne' - lista kafelków do ponownego użycia
+ * 'posortowane' - kafelki aktualnej generacji w kolejności wierszy, potem kolumn
+ * 'ile_posortowanych' - liczba posortowanych kafelków, -1 gdy trzeba posortować od nowa
+ * 'rozmiar_posortowanych' - pojemność tablicy 'posortowane'
+ * 'bufor' - kolumny żywych komórek wiersza przekazywanego odbiorcy
+ * 'rozmiar_bufora' - pojemność bufora
+ * 'regula' - reguła liczenia generacji
+ * 'odcisk' - odcisk aktualnej generacji, uaktualniany w krokach
+ * 'odcisk_znany' - 1, gdy 'odcisk' jest aktualny
+ * 'potegi' - potęgi podstaw haszu do uaktualniania odcisku lub NULL, zanim odcisk
+ *            był potrzebny
+ * 'obszar' - obszar aktualnej generacji, liczony w krokach
+ * 'obszar_znany' - 1, gdy 'obszar' jest aktualny
+ */
+typedef struct PlanszaKafelkowa_
+{
+    MapaKafelkow akt;
+    MapaKafelkow nast;
+    Kafelek* wolne;
+    Kafelek** posortowane;
+    int ile_posortowanych;
+    int rozmiar_posortowanych;
+    int* bufor;
+    int rozmiar_bufora;
+    Regula regula;
+    Odcisk odcisk;
+    int odcisk_znany;
+    struct PotegiKafelka_* potegi;
+    Obszar obszar;
+    int obszar_znany;
+} PlanszaKafelkowa;
+
+/**
+ * Zwraca numer kafelka, w którym leży wiersz lub kolumna 'x'
+ */
+static int numer_kafelka(int x)
+{
+    return x >= 0 ? x / 64 : -1 - (-1 - x) / 64;
+}
+
+/**
+ * Zwraca numer kubełka kafelka o współrzędnych 'ty', 'tx' w mapie z 'ile_kubelkow' kubełkami
+ */
+static int kubelek_kafelka(int ty, int tx, int ile_kubelkow)
+{
+    uint64_t h = (uint64_t) (uint32_t) ty * 0x9E3779B97F4A7C15ULL ^ (uint64_t) (uint32_t) tx;
+    h *= 0xC2B2AE3D27D4EB4FULL;
+    return (int) (h >> 32) & (ile_kubelkow - 1);
+}
+
+/**
+ * Zwraca kafelek mapy 'm' o współrzędnych 'ty', 'tx' lub NULL, gdy go nie ma
+ */
+static Kafelek* szukaj_kafelka(const MapaKafelkow* m, int ty, int tx)
+{
+    if (m -> ile_kubelkow == 0)
+        return NULL;
+    Kafelek* t = m -> kubelki[kubelek_kafelka(ty, tx, m -> ile_kubelkow)];
+    while (t != NULL && (t -> ty != ty || t -> tx != tx))
+        t = t -> nast;
+    return t;
+}
+
+/**
+ * Wpisuje kafelek 't' do kubełków mapy 'm'
+ */
+static void wpisz_do_kubelka(MapaKafelkow* m, Kafelek* t)
+{
+    int h = kubelek_kafelka(t -> ty, t -> tx, m -> ile_kubelkow);
+    t -> nast = m -> kubelki[h];
+    m -> kubelki[h] = t;
+}
+
+/**
+ * Wypełnia od nowa kubełki mapy 'm' kafelkami z jej listy,
+ * tak żeby kubełków było co najmniej tyle co kafelków
+ */
+static void przebuduj_kubelki(MapaKafelkow* m)
+{
+    int nowe = m -> ile_kubelkow > 0 ? m -> ile_kubelkow : 64;
+    while (nowe < m -> ile)
+        nowe *= 2;
+    if (nowe != m -> ile_kubelkow) {
+        free(m -> kubelki);
+        m -> kubelki = (Kafelek**) malloc ((size_t) nowe * sizeof(Kafelek*));
+        m -> ile_kubelkow = nowe;
+    }
+    memset(m -> kubelki, 0, (size_t) m -> ile_kubelkow * sizeof(Kafelek*));
+    for (int i = 0; i < m -> ile; i++)
+        wpisz_do_kubelka(m, m -> lista[i]);
+}
+
+/**
+ * Tworzy pusty kafelek 'ty', 'tx' w mapie 'm' planszy 'pk' i zwraca jego adres
+ */
+static Kafelek* dodaj_kafelek(PlanszaKafelkowa* pk, MapaKafelkow* m, int ty, int tx)
+{
+    Kafelek* t = pk -> wolne;
+    if (t != NULL)
+        pk -> wolne = t -> nast;
+    else
+        t = (Kafelek*) malloc (sizeof(Kafelek));
+    t -> ty = ty;
+    t -> tx = tx;
+    memset(t -> w, 0, sizeof(t -> w));
+    m -> lista = (Kafelek**) powieksz(m -> lista, &m -> rozmiar_listy, m -> ile + 1, sizeof(Kafelek*));
+    m -> lista[m -> ile++] = t;
+    if (m -> ile > m -> ile_kubelkow)
+        przebuduj_kubelki(m);
+    else
+        wpisz_do_kubelka(m, t);
+    return t;
+}
+
+/**
+ * Oddaje wszystkie kafelki mapy 'm' na listę wolnych kafelków planszy 'pk'
+ */
+static void oproznij_mape(PlanszaKafelkowa* pk, MapaKafelkow* m)
+{
+    for (int i = 0; i < m -> ile; i++) {
+        m -> lista[i] -> nast = pk -> wolne;
+        pk -> wolne = m -> lista[i];
+    }
+    m -> ile = 0;
+    if (m -> ile_kubelkow > 0)
+        memset(m -> kubelki, 0, (size_t) m -> ile_kubelkow * sizeof(Kafelek*));
+}
+
+/**
+ * Tworzy pustą plansze kafelkową o ustawieniach 'u'
+ */
+static void* tworz_kafelki(const Ustawienia* u)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) calloc (1, sizeof(PlanszaKafelkowa));
+    pk -> ile_posortowanych = -1;
+    pk -> regula = u -> regula;
+    return pk;
+}
+
+/**
+ * Dodaje do planszy kafelkowej 's' wiersz 'wiersz' z 'n' żywymi komórkami w kolumnach 'kol'
+ */
+static void dodaj_wiersz_kafelkow(void* s, int wiersz, const int* kol, int n)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    int ty = numer_kafelka(wiersz);
+    Kafelek* t = NULL;
+    for (int i = 0; i < n; i++) {
+        int tx = numer_kafelka(kol[i]);
+        if (t == NULL || t -> tx != tx) {
+            t = szukaj_kafelka(&pk -> akt, ty, tx);
+            if (t == NULL)
+                t = dodaj_kafelek(pk, &pk -> akt, ty, tx);
+        }
+        t -> w[wiersz - 64 * ty] |= 1ULL << (kol[i] - 64 * tx);
+    }
+    pk -> ile_posortowanych = -1;
+    pk -> odcisk_znany = 0;
+    pk -> obszar_znany = 0;
+}
+
+/**
+ * Wymusza wstawienie funkcji w miejsce wywołania, żeby stałe argumenty
+ * dawały osobną, uproszczoną wersję funkcji
+ */
+#if defined(__GNUC__)
+#define WSTAWIAJ __attribute__((always_inline))
+#else
+#define WSTAWIAJ
+#endif
+
+/**
+ * Zwraca stan w następnej generacji komórek 's' według reguły o maskach 'narodziny'
+ * i 'przetrwanie' (zob. Regula), gdy b0..b3 to kolejne bity liczb ich sąsiadów
+ *
+ * Składa komórki o każdej liczbie sąsiadów występującej w maskach. Wywołana ze stałymi
+ * maskami zwija się do samych potrzebnych wyrażeń, a dla "Game of Life" do wyrażenia
+ * bez rozpisywania liczb sąsiadów.
+ */
+static inline WSTAWIAJ Slowa stosuj_regule(Slowa b0, Slowa b1, Slowa b2, Slowa b3, Slowa s,
+                                  int narodziny, int przetrwanie)
+{
+    if (narodziny == NARODZINY_CONWAYA && przetrwanie == PRZETRWANIE_CONWAYA)
+        return I_NIE(I_NIE(I(b1, LUB(b0, s)), b2), b3);
+    Slowa b[4] = {b0, b1, b2, b3};
+    Slowa wynik = XOR(s, s);
+    for (int n = 0; n <= 8; n++) {
+        int ur = (narodziny >> n) & 1;
+        int pr = (przetrwanie >> n) & 1;
+        if (!ur && !pr)
+            continue;
+        Slowa rowne = JEDYNKI;
+        for (int i = 0; i < 4; i++)
+            rowne = (n >> i) & 1 ? I(rowne, b[i]) : I_NIE(rowne, b[i]);
+        if (!ur)
+            rowne = I(rowne, s);
+        else if (!pr)
+            rowne = I_NIE(rowne, s);
+        wynik = LUB(wynik, rowne);
+    }
+    return wynik;
+}
+
+/**
+ * Zapisuje w 'wynik' 64 wiersze kafelka w następnej generacji według reguły
+ * o maskach 'narodziny' i 'przetrwanie'
+ *
+ * 'srodek'[i + 1] to wiersz i kafelka, dla i od -1 do 64 (wiersze -1 i 64 pochodzą
+ * z kafelków nad i pod nim), 'zach'[i + 1] i 'wsch'[i + 1] to ten sam wiersz
+ * kafelków po lewej i po prawej stronie.
+ *
+ * Liczby sąsiadów wszystkich komórek wiersza liczy się naraz sumatorami
+ * bitowymi: bity b0..b3 to kolejne bity liczby sąsiadów.
+ */
+static inline WSTAWIAJ void licz_kafelek_reguly(const uint64_t* srodek, const uint64_t* zach,
+                                                const uint64_t* wsch, uint64_t* wynik,
+                                                int narodziny, int przetrwanie)
+{
+    for (int i = 0; i < 64; i += SLOWA_NARAZ) {
+        Slowa g = LADUJ(srodek + i);
+        Slowa s = LADUJ(srodek + i + 1);
+        Slowa d = LADUJ(srodek + i + 2);
+        Slowa gl = LUB(W_LEWO(g, 1), W_PRAWO(LADUJ(zach + i), 63));
+        Slowa gp = LUB(W_PRAWO(g, 1), W_LEWO(LADUJ(wsch + i), 63));
+        Slowa sl = LUB(W_LEWO(s, 1), W_PRAWO(LADUJ(zach + i + 1), 63));
+        Slowa sp = LUB(W_PRAWO(s, 1), W_LEWO(LADUJ(wsch + i + 1), 63));
+        Slowa dl = LUB(W_LEWO(d, 1), W_PRAWO(LADUJ(zach + i + 2), 63));
+        Slowa dp = LUB(W_PRAWO(d, 1), W_LEWO(LADUJ(wsch + i + 2), 63));
+        Slowa x = XOR(gl, g);
+        Slowa s0 = XOR(x, gp);
+        Slowa c0 = LUB(I(gl, g), I(gp, x));
+        x = XOR(dl, d);
+        Slowa s2 = XOR(x, dp);
+        Slowa c2 = LUB(I(dl, d), I(dp, x));
+        Slowa s1 = XOR(sl, sp);
+        Slowa c1 = I(sl, sp);
+        x = XOR(s0, s1);
+        Slowa b0 = XOR(x, s2);
+        Slowa t = LUB(I(s0, s1), I(s2, x));
+        x = XOR(c0, c1);
+        Slowa u = XOR(x, c2);
+        Slowa v = LUB(I(c0, c1), I(c2, x));
+        Slowa b1 = XOR(u, t);
+        Slowa p = I(u, t);
+        Slowa b2 = XOR(v, p);
+        Slowa b3 = I(v, p);
+        ZAPISZ(wynik + i, stosuj_regule(b0, b1, b2, b3, s, narodziny, przetrwanie));
+    }
+}
+
+/**
+ * Maski reguł HighLife B36/S23, Day & Night B3678/S34678 i Seeds B2/S
+ */
+#define NARODZINY_HIGHLIFE ((1 << 3) | (1 << 6))
+#define NARODZINY_DAY_NIGHT ((1 << 3) | (1 << 6) | (1 << 7) | (1 << 8))
+#define PRZETRWANIE_DAY_NIGHT ((1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8))
+#define NARODZINY_SEEDS (1 << 2)
+
+/**
+ * Zapisuje w 'wynik' 64 wiersze kafelka w następnej generacji według reguły 'r'
+ * (zob. licz_kafelek_reguly)
+ *
+ * Dla reguł "Game of Life", HighLife, Day & Night i Seeds liczy osobną wersją
+ * ze stałymi maskami, dla pozostałych wersją sprawdzającą maski w trakcie.
+ */
+static void licz_kafelek(const uint64_t* srodek, const uint64_t* zach, const uint64_t* wsch,
+                  const Regula* r, uint64_t* wynik)
+{
+    int b = r -> narodziny;
+    int p = r -> przetrwanie;
+    if (b == NARODZINY_CONWAYA && p == PRZETRWANIE_CONWAYA)
+        licz_kafelek_reguly(srodek, zach, wsch, wynik, NARODZINY_CONWAYA, PRZETRWANIE_CONWAYA);
+    else if (b == NARODZINY_HIGHLIFE && p == PRZETRWANIE_CONWAYA)
+        licz_kafelek_reguly(srodek, zach, wsch, wynik, NARODZINY_HIGHLIFE, PRZETRWANIE_CONWAYA);
+    else if (b == NARODZINY_DAY_NIGHT && p == PRZETRWANIE_DAY_NIGHT)
+        licz_kafelek_reguly(srodek, zach, wsch, wynik, NARODZINY_DAY_NIGHT, PRZETRWANIE_DAY_NIGHT);
+    else if (b == NARODZINY_SEEDS && p == 0)
+        licz_kafelek_reguly(srodek, zach, wsch, wynik, NARODZINY_SEEDS, 0);
+    else
+        licz_kafelek_reguly(srodek, zach, wsch, wynik, b, p);
+}
+
+/**
+ * Kopiuje do 'cel'[1..64] wiersze kafelka 't' lub zera, gdy 't' jest NULL,
+ * a do 'cel'[0] i 'cel'[65] wiersz 63 kafelka 'g' i wiersz 0 kafelka 'd'
+ */
+static void kopiuj_wiersze(uint64_t* cel, const Kafelek* g, const Kafelek* t, const Kafelek* d)
+{
+    cel[0] = g != NULL ? g -> w[63] : 0;
+    if (t != NULL)
+        memcpy(cel + 1, t -> w, sizeof(t -> w));
+    else
+        memset(cel + 1, 0, sizeof(t -> w));
+    cel[65] = d != NULL ? d -> w[0] : 0;
+}
+
+/**
+ * Liczy kafelek 'ty', 'tx' następnej generacji planszy 'pk', o ile jeszcze nie był liczony
+ */
+static void licz_kafelek_planszy(PlanszaKafelkowa* pk, int ty, int tx)
+{
+    if (szukaj_kafelka(&pk -> nast, ty, tx) != NULL)
+        return;
+    uint64_t srodek[66];
+    uint64_t zach[66];
+    uint64_t wsch[66];
+    const MapaKafelkow* a = &pk -> akt;
+    kopiuj_wiersze(srodek, szukaj_kafelka(a, ty - 1, tx), szukaj_kafelka(a, ty, tx),
+                   szukaj_kafelka(a, ty + 1, tx));
+    kopiuj_wiersze(zach, szukaj_kafelka(a, ty - 1, tx - 1), szukaj_kafelka(a, ty, tx - 1),
+                   szukaj_kafelka(a, ty + 1, tx - 1));
+    kopiuj_wiersze(wsch, szukaj_kafelka(a, ty - 1, tx + 1), szukaj_kafelka(a, ty, tx + 1),
+                   szukaj_kafelka(a, ty + 1, tx + 1));
+    Kafelek* t = dodaj_kafelek(pk, &pk -> nast, ty, tx);
+    licz_kafelek(srodek, zach, wsch, &pk -> regula, t -> w);
+}
+
+/**
+ * Zwraca liczbę żywych komórek kafelka 't' i zapisuje w '*suma' alternatywę bitową
+ * jego wierszy
+ *
+ * Bez instrukcji POPCNT wbudowane liczenie bitów woła funkcję biblioteczną, więc
+ * bity sumuje się w bajtach słów po SLOWA_NARAZ wierszy naraz. Bajt zlicza najwyżej
+ * 8 bitów na wiersz, więc sumy bajtów składa się co 16 wierszy, zanim się przepełnią.
+ */
+static long long licz_komorki_kafelka(const Kafelek* t, uint64_t* suma)
+{
+    const Slowa m1 = POWIEL(0x5555555555555555ULL);
+    const Slowa m2 = POWIEL(0x3333333333333333ULL);
+    const Slowa m4 = POWIEL(0x0F0F0F0F0F0F0F0FULL);
+    Slowa lub = XOR(m1, m1);
+    long long wynik = 0;
+    for (int i = 0; i < 64; i += 16) {
+        Slowa bajty = XOR(m1, m1);
+        for (int j = i; j < i + 16; j += SLOWA_NARAZ) {
+            Slowa x = LADUJ(t -> w + j);
+            lub = LUB(lub, x);
+            x = DODAJ(I(x, m1), I(W_PRAWO(x, 1), m1));
+            x = DODAJ(I(x, m2), I(W_PRAWO(x, 2), m2));
+            bajty = DODAJ(bajty, I(DODAJ(x, W_PRAWO(x, 4)), m4));
+        }
+        uint64_t b[SLOWA_NARAZ];
+        ZAPISZ(b, bajty);
+        for (int k = 0; k < SLOWA_NARAZ; k++) {
+            uint64_t x = (b[k] & 0x00FF00FF00FF00FFULL) + ((b[k] >> 8) & 0x00FF00FF00FF00FFULL);
+            wynik += (long long) ((x * 0x0001000100010001ULL) >> 48);
+        }
+    }
+    uint64_t b[SLOWA_NARAZ];
+    ZAPISZ(b, lub);
+    *suma = 0;
+    for (int k = 0; k < SLOWA_NARAZ; k++)
+        *suma |= b[k];
+    return wynik;
+}
+
+/**
+ * Dolicza do obszaru 'o' niepusty kafelek 't' z 'populacja' żywymi komórkami,
+ * którego wiersze złożone alternatywą bitową dają 'suma'
+ *
+ * Kafelki przychodzą w dowolnej kolejności, więc w odróżnieniu od
+ * dolicz_wiersz_do_obszaru porównuje się wszystkie brzegi prostokąta
+ */
+static void dolicz_kafelek_do_obszaru(Obszar* o, const Kafelek* t, uint64_t suma, long long populacja)
+{
+    int g = 0;
+    while (t -> w[g] == 0)
+        g++;
+    int d = 63;
+    while (t -> w[d] == 0)
+        d--;
+    int w_min = 64 * t -> ty + g;
+    int w_max = 64 * t -> ty + d;
+    int k_min = 64 * t -> tx + __builtin_ctzll(suma);
+    int k_max = 64 * t -> tx + 63 - __builtin_clzll(suma);
+    if (o -> populacja == 0) {
+        o -> w_min = w_min;
+        o -> w_max = w_max;
+        o -> k_min = k_min;
+        o -> k_max = k_max;
+    }
+    o -> w_min = w_min < o -> w_min ? w_min : o -> w_min;
+    o -> w_max = w_max > o -> w_max ? w_max : o -> w_max;
+    o -> k_min = k_min < o -> k_min ? k_min : o -> k_min;
+    o -> k_max = k_max > o -> k_max ? k_max : o -> k_max;
+    o -> populacja += populacja;
+}
+
+/**
+ * Reprezentuje potęgi podstaw haszu dla wierszy i kolumn wewnątrz kafelka
+ *
+ * 'a' - A ^ j dla j = 0..63
+ * 'b' - b[k][v] to suma B ^ (8 * k + i) po zapalonych bitach i bajtu v, więc hasz
+ *       słowa wiersza kafelka to suma ośmiu wpisów
+ */
+typedef struct PotegiKafelka_
+{
+    uint64_t a[64];
+    uint64_t b[8][256];
+} PotegiKafelka;
+
+/**
+ * Tworzy potęgi podstaw haszu dla kafelków
+ */
+static PotegiKafelka* tworz_potegi_kafelka(void)
+{
+    PotegiKafelka* p = (PotegiKafelka*) malloc (sizeof(PotegiKafelka));
+    uint64_t b = 1;
+    p -> a[0] = 1;
+    for (int i = 1; i < 64; i++)
+        p -> a[i] = mnoz_mod(p -> a[i - 1], PODSTAWA_WIERSZY);
+    for (int k = 0; k < 8; k++) {
+        p -> b[k][0] = 0;
+        for (int i = 0; i < 8; i++) {
+            for (int v = 1 << i; v < 2 << i; v++) {
+                p -> b[k][v] = p -> b[k][v - (1 << i)] + b;
+                if (p -> b[k][v] >= MODUL_HASZU)
+                    p -> b[k][v] -= MODUL_HASZU;
+            }
+            b = mnoz_mod(b, PODSTAWA_KOLUMN);
+        }
+    }
+    return p;
+}
+
+/**
+ * Zwraca sumę B ^ i po bitach i, które są zapalone w słowie 'nowe', a zgaszone
+ * w 'stare', minus sumę po bitach zgaszonych w 'nowe', a zapalonych w 'stare'
+ *
+ * Przegląda się tylko bajty, w których słowa się różnią.
+ */
+static inline uint64_t roznica_slow(const PotegiKafelka* p, uint64_t nowe, uint64_t stare)
+{
+    uint64_t roznica = 0;
+    for (uint64_t x = nowe ^ stare; x != 0; ) {
+        int k = __builtin_ctzll(x) >> 3;
+        roznica += p -> b[k][(nowe >> (8 * k)) & 255] + MODUL_HASZU - p -> b[k][(stare >> (8 * k)) & 255];
+        roznica = (roznica & MODUL_HASZU) + (roznica >> 61);
+        x &= ~(255ULL << (8 * k));
+    }
+    return roznica >= MODUL_HASZU ? roznica - MODUL_HASZU : roznica;
+}
+
+/**
+ * Dolicza do zmian 'z' komórki kafelka 't', które różnią się od komórek kafelka 'stary'
+ * poprzedniej generacji o tych samych współrzędnych lub NULL, gdy takiego nie ma
+ *
+ * Zmiany kafelka sumuje się względem jego rogu potęgami 'p' i dopiero sumę przenosi
+ * do rogu kafelka, więc zmieniony bajt wiersza kosztuje dwa odczyty tablicy.
+ */
+static void dolicz_zmiany_kafelka(ZmianyOdcisku* z, const Kafelek* t, const Kafelek* stary,
+                           const PotegiKafelka* p)
+{
+    uint64_t suma = 0;
+    for (int j = 0; j < 64; j++) {
+        uint64_t w = stary != NULL ? stary -> w[j] : 0;
+        if (t -> w[j] == w)
+            continue;
+        suma += mnoz_mod(p -> a[j], roznica_slow(p, t -> w[j], w));
+        if (suma >= MODUL_HASZU)
+            suma -= MODUL_HASZU;
+    }
+    if (suma == 0)
+        return;
+    uint64_t rog = mnoz_mod(potega_mod(PODSTAWA_WIERSZY, 64LL * t -> ty),
+                            potega_mod(PODSTAWA_KOLUMN, 64LL * t -> tx));
+    z -> hasz = (z -> hasz + mnoz_mod(rog, suma)) % MODUL_HASZU;
+}
+
+/**
+ * Oblicza następną generację planszy kafelkowej 'pk'
+ *
+ * Liczy każdy niepusty kafelek oraz tych jego sąsiadów, do których sięgają
+ * żywe komórki z brzegu kafelka. Puste kafelki wynikowe są odrzucane, a niepuste
+ * doliczane do obszaru nowej generacji. Każdy niepusty kafelek aktualnej generacji
+ * ma wynikowy odpowiednik, więc gdy odcisk jest znany, zmiany odcisku to różnice
+ * wynikowych kafelków i ich odpowiedników.
+ */
+static void nastepna_generacja_kafelkow(PlanszaKafelkowa* pk)
+{
+    MapaKafelkow* a = &pk -> akt;
+    MapaKafelkow* b = &pk -> nast;
+    for (int i = 0; i < a -> ile; i++) {
+        Kafelek* t = a -> lista[i];
+        uint64_t suma = 0;
+        for (int j = 0; j < 64; j++)
+            suma |= t -> w[j];
+        int brzeg_w[3] = {t -> w[0] != 0, 1, t -> w[63] != 0};
+        int brzeg_k[3] = {(suma & 1) != 0, 1, (suma >> 63) != 0};
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                if (brzeg_w[dy + 1] && brzeg_k[dx + 1])
+                    licz_kafelek_planszy(pk, t -> ty + dy, t -> tx + dx);
+    }
+    int ile = 0;
+    ZmianyOdcisku z;
+    zacznij_zmiany(&z);
+    memset(&pk -> obszar, 0, sizeof(Obszar));
+    for (int i = 0; i < b -> ile; i++) {
+        Kafelek* t = b -> lista[i];
+        if (pk -> odcisk_znany)
+            dolicz_zmiany_kafelka(&z, t, szukaj_kafelka(a, t -> ty, t -> tx), pk -> potegi);
+        uint64_t suma;
+        long long populacja = licz_komorki_kafelka(t, &suma);
+        if (suma != 0) {
+            b -> lista[ile++] = t;
+            dolicz_kafelek_do_obszaru(&pk -> obszar, t, suma, populacja);
+        }
+        else {
+            t -> nast = pk -> wolne;
+            pk -> wolne = t;
+        }
+    }
+    b -> ile = ile;
+    przebuduj_kubelki(b);
+    oproznij_mape(pk, a);
+    MapaKafelkow pom = pk -> akt;
+    pk -> akt = pk -> nast;
+    pk -> nast = pom;
+    pk -> ile_posortowanych = -1;
+    pk -> obszar_znany = 1;
+    if (pk -> odcisk_znany)
+        zakoncz_zmiany(&pk -> odcisk, &z, &pk -> obszar);
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy kafelkowej 's'
+ */
+static void krok_kafelkow(void* s, int n)
+{
+    for (int i = 0; i < n; i++)
+        nastepna_generacja_kafelkow((PlanszaKafelkowa*) s);
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy kafelkowej 's' na 'r'
+ */
+static void ustaw_regule_kafelkow(void* s, const Regula* r)
+{
+    ((PlanszaKafelkowa*) s) -> regula = *r;
+}
+
+/**
+ * Porównuje kafelki '*a' i '*b' najpierw według wiersza, potem kolumny
+ */
+static int porownaj_kafelki(const void* a, const void* b)
+{
+    const Kafelek* t1 = *(const Kafelek* const*) a;
+    const Kafelek* t2 = *(const Kafelek* const*) b;
+    if (t1 -> ty != t2 -> ty)
+        return t1 -> ty < t2 -> ty ? -1 : 1;
+    if (t1 -> tx != t2 -> tx)
+        return t1 -> tx < t2 -> tx ? -1 : 1;
+    return 0;
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy kafelkowej 's'
+ * o numerach od 'od' do 'do_'
+ */
+static void przegladaj_kafelki(void* s, int od, int do_, int kol_od, int kol_do,
+                        OdbiorcaWiersza f, void* kontekst)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    if (pk -> ile_posortowanych < 0) {
+        pk -> posortowane = (Kafelek**) powieksz(pk -> posortowane, &pk -> rozmiar_posortowanych,
+                                                 pk -> akt.ile, sizeof(Kafelek*));
+        pk -> ile_posortowanych = pk -> akt.ile;
+        if (pk -> akt.ile > 0) {
+            memcpy(pk -> posortowane, pk -> akt.lista, (size_t) pk -> akt.ile * sizeof(Kafelek*));
+            qsort(pk -> posortowane, (size_t) pk -> ile_posortowanych, sizeof(Kafelek*), porownaj_kafelki);
+        }
+    }
+    Kafelek** t = pk -> posortowane;
+    int n = pk -> ile_posortowanych;
+    int ty_od = numer_kafelka(od);
+    int ty_do = numer_kafelka(do_);
+    int tx_od = numer_kafelka(kol_od);
+    int tx_do = numer_kafelka(kol_do);
+    int l = 0;
+    int p = n;
+    while (l < p) {
+        int m = l + (p - l) / 2;
+        if (t[m] -> ty < ty_od)
+            l = m + 1;
+        else
+            p = m;
+    }
+    int i = l;
+    while (i < n && t[i] -> ty <= ty_do) {
+        int koniec = i;
+        while (koniec < n && t[koniec] -> ty == t[i] -> ty)
+            koniec++;
+        int poczatek = i;
+        while (poczatek < koniec && t[poczatek] -> tx < tx_od)
+            poczatek++;
+        int j = poczatek;
+        while (j < koniec && t[j] -> tx <= tx_do)
+            j++;
+        pk -> bufor = (int*) powieksz(pk -> bufor, &pk -> rozmiar_bufora, 64 * (j - poczatek) + 1,
+                                      sizeof(int));
+        for (int y = 0; y < 64 && j > poczatek; y++) {
+            long long wiersz = 64LL * t[i] -> ty + y;
+            if (wiersz < od || wiersz > do_)
+                continue;
+            int ile = 0;
+            for (int k = poczatek; k < j; k++) {
+                uint64_t x = t[k] -> w[y];
+                long long x0 = 64LL * t[k] -> tx;
+                if (kol_od > x0)
+                    x &= ~0ULL << (kol_od - x0);
+                if (kol_do < x0 + 63)
+                    x &= ~0ULL >> (x0 + 63 - kol_do);
+                while (x != 0) {
+                    pk -> bufor[ile++] = (int) (x0 + __builtin_ctzll(x));
+                    x &= x - 1;
+                }
+            }
+            if (ile > 0)
+                f(kontekst, (int) wiersz, pk -> bufor, ile);
+        }
+        i = koniec;
+    }
+}
+
+/**
+ * Usuwa kafelki mapy 'm' z listy wolnych kafelków planszy 'pk' oraz samą mapę
+ */
+static void czysc_mape(PlanszaKafelkowa* pk, MapaKafelkow* m)
+{
+    oproznij_mape(pk, m);
+    free(m -> kubelki);
+    free(m -> lista);
+}
+
+/**
+ * Zapisuje w 'o' odcisk aktualnej generacji planszy kafelkowej 's'
+ *
+ * Gdy odcisk nie jest jeszcze znany, liczy go, przeglądając plansze, a potem kroki
+ * tylko go uaktualniają
+ */
+static void odcisk_kafelkow(void* s, Odcisk* o)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    if (!pk -> odcisk_znany) {
+        memset(&pk -> odcisk, 0, sizeof(Odcisk));
+        przegladaj_kafelki(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_do_odcisku, &pk -> odcisk);
+        pk -> odcisk_znany = 1;
+        if (pk -> potegi == NULL)
+            pk -> potegi = tworz_potegi_kafelka();
+    }
+    *o = pk -> odcisk;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek aktualnej generacji planszy
+ * kafelkowej 's'
+ *
+ * Kroki liczą obszar przy okazji, więc plansze przegląda się tylko zaraz po wczytaniu
+ */
+static void obszar_kafelkow(void* s, Obszar* o)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    if (!pk -> obszar_znany) {
+        memset(&pk -> obszar, 0, sizeof(Obszar));
+        przegladaj_kafelki(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_obszar, &pk -> obszar);
+        pk -> obszar_znany = 1;
+    }
+    *o = pk -> obszar;
+}
+
+/**
+ * Przesuwa wszystkie komórki planszy kafelkowej 's' o 'dy' wierszy i 'dx' kolumn
+ *
+ * Przesunięcie zwykle nie jest wielokrotnością boku kafelka, więc komórki zbiera się
+ * do tablic i wstawia od nowa
+ */
+static void przesun_kafelki(void* s, int dy, int dx)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    Tablice a;
+    memset(&a, 0, sizeof(a));
+    przegladaj_kafelki(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dopisz_do_tablic, &a);
+    przesun_tablice(&a, dy, dx);
+    oproznij_mape(pk, &pk -> akt);
+    int obszar_znany = pk -> obszar_znany;
+    int odcisk_znany = pk -> odcisk_znany;
+    for (int i = 0; i < a.ile_w; i++)
+        dodaj_wiersz_kafelkow(s, a.w[i].wiersz, a.kol + a.w[i].od, a.w[i].ile);
+    pk -> obszar_znany = obszar_znany;
+    pk -> odcisk_znany = odcisk_znany;
+    przesun_obszar(&pk -> obszar, dy, dx);
+    przesun_odcisk(&pk -> odcisk, dy, dx);
+    free(a.w);
+    free(a.kol);
+}
+
+/**
+ * Pisze do 'f' liczbę kafelków planszy kafelkowej 's'
+ */
+static void pisz_statystyki_kafelkow(void* s, FILE* f)
+{
+    fprintf(f, "kafelki: %d\n", ((PlanszaKafelkowa*) s) -> akt.ile);
+}
+
+/**
+ * Usuwa plansze kafelkową 's'
+ */
+static void czysc_kafelki(void* s)
+{
+    PlanszaKafelkowa* pk = (PlanszaKafelkowa*) s;
+    czysc_mape(pk, &pk -> akt);
+    czysc_mape(pk, &pk -> nast);
+    while (pk -> wolne != NULL) {
+        Kafelek* t = pk -> wolne -> nast;
+        free(pk -> wolne);
+        pk -> wolne = t;
+    }
+    free(pk -> posortowane);
+    free(pk -> bufor);
+    free(pk -> potegi);
+    free(pk);
+}
+
+/**
+ * Liczba węzłów drzewa HashLife, po przekroczeniu której przed kolejnym krokiem
+ * usuwa się węzły nieosiągalne z korzenia i zapamiętane wyniki
+ */
+#ifndef LIMIT_KWADRATOW
+#define LIMIT_KWADRATOW (1 << 21)
+#endif
+
+/**
+ * Reprezentuje węzeł drzewa czwórkowego HashLife: kwadrat 2^'poziom' x 2^'poziom' komórek
+ *
+ * Węzły są jednoznaczne: dwa kwadraty o tej samej zawartości to ten sam węzeł.
+ *
+ * 'lg', 'pg', 'ld', 'pd' - ćwiartki: lewa górna, prawa górna, lewa dolna, prawa dolna,
+ *                          NULL dla pojedynczej komórki (poziom 0)
+ * 'wynik' - zapamiętany środek kwadratu po 2^'krok_wyniku' generacjach lub NULL
+ * 'nast' - następny węzeł w kubełku
+ * 'populacja' - liczba żywych komórek
+ * 'hasz' - hasz żywych komórek kwadratu z lewym górnym rogiem w (0, 0)
+ *          (zob. PODSTAWA_WIERSZY)
+ * 'poziom' - logarytm boku kwadratu
+ * 'krok_wyniku' - logarytm liczby generacji, po których obliczono 'wynik'
+ * 'znacznik' - 1, gdy węzeł jest osiągalny podczas odśmiecania
+ */
+typedef struct Kwadrat_
+{
+    struct Kwadrat_* lg;
+    struct Kwadrat_* pg;
+    struct Kwadrat_* ld;
+    struct Kwadrat_* pd;
+    struct Kwadrat_* wynik;
+    struct Kwadrat_* nast;
+    long long populacja;
+    uint64_t hasz;
+    short poziom;
+    short krok_wyniku;
+    int znacznik;
+} Kwadrat;
+
+/**
+ * Reprezentuje plansze HashLife
+ *
+ * 'kubelki' - tablica haszująca wszystkich węzłów poziomu co najmniej 1
+ * 'ile_kubelkow' - liczba kubełków, potęga dwójki
+ * 'ile' - liczba węzłów w tablicy
+ * 'martwy', 'zywy' - dwa węzły poziomu 0
+ * 'puste' - pusty kwadrat każdego poziomu, NULL gdy jeszcze nie powstał
+ * 'korzen' - cała plansza
+ * 'poprzedni' - korzeń sprzed próbnego skoku, chroniony przed odśmiecaniem, lub NULL
+ * 'y0', 'x0' - wiersz i kolumna lewego górnego rogu korzenia
+ * 'wczytane' - pary (wiersz, kolumna) komórek dodanych przed przygotowaniem
+ * 'ile_wczytanych' - liczba liczb w 'wczytane'
+ * 'rozmiar_wczytanych' - pojemność 'wczytane'
+ * 'bufor' - kolumny żywych komórek wiersza przekazywanego odbiorcy
+ * 'rozmiar_bufora' - pojemność bufora
+ * 'regula' - reguła liczenia generacji
+ * 'obszar' - obszar aktualnej generacji, liczony na żądanie
+ * 'obszar_znany' - 1, gdy 'obszar' jest aktualny
+ * 'potegi_w', 'potegi_k' - A^(2^i) i B^(2^i) dla haszy kwadratów poziomu i + 1
+ */
+typedef struct Hashlife_
+{
+    Kwadrat** kubelki;
+    long long ile_kubelkow;
+    long long ile;
+    Kwadrat martwy;
+    Kwadrat zywy;
+    Kwadrat* puste[64];
+    Kwadrat* korzen;
+    Kwadrat* poprzedni;
+    long long y0;
+    long long x0;
+    long long* wczytane;
+    int ile_wczytanych;
+    int rozmiar_wczytanych;
+    int* bufor;
+    int rozmiar_bufora;
+    Regula regula;
+    Obszar obszar;
+    int obszar_znany;
+    uint64_t potegi_w[64];
+    uint64_t potegi_k[64];
+} Hashlife;
+
+/**
+ * Zwraca numer kubełka dla węzła o ćwiartkach 'lg', 'pg', 'ld', 'pd'
+ * w tablicy z 'ile_kubelkow' kubełkami
+ */
+static long long kubelek_kwadratu(const Kwadrat* lg, const Kwadrat* pg, const Kwadrat* ld,
+                           const Kwadrat* pd, long long ile_kubelkow)
+{
+    uint64_t h = (uint64_t) (uintptr_t) lg;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint64_t) (uintptr_t) pg;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint64_t) (uintptr_t) ld;
+    h = h * 0x9E3779B97F4A7C15ULL + (uint64_t) (uintptr_t) pd;
+    h ^= h >> 29;
+    return (long long) (h & (uint64_t) (ile_kubelkow - 1));
+}
+
+/**
+ * Podwaja liczbę kubełków planszy 'h'
+ */
+static void powieksz_kubelki(Hashlife* h)
+{
+    long long nowe = h -> ile_kubelkow * 2;
+    Kwadrat** k = (Kwadrat**) calloc ((size_t) nowe, sizeof(Kwadrat*));
+    for (long long i = 0; i < h -> ile_kubelkow; i++) {
+        Kwadrat* q = h -> kubelki[i];
+        while (q != NULL) {
+            Kwadrat* q2 = q -> nast;
+            long long b = kubelek_kwadratu(q -> lg, q -> pg, q -> ld, q -> pd, nowe);
+            q -> nast = k[b];
+            k[b] = q;
+            q = q2;
+        }
+    }
+    free(h -> kubelki);
+    h -> kubelki = k;
+    h -> ile_kubelkow = nowe;
+}
+
+/**
+ * Zwraca jedyny węzeł planszy 'h' o ćwiartkach 'lg', 'pg', 'ld', 'pd',
+ * tworząc go, gdy jeszcze nie istnieje
+ */
+static Kwadrat* kwadrat(Hashlife* h, Kwadrat* lg, Kwadrat* pg, Kwadrat* ld, Kwadrat* pd)
+{
+    long long b = kubelek_kwadratu(lg, pg, ld, pd, h -> ile_kubelkow);
+    for (Kwadrat* q = h -> kubelki[b]; q != NULL; q = q -> nast)
+        if (q -> lg == lg && q -> pg == pg && q -> ld == ld && q -> pd == pd)
+            return q;
+    Kwadrat* q = (Kwadrat*) malloc (sizeof(Kwadrat));
+    q -> lg = lg;
+    q -> pg = pg;
+    q -> ld = ld;
+    q -> pd = pd;
+    q -> wynik = NULL;
+    q -> populacja = lg -> populacja + pg -> populacja + ld -> populacja + pd -> populacja;
+    q -> hasz = 0;
+    if (q -> populacja > 0) {
+        // ćwiartki prawe są przesunięte o pół boku w kolumnach, dolne w wierszach
+        uint64_t a = h -> potegi_w[lg -> poziom];
+        uint64_t b = h -> potegi_k[lg -> poziom];
+        uint64_t gora = lg -> hasz + mnoz_mod(b, pg -> hasz);
+        uint64_t dol = ld -> hasz + mnoz_mod(b, pd -> hasz);
+        q -> hasz = (gora % MODUL_HASZU + mnoz_mod(a, dol % MODUL_HASZU)) % MODUL_HASZU;
+    }
+    q -> poziom = (short) (lg -> poziom + 1);
+    q -> krok_wyniku = -1;
+    q -> znacznik = 0;
+    q -> nast = h -> kubelki[b];
+    h -> kubelki[b] = q;
+    h -> ile++;
+    if (h -> ile > h -> ile_kubelkow)
+        powieksz_kubelki(h);
+    return q;
+}
+
+/**
+ * Zwraca pusty kwadrat poziomu 'poziom' planszy 'h'
+ */
+static Kwadrat* pusty_kwadrat(Hashlife* h, int poziom)
+{
+    if (poziom == 0)
+        return &h -> martwy;
+    if (h -> puste[poziom] == NULL) {
+        Kwadrat* e = pusty_kwadrat(h, poziom - 1);
+        h -> puste[poziom] = kwadrat(h, e, e, e, e);
+    }
+    return h -> puste[poziom];
+}
+
+/**
+ * Zwraca środkowy kwadrat poziomu o jeden niższego kwadratu 'q'
+ *
+ * 'q' ma poziom co najmniej 2
+ */
+static Kwadrat* srodek_kwadratu(Hashlife* h, Kwadrat* q)
+{
+    return kwadrat(h, q -> lg -> pd, q -> pg -> ld, q -> ld -> pg, q -> pd -> lg);
+}
+
+/**
+ * Zwraca kwadrat leżący na styku kwadratów 'l' i 'p' położonych obok siebie
+ */
+static Kwadrat* srodek_poziomy(Hashlife* h, Kwadrat* l, Kwadrat* p)
+{
+    return kwadrat(h, l -> pg, p -> lg, l -> pd, p -> ld);
+}
+
+/**
+ * Zwraca kwadrat leżący na styku kwadratów 'g' i 'd' położonych jeden nad drugim
+ */
+static Kwadrat* srodek_pionowy(Hashlife* h, Kwadrat* g, Kwadrat* d)
+{
+    return kwadrat(h, g -> ld, g -> pd, d -> lg, d -> pg);
+}
+
+/**
+ * Zwraca środek 2 x 2 kwadratu 'q' poziomu 2 po jednej generacji według reguły planszy 'h'
+ */
+static Kwadrat* krok_podstawowy(Hashlife* h, Kwadrat* q)
+{
+    Kwadrat* c[4] = {q -> lg, q -> pg, q -> ld, q -> pd};
+    int b[4][4];
+    for (int i = 0; i < 4; i++) {
+        int y = (i / 2) * 2;
+        int x = (i % 2) * 2;
+        b[y][x] = (int) c[i] -> lg -> populacja;
+        b[y][x + 1] = (int) c[i] -> pg -> populacja;
+        b[y + 1][x] = (int) c[i] -> ld -> populacja;
+        b[y + 1][x + 1] = (int) c[i] -> pd -> populacja;
+    }
+    Kwadrat* w[4];
+    for (int i = 0; i < 4; i++) {
+        int y = 1 + i / 2;
+        int x = 1 + i % 2;
+        int sasiedzi = 0;
+        for (int dy = -1; dy <= 1; dy++)
+            for (int dx = -1; dx <= 1; dx++)
+                if (dy != 0 || dx != 0)
+                    sasiedzi += b[y + dy][x + dx];
+        w[i] = nowy_stan(&h -> regula, b[y][x], sasiedzi) ? &h -> zywy : &h -> martwy;
+    }
+    return kwadrat(h, w[0], w[1], w[2], w[3]);
+}
+
+/**
+ * Zwraca środek kwadratu 'q' po 2^'j' generacjach
+ *
+ * 'q' ma poziom co najmniej 2, a 'j' nie przekracza poziomu 'q' pomniejszonego o 2.
+ * Wynik jest zapamiętywany w 'q' i używany ponownie dla tego samego 'j'.
+ */
+static Kwadrat* wynik_kwadratu(Hashlife* h, Kwadrat* q, int j)
+{
+    assert(q -> poziom >= 2 && j <= q -> poziom - 2);
+    if (q -> populacja == 0)
+        return pusty_kwadrat(h, q -> poziom - 1);
+    if (q -> wynik != NULL && q -> krok_wyniku == j)
+        return q -> wynik;
+    Kwadrat* w;
+    if (q -> poziom == 2)
+        w = krok_podstawowy(h, q);
+    else {
+        Kwadrat* n[9] = {
+            q -> lg, srodek_poziomy(h, q -> lg, q -> pg), q -> pg,
+            srodek_pionowy(h, q -> lg, q -> ld), srodek_kwadratu(h, q), srodek_pionowy(h, q -> pg, q -> pd),
+            q -> ld, srodek_poziomy(h, q -> ld, q -> pd), q -> pd
+        };
+        int pelny = j == q -> poziom - 2;
+        for (int i = 0; i < 9; i++)
+            n[i] = pelny ? wynik_kwadratu(h, n[i], j - 1) : srodek_kwadratu(h, n[i]);
+        int j2 = pelny ? j - 1 : j;
+        w = kwadrat(h,
+                    wynik_kwadratu(h, kwadrat(h, n[0], n[1], n[3], n[4]), j2),
+                    wynik_kwadratu(h, kwadrat(h, n[1], n[2], n[4], n[5]), j2),
+                    wynik_kwadratu(h, kwadrat(h, n[3], n[4], n[6], n[7]), j2),
+                    wynik_kwadratu(h, kwadrat(h, n[4], n[5], n[7], n[8]), j2));
+    }
+    q -> wynik = w;
+    q -> krok_wyniku = (short) j;
+    return w;
+}
+
+/**
+ * Otacza korzeń planszy 'h' pustym pasem, podwajając bok planszy
+ */
+static void rozszerz_korzen(Hashlife* h)
+{
+    Kwadrat* r = h -> korzen;
+    Kwadrat* e = pusty_kwadrat(h, r -> poziom - 1);
+    h -> korzen = kwadrat(h, kwadrat(h, e, e, e, r -> lg), kwadrat(h, e, e, r -> pg, e),
+                          kwadrat(h, e, r -> ld, e, e), kwadrat(h, r -> pd, e, e, e));
+    long long pol = 1LL << (r -> poziom - 1);
+    h -> y0 -= pol;
+    h -> x0 -= pol;
+}
+
+/**
+ * Sprawdza, czy wszystkie żywe komórki kwadratu 'q' leżą w jego środkowym kwadracie
+ *
+ * 'q' ma poziom co najmniej 2
+ */
+static int czy_w_srodku(const Kwadrat* q)
+{
+    return q -> lg -> populacja == q -> lg -> pd -> populacja &&
+           q -> pg -> populacja == q -> pg -> ld -> populacja &&
+           q -> ld -> populacja == q -> ld -> pg -> populacja &&
+           q -> pd -> populacja == q -> pd -> lg -> populacja;
+}
+
+/**
+ * Zaznacza węzeł 'q' i wszystkie jego ćwiartki jako osiągalne
+ */
+static void zaznacz_kwadrat(Kwadrat* q)
+{
+    if (q -> poziom == 0 || q -> znacznik)
+        return;
+    q -> znacznik = 1;
+    zaznacz_kwadrat(q -> lg);
+    zaznacz_kwadrat(q -> pg);
+    zaznacz_kwadrat(q -> ld);
+    zaznacz_kwadrat(q -> pd);
+}
+
+/**
+ * Usuwa z planszy 'h' węzły nieosiągalne z korzenia i pustych kwadratów
+ *
+ * Zapamiętane wyniki zostają tylko, gdy wskazują na węzeł, który przetrwał
+ */
+static void odsmiecaj(Hashlife* h)
+{
+    zaznacz_kwadrat(h -> korzen);
+    if (h -> poprzedni != NULL)
+        zaznacz_kwadrat(h -> poprzedni);
+    for (int i = 1; i < 64; i++)
+        if (h -> puste[i] != NULL)
+            zaznacz_kwadrat(h -> puste[i]);
+    for (long long i = 0; i < h -> ile_kubelkow; i++)
+        for (Kwadrat* q = h -> kubelki[i]; q != NULL; q = q -> nast)
+            if (q -> znacznik && q -> wynik != NULL && q -> wynik -> poziom > 0 &&
+                !q -> wynik -> znacznik)
+                q -> wynik = NULL;
+    for (long long i = 0; i < h -> ile_kubelkow; i++) {
+        Kwadrat** q = &h -> kubelki[i];
+        while (*q != NULL) {
+            if ((*q) -> znacznik) {
+                (*q) -> znacznik = 0;
+                q = &(*q) -> nast;
+            }
+            else {
+                Kwadrat* q2 = (*q) -> nast;
+                free(*q);
+                *q = q2;
+                h -> ile--;
+            }
+        }
+    }
+}
+
+/**
+ * Tworzy pustą plansze HashLife o ustawieniach 'u'
+ */
+static void* tworz_hashlife(const Ustawienia* u)
+{
+    Hashlife* h = (Hashlife*) calloc (1, sizeof(Hashlife));
+    h -> regula = u -> regula;
+    h -> ile_kubelkow = 1024;
+    h -> kubelki = (Kwadrat**) calloc ((size_t) h -> ile_kubelkow, sizeof(Kwadrat*));
+    h -> martwy.populacja = 0;
+    h -> zywy.populacja = 1;
+    h -> martwy.krok_wyniku = -1;
+    h -> zywy.krok_wyniku = -1;
+    h -> zywy.hasz = 1;
+    h -> potegi_w[0] = PODSTAWA_WIERSZY;
+    h -> potegi_k[0] = PODSTAWA_KOLUMN;
+    for (int i = 1; i < 64; i++) {
+        h -> potegi_w[i] = mnoz_mod(h -> potegi_w[i - 1], h -> potegi_w[i - 1]);
+        h -> potegi_k[i] = mnoz_mod(h -> potegi_k[i - 1], h -> potegi_k[i - 1]);
+    }
+    return h;
+}
+
+/**
+ * Zapamiętuje do zbudowania drzewa wiersz 'wiersz' z 'n' żywymi komórkami w kolumnach 'kol'
+ */
+static void dodaj_wiersz_hashlife(void* s, int wiersz, const int* kol, int n)
+{
+    Hashlife* h = (Hashlife*) s;
+    h -> wczytane = (long long*) powieksz(h -> wczytane, &h -> rozmiar_wczytanych,
+                                          h -> ile_wczytanych + 2 * n, sizeof(long long));
+    for (int i = 0; i < n; i++) {
+        h -> wczytane[h -> ile_wczytanych++] = wiersz;
+        h -> wczytane[h -> ile_wczytanych++] = kol[i];
+    }
+}
+
+/**
+ * Zwraca kwadrat poziomu 'poziom' o lewym górnym rogu 'y0', 'x0' z 'n' żywymi
+ * komórkami, których współrzędne to kolejne pary liczb w 'wsp'
+ *
+ * Kolejność par w 'wsp' ulega zmianie
+ */
+static Kwadrat* buduj_kwadrat(Hashlife* h, int poziom, long long y0, long long x0, long long* wsp, int n)
+{
+    if (n == 0)
+        return pusty_kwadrat(h, poziom);
+    if (poziom == 0)
+        return &h -> zywy;
+    long long pol = 1LL << (poziom - 1);
+    int granice[5] = {0, 0, 0, 0, n};
+    int i = 0;
+    for (int c = 0; c < 3; c++) {
+        for (int j = i; j < n; j++) {
+            int cw = (wsp[2 * j] >= y0 + pol) * 2 + (wsp[2 * j + 1] >= x0 + pol);
+            if (cw == c) {
+                long long t0 = wsp[2 * i];
+                long long t1 = wsp[2 * i + 1];
+                wsp[2 * i] = wsp[2 * j];
+                wsp[2 * i + 1] = wsp[2 * j + 1];
+                wsp[2 * j] = t0;
+                wsp[2 * j + 1] = t1;
+                i++;
+            }
+        }
+        granice[c + 1] = i;
+    }
+    Kwadrat* c[4];
+    for (int k = 0; k < 4; k++)
+        c[k] = buduj_kwadrat(h, poziom - 1, y0 + (k / 2) * pol, x0 + (k % 2) * pol,
+                             wsp + 2 * granice[k], granice[k + 1] - granice[k]);
+    return kwadrat(h, c[0], c[1], c[2], c[3]);
+}
+
+/**
+ * Buduje drzewo planszy 'h' z zapamiętanych komórek
+ */
+static void przygotuj_hashlife(void* s)
+{
+    Hashlife* h = (Hashlife*) s;
+    long long min_y = 0;
+    long long min_x = 0;
+    long long bok = 1;
+    int n = h -> ile_wczytanych / 2;
+    if (n > 0) {
+        long long max_y = h -> wczytane[0];
+        long long max_x = h -> wczytane[1];
+        min_y = max_y;
+        min_x = max_x;
+        for (int i = 0; i < n; i++) {
+            long long y = h -> wczytane[2 * i];
+            long long x = h -> wczytane[2 * i + 1];
+            min_y = y < min_y ? y : min_y;
+            max_y = y > max_y ? y : max_y;
+            min_x = x < min_x ? x : min_x;
+            max_x = x > max_x ? x : max_x;
+        }
+        bok = max_y - min_y > max_x - min_x ? max_y - min_y + 1 : max_x - min_x + 1;
+    }
+    int poziom = 3;
+    while ((1LL << poziom) < bok)
+        poziom++;
+    h -> y0 = min_y;
+    h -> x0 = min_x;
+    h -> korzen = buduj_kwadrat(h, poziom, min_y, min_x, h -> wczytane, n);
+    free(h -> wczytane);
+    h -> wczytane = NULL;
+    h -> ile_wczytanych = 0;
+    h -> rozmiar_wczytanych = 0;
+    h -> obszar_znany = 0;
+}
+
+/**
+ * Oblicza 2^'j' kolejnych generacji planszy HashLife 'h'
+ */
+static void skok_hashlife(Hashlife* h, int j)
+{
+    while (h -> korzen -> poziom < j + 3 || !czy_w_srodku(h -> korzen))
+        rozszerz_korzen(h);
+    rozszerz_korzen(h);
+    long long cwierc = 1LL << (h -> korzen -> poziom - 2);
+    h -> korzen = wynik_kwadratu(h, h -> korzen, j);
+    h -> y0 += cwierc;
+    h -> x0 += cwierc;
+    while (h -> korzen -> poziom > 3 && czy_w_srodku(h -> korzen)) {
+        cwierc = 1LL << (h -> korzen -> poziom - 2);
+        h -> korzen = srodek_kwadratu(h, h -> korzen);
+        h -> y0 += cwierc;
+        h -> x0 += cwierc;
+    }
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy HashLife 's'
+ *
+ * 'n' rozkłada się na potęgi dwójki, a każdą z nich oblicza się jednym skokiem
+ */
+static void krok_hashlife(void* s, int n)
+{
+    Hashlife* h = (Hashlife*) s;
+    for (int j = 0; j < 31 && (n >> j) != 0; j++) {
+        if (((n >> j) & 1) == 0)
+            continue;
+        if (h -> ile > LIMIT_KWADRATOW)
+            odsmiecaj(h);
+        skok_hashlife(h, j);
+    }
+    h -> obszar_znany = 0;
+}
+
+/**
+ * Zmienia regułę liczenia generacji planszy HashLife 's' na 'r'
+ *
+ * Zapamiętane wyniki kwadratów liczono starą regułą, więc się je zapomina
+ */
+static void ustaw_regule_hashlife(void* s, const Regula* r)
+{
+    Hashlife* h = (Hashlife*) s;
+    if (h -> regula.narodziny == r -> narodziny && h -> regula.przetrwanie == r -> przetrwanie)
+        return;
+    h -> regula = *r;
+    for (long long i = 0; i < h -> ile_kubelkow; i++)
+        for (Kwadrat* q = h -> kubelki[i]; q != NULL; q = q -> nast)
+            q -> wynik = NULL;
+}
+
+/**
+ * Zwraca najmniejszy numer wiersza nie mniejszy niż 'od', w którym kwadrat 'q'
+ * o lewym górnym rogu 'y0', 'x0' ma żywą komórkę w kolumnach od 'kol_od' do 'kol_do',
+ * lub LLONG_MAX, gdy nie ma takiego
+ */
+static long long nastepny_wiersz_kwadratu(const Kwadrat* q, long long y0, long long x0, long long od,
+                                   long long kol_od, long long kol_do)
+{
+    long long bok = 1LL << q -> poziom;
+    if (q -> populacja == 0 || od >= y0 + bok || kol_do < x0 || kol_od >= x0 + bok)
+        return LLONG_MAX;
+    if (q -> poziom == 0)
+        return y0;
+    long long pol = bok / 2;
+    long long a = nastepny_wiersz_kwadratu(q -> lg, y0, x0, od, kol_od, kol_do);
+    long long b = nastepny_wiersz_kwadratu(q -> pg, y0, x0 + pol, od, kol_od, kol_do);
+    if (a != LLONG_MAX || b != LLONG_MAX)
+        return a < b ? a : b;
+    a = nastepny_wiersz_kwadratu(q -> ld, y0 + pol, x0, od, kol_od, kol_do);
+    b = nastepny_wiersz_kwadratu(q -> pd, y0 + pol, x0 + pol, od, kol_od, kol_do);
+    return a < b ? a : b;
+}
+
+/**
+ * Dopisuje do bufora planszy 'h' rosnąco kolumny od 'kol_od' do 'kol_do' żywych komórek
+ * wiersza 'wiersz' kwadratu 'q' o lewym górnym rogu 'y0', 'x0'
+ *
+ * '*n' to liczba kolumn w buforze, jest uaktualniana
+ */
+static void zbierz_wiersz_kwadratu(Hashlife* h, const Kwadrat* q, long long y0, long long x0,
+                            long long wiersz, long long kol_od, long long kol_do, int* n)
+{
+    long long bok = 1LL << q -> poziom;
+    if (q -> populacja == 0 || kol_do < x0 || kol_od >= x0 + bok)
+        return;
+    if (q -> poziom == 0) {
+        h -> bufor = (int*) powieksz(h -> bufor, &h -> rozmiar_bufora, *n + 1, sizeof(int));
+        h -> bufor[(*n)++] = (int) x0;
+        return;
+    }
+    long long pol = bok / 2;
+    if (wiersz < y0 + pol) {
+        zbierz_wiersz_kwadratu(h, q -> lg, y0, x0, wiersz, kol_od, kol_do, n);
+        zbierz_wiersz_kwadratu(h, q -> pg, y0, x0 + pol, wiersz, kol_od, kol_do, n);
+    }
+    else {
+        zbierz_wiersz_kwadratu(h, q -> ld, y0 + pol, x0, wiersz, kol_od, kol_do, n);
+        zbierz_wiersz_kwadratu(h, q -> pd, y0 + pol, x0 + pol, wiersz, kol_od, kol_do, n);
+    }
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy HashLife 's'
+ * o numerach od 'od' do 'do_', ograniczone do kolumn od 'kol_od' do 'kol_do'
+ */
+static void przegladaj_hashlife(void* s, int od, int do_, int kol_od, int kol_do,
+                         OdbiorcaWiersza f, void* kontekst)
+{
+    Hashlife* h = (Hashlife*) s;
+    long long wiersz = nastepny_wiersz_kwadratu(h -> korzen, h -> y0, h -> x0, od, kol_od, kol_do);
+    while (wiersz <= do_) {
+        int n = 0;
+        zbierz_wiersz_kwadratu(h, h -> korzen, h -> y0, h -> x0, wiersz, kol_od, kol_do, &n);
+        f(kontekst, (int) wiersz, h -> bufor, n);
+        wiersz = nastepny_wiersz_kwadratu(h -> korzen, h -> y0, h -> x0, wiersz + 1, kol_od, kol_do);
+    }
+}
+
+/**
+ * Zwraca odległość najbliższej żywej komórki niepustego kwadratu 'q' od jego boku
+ * 'bok': 0 - górnego, 1 - dolnego, 2 - lewego, 3 - prawego
+ *
+ * Schodzi do ćwiartek przy tym boku, a do dwóch pozostałych tylko, gdy tamte są puste,
+ * więc odwiedza węzły przy brzegu żywych komórek, a nie całe drzewo
+ */
+static long long odleglosc_od_boku(const Kwadrat* q, int bok)
+{
+    if (q -> poziom == 0)
+        return 0;
+    const Kwadrat* c[4] = {q -> lg, q -> pg, q -> ld, q -> pd};
+    const int blizsze[4][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}};
+    const int dalsze[4][2] = {{2, 3}, {0, 1}, {1, 3}, {0, 2}};
+    long long wynik = LLONG_MAX;
+    for (int i = 0; i < 2 && wynik > 0; i++) {
+        const Kwadrat* x = c[blizsze[bok][i]];
+        if (x -> populacja > 0) {
+            long long d = odleglosc_od_boku(x, bok);
+            wynik = d < wynik ? d : wynik;
+        }
+    }
+    if (wynik != LLONG_MAX)
+        return wynik;
+    for (int i = 0; i < 2 && wynik > 0; i++) {
+        const Kwadrat* x = c[dalsze[bok][i]];
+        if (x -> populacja > 0) {
+            long long d = odleglosc_od_boku(x, bok);
+            wynik = d < wynik ? d : wynik;
+        }
+    }
+    return (1LL << (q -> poziom - 1)) + wynik;
+}
+
+/**
+ * Zapisuje w 'p' pierwszy i ostatni wiersz oraz pierwszą i ostatnią kolumnę żywych
+ * komórek planszy HashLife 'h', same zera dla pustej
+ *
+ * Współrzędne mogą wychodzić poza zakres int, np. w trakcie skok_daleki_hashlife
+ */
+static void prostokat_hashlife(const Hashlife* h, long long p[4])
+{
+    const Kwadrat* q = h -> korzen;
+    long long bok = 1LL << q -> poziom;
+    if (q -> populacja == 0) {
+        p[0] = p[1] = p[2] = p[3] = 0;
+        return;
+    }
+    p[0] = h -> y0 + odleglosc_od_boku(q, 0);
+    p[1] = h -> y0 + bok - 1 - odleglosc_od_boku(q, 1);
+    p[2] = h -> x0 + odleglosc_od_boku(q, 2);
+    p[3] = h -> x0 + bok - 1 - odleglosc_od_boku(q, 3);
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek aktualnej generacji planszy
+ * HashLife 's'
+ *
+ * Populację zna korzeń, a boki prostokąta znajduje się, schodząc wzdłuż brzegów
+ * żywych komórek (zob. odleglosc_od_boku), co najwyżej raz na krok
+ */
+static void obszar_hashlife(void* s, Obszar* o)
+{
+    Hashlife* h = (Hashlife*) s;
+    if (!h -> obszar_znany) {
+        long long p[4];
+        prostokat_hashlife(h, p);
+        memset(&h -> obszar, 0, sizeof(Obszar));
+        h -> obszar.populacja = h -> korzen -> populacja;
+        if (h -> korzen -> populacja > 0) {
+            h -> obszar.w_min = (int) p[0];
+            h -> obszar.w_max = (int) p[1];
+            h -> obszar.k_min = (int) p[2];
+            h -> obszar.k_max = (int) p[3];
+        }
+        h -> obszar_znany = 1;
+    }
+    *o = h -> obszar;
+}
+
+/**
+ * Przesuwa wszystkie komórki planszy HashLife 's' o 'dy' wierszy i 'dx' kolumn
+ */
+static void przesun_hashlife(void* s, int dy, int dx)
+{
+    Hashlife* h = (Hashlife*) s;
+    h -> y0 += dy;
+    h -> x0 += dx;
+    przesun_obszar(&h -> obszar, dy, dx);
+}
+
+/**
+ * Zapisuje w 'o' odcisk aktualnej generacji planszy HashLife 's'
+ *
+ * Węzły znają hasz swoich komórek względem lewego górnego rogu, więc wystarczy
+ * przesunąć hasz korzenia do jego rogu
+ */
+static void odcisk_hashlife(void* s, Odcisk* o)
+{
+    Hashlife* h = (Hashlife*) s;
+    Obszar ob;
+    obszar_hashlife(s, &ob);
+    o -> hasz = mnoz_mod(h -> korzen -> hasz, mnoz_mod(potega_mod(PODSTAWA_WIERSZY, h -> y0),
+                                                     potega_mod(PODSTAWA_KOLUMN, h -> x0)));
+    o -> populacja = ob.populacja;
+    o -> wiersz = ob.w_min;
+    o -> kol = ob.k_min;
+}
+
+/**
+ * Logarytm najdłuższego pojedynczego skoku skok_daleki_hashlife i największy poziom
+ * korzenia, od którego zaczyna się skok, tak żeby boki i współrzędne drzewa
+ * mieściły się w long long, a puste kwadraty w tablicy 'puste'
+ */
+#define NAJDLUZSZY_SKOK 50
+#define NAJWYZSZY_KORZEN 58
+
+/**
+ * Zastępuje korzeń planszy HashLife 'h' najmniejszym kwadratem, który zawiera jego
+ * żywe komórki i leży w nim w odległości od rogu będącej wielokrotnością ćwierci boku
+ *
+ * Po skoku żywe komórki nie muszą leżeć w środkowym kwadracie korzenia, więc
+ * skok_hashlife nie zawsze zmniejsza drzewo, a podczas długiego lotu statku korzeń
+ * rósłby do rozmiaru całej trasy. Prostokąt o boku krótszym niż ćwierć boku mieści się
+ * w którymś z dziewięciu kwadratów o połowę mniejszych, zaczynających się co ćwierć boku.
+ */
+static void przytnij_korzen(Hashlife* h)
+{
+    for (;;) {
+        Kwadrat* q = h -> korzen;
+        long long p[4];
+        prostokat_hashlife(h, p);
+        long long cwierc = 1LL << (q -> poziom - 2);
+        if (q -> poziom <= 3 || q -> populacja == 0 || p[1] - p[0] >= cwierc || p[3] - p[2] >= cwierc)
+            return;
+        long long a = (p[0] - h -> y0) / cwierc;
+        long long b = (p[2] - h -> x0) / cwierc;
+        a = a < 2 ? a : 2;
+        b = b < 2 ? b : 2;
+        Kwadrat* c[4] = {q -> lg, q -> pg, q -> ld, q -> pd};
+        Kwadrat* w[4][4];
+        for (int y = 0; y < 4; y++)
+            for (int x = 0; x < 4; x++) {
+                Kwadrat* r = c[(y / 2) * 2 + x / 2];
+                Kwadrat* d[4] = {r -> lg, r -> pg, r -> ld, r -> pd};
+                w[y][x] = d[(y % 2) * 2 + x % 2];
+            }
+        h -> korzen = kwadrat(h, w[a][b], w[a][b + 1], w[a + 1][b], w[a + 1][b + 1]);
+        h -> y0 += a * cwierc;
+        h -> x0 += b * cwierc;
+    }
+}
+
+/**
+ * Próbuje obliczyć 'n' kolejnych generacji planszy HashLife 's' naraz, także ponad
+ * zakres int
+ *
+ * Gdy prostokąt żywych komórek po 'n' generacjach i po każdym pojedynczym skoku drzewa
+ * po drodze ma boki nie dłuższe niż 'rozpietosc', przesuwa plansze tak, żeby środek
+ * prostokąta był w (0, 0), zapisuje przesunięcie komórek w '*dy', '*dx' i zwraca 1.
+ * Gdy 'zapisz' jest 0, potem przywraca plansze sprzed skoku. Gdy prostokąt jest
+ * większy lub drzewo za wysokie, przywraca plansze i zwraca 0.
+ * Drzewo jest niezmienne, więc przywrócenie to powrót do starego korzenia, a zapamiętane
+ * wyniki kwadratów zostają, więc powtórzenie próby z zapisem prawie nic nie kosztuje.
+ */
+static int skok_daleki_hashlife(void* s, long long n, long long rozpietosc,
+                                long long* dy, long long* dx, int zapisz)
+{
+    Hashlife* h = (Hashlife*) s;
+    Kwadrat* korzen = h -> korzen;
+    long long y0 = h -> y0;
+    long long x0 = h -> x0;
+    int wynik = 1;
+    long long p[4];
+    h -> poprzedni = korzen;
+    for (int j = 0; j < 63 && (n >> j) != 0 && wynik; j++) {
+        if (((n >> j) & 1) == 0)
+            continue;
+        int k = j < NAJDLUZSZY_SKOK ? j : NAJDLUZSZY_SKOK;
+        for (long long i = 0; i < 1LL << (j - k) && wynik; i++) {
+            if (h -> korzen -> poziom > NAJWYZSZY_KORZEN) {
+                wynik = 0;
+                break;
+            }
+            if (h -> ile > LIMIT_KWADRATOW)
+                odsmiecaj(h);
+            skok_hashlife(h, k);
+            przytnij_korzen(h);
+            // za duży prostokąt pośredniej generacji kończy próbę, zanim drzewo urośnie
+            prostokat_hashlife(h, p);
+            if (p[1] - p[0] > rozpietosc || p[3] - p[2] > rozpietosc)
+                wynik = 0;
+        }
+    }
+    h -> poprzedni = NULL;
+    prostokat_hashlife(h, p);
+    if (wynik) {
+        *dy = -(p[0] + (p[1] - p[0]) / 2);
+        *dx = -(p[2] + (p[3] - p[2]) / 2);
+    }
+    if (!wynik || !zapisz) {
+        h -> korzen = korzen;
+        h -> y0 = y0;
+        h -> x0 = x0;
+    }
+    else {
+        h -> y0 += *dy;
+        h -> x0 += *dx;
+    }
+    h -> obszar_znany = 0;
+    return wynik;
+}
+
+/**
+ * Pisze do 'f' liczbę węzłów planszy HashLife 's' i poziom korzenia
+ */
+static void pisz_statystyki_hashlife(void* s, FILE* f)
+{
+    Hashlife* h = (Hashlife*) s;
+    fprintf(f, "hashlife: %lld wezlow, poziom korzenia %d\n", h -> ile, h -> korzen -> poziom);
+}
+
+/**
+ * Usuwa plansze HashLife 's'
+ */
+static void czysc_hashlife(void* s)
+{
+    Hashlife* h = (Hashlife*) s;
+    for (long long i = 0; i < h -> ile_kubelkow; i++) {
+        Kwadrat* q = h -> kubelki[i];
+        while (q != NULL) {
+            Kwadrat* q2 = q -> nast;
+            free(q);
+            q = q2;
+        }
+    }
+    free(h -> kubelki);
+    free(h -> wczytane);
+    free(h -> bufor);
+    free(h);
+}
+
+/**
+ * Dostępne silniki, pierwszy jest domyślny
+ *
+ * "lista" - komórki i ich martwi sąsiedzi w listach dwukierunkowych
+ * "przebieg" - same żywe komórki w listach, następna generacja liczona jednym przejściem
+ * "tablica" - żywe komórki w posortowanych tablicach kolumn
+ * "aktywne" - jak "tablica", ale liczy od nowa tylko otoczenie ostatnich zmian
+ * "kafelki" - komórki w kafelkach 64 x 64 bitów, sąsiedzi liczeni sumatorami bitowymi
+ * "hashlife" - drzewo czwórkowe z jednoznacznymi węzłami i zapamiętanymi wynikami,
+ *              liczy 2^j generacji naraz
+ */
+static const Silnik silniki[] = {
+    {"lista", tworz_liste, dodaj_wiersz_listy, przygotuj_liste, krok_listy,
+     przegladaj_liste, czysc_liste, ustaw_regule_listy, odcisk_listy, przesun_liste, 0,
+     fazy_listy, krok_listy_mierzony, pisz_statystyki_listy, NULL, obszar_listy, NULL},
+    {"przebieg", tworz_liste, dodaj_wiersz_listy, bez_przygotowania, krok_przebiegu,
+     przegladaj_liste, czysc_liste, ustaw_regule_listy, odcisk_listy, przesun_liste, 1,
+     NULL, NULL, pisz_statystyki_listy, NULL, obszar_listy, NULL},
+    {"tablica", tworz_tablice, dodaj_wiersz_tablicy, bez_przygotowania, krok_tablicy,
+     przegladaj_tablice, czysc_tablice, ustaw_regule_tablicy, odcisk_tablicy,
+     przesun_tablice_planszy, 0, NULL, NULL, NULL, NULL, obszar_tablicy, NULL},
+    {"aktywne", tworz_tablice, dodaj_wiersz_tablicy, przygotuj_aktywne, krok_aktywnych,
+     przegladaj_tablice, czysc_aktywne, ustaw_regule_aktywnych, odcisk_tablicy,
+     przesun_tablice_planszy, 0, NULL, NULL, pisz_statystyki_aktywnych,
+     zmienione_wiersze_aktywnych, obszar_tablicy, NULL},
+    {"odcinki", tworz_odcinki, dodaj_wiersz_odcinkow, bez_przygotowania, krok_odcinkow,
+     przegladaj_odcinki, czysc_odcinki, ustaw_regule_odcinkow, odcisk_odcinkow, przesun_odcinki, 0,
+     NULL, NULL, pisz_statystyki_odcinkow, NULL, obszar_odcinkow, NULL},
+    {"kafelki", tworz_kafelki, dodaj_wiersz_kafelkow, bez_przygotowania, krok_kafelkow,
+     przegladaj_kafelki, czysc_kafelki, ustaw_regule_kafelkow, odcisk_kafelkow, przesun_kafelki, 0,
+     NULL, NULL, pisz_statystyki_kafelkow, NULL, obszar_kafelkow, NULL},
+    {"hashlife", tworz_hashlife, dodaj_wiersz_hashlife, przygotuj_hashlife, krok_hashlife,
+     przegladaj_hashlife, czysc_hashlife, ustaw_regule_hashlife, odcisk_hashlife, przesun_hashlife, 0,
+     NULL, NULL, pisz_statystyki_hashlife, NULL, obszar_hashlife, skok_daleki_hashlife},
+};
+
+/**
+ * Liczba dostępnych silników
+ */
+#define ILE_SILNIKOW ((int) (sizeof(silniki) / sizeof(silniki[0])))
+
+/**
+ * Czyta do 'r' regułę zapisaną w 'napis' jako "Bn.../Sn...", np. "B36/S23"
+ *
+ * Wielkość liter nie ma znaczenia, a części "B" i "S" mogą wystąpić w dowolnej kolejności.
+ * Zwraca 1, gdy napis jest poprawny, wpp. 0
+ */
+static int czytaj_regule(const char* napis, Regula* r)
+{
+    int maski[2] = {-1, -1};
+    const char* p = napis;
+    for (int czesc = 0; czesc < 2; czesc++) {
+        if (czesc == 1 && *p++ != '/')
+            return 0;
+        int i;
+        if (*p == 'B' || *p == 'b')
+            i = 0;
+        else if (*p == 'S' || *p == 's')
+            i = 1;
+        else
+            return 0;
+        if (maski[i] >= 0)
+            return 0;
+        maski[i] = 0;
+        p++;
+        while (*p >= '0' && *p <= '8') {
+            maski[i] |= 1 << (*p - '0');
+            p++;
+        }
+    }
+    if (*p != '\0')
+        return 0;
+    r -> narodziny = maski[0];
+    r -> przetrwanie = maski[1];
+    return 1;
+}
+
+/**
+ * Zapisuje w 'napis' regułę 'r' jako "Bn.../Sn..."
+ *
+ * 'napis' mieści co najmniej 23 znaki
+ */
+static void pisz_regule(const Regula* r, char* napis)
+{
+    *napis++ = 'B';
+    for (int n = 0; n <= 8; n++)
+        if ((r -> narodziny >> n) & 1)
+            *napis++ = (char) ('0' + n);
+    *napis++ = '/';
+    *napis++ = 'S';
+    for (int n = 0; n <= 8; n++)
+        if ((r -> przetrwanie >> n) & 1)
+            *napis++ = (char) ('0' + n);
+    *napis = '\0';
+}
+
+/**
+ * Zwraca maskę liczb sąsiadów 8 - n dla liczb n z maski 'm'
+ */
+static int odbij_maske(int m)
+{
+    int wynik = 0;
+    for (int n = 0; n <= 8; n++)
+        if ((m >> n) & 1)
+            wynik |= 1 << (8 - n);
+    return wynik;
+}
+
+/**
+ * Zapisuje w 'wynik' regułę, którą silnik ma policzyć następną generację planszy
+ * grającej regułą 'r'
+ *
+ * Reguła z B0 ożywia nieskończenie wiele komórek, których nie da się trzymać
+ * w silniku, który liczy tylko otoczenie żywych komórek. Plansza trzyma wtedy
+ * dopełnienie generacji, czyli jej martwe komórki, a silnik liczy regułę dla
+ * dopełnienia: dla komórki dopełnienia o n sąsiadach generacja ma 8 - n sąsiadów.
+ * Bez S8 dopełnienie i zwykła generacja przeplatają się, z S8 plansza po pierwszym
+ * kroku trzyma już zawsze dopełnienie. Wynikowa reguła nigdy nie ożywia komórek
+ * bez żywych sąsiadów.
+ *
+ * '*dopelniona' mówi, czy plansza trzyma dopełnienie, i jest uaktualniane
+ */
+static void regula_kroku(const Regula* r, int* dopelniona, Regula* wynik)
+{
+    if (!(r -> narodziny & 1))
+        *wynik = *r;
+    else if (!*dopelniona) {
+        wynik -> narodziny = ~r -> narodziny & WSZYSCY_SASIEDZI;
+        wynik -> przetrwanie = ~r -> przetrwanie & WSZYSCY_SASIEDZI;
+        *dopelniona = 1;
+    }
+    else if (r -> przetrwanie & (1 << 8)) {
+        wynik -> narodziny = ~odbij_maske(r -> przetrwanie) & WSZYSCY_SASIEDZI;
+        wynik -> przetrwanie = ~odbij_maske(r -> narodziny) & WSZYSCY_SASIEDZI;
+    }
+    else {
+        wynik -> narodziny = odbij_maske(r -> przetrwanie);
+        wynik -> przetrwanie = odbij_maske(r -> narodziny);
+        *dopelniona = 0;
+    }
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy 's' silnika 'silnik' grającej regułą 'r'
+ *
+ * Regułę bez B0 silnik dostał przy tworzeniu planszy i liczy wszystkie generacje naraz.
+ * Dla reguły z B0 każdą generację liczy osobno regułą z regula_kroku.
+ * '*dopelniona' mówi, czy plansza trzyma dopełnienie generacji, i jest uaktualniane
+ */
+static void licz_generacje(const Silnik* silnik, void* s, const Regula* r, int* dopelniona, int n)
+{
+    if (!(r -> narodziny & 1)) {
+        silnik -> krok(s, n);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        Regula q;
+        regula_kroku(r, dopelniona, &q);
+        silnik -> ustaw_regule(s, &q);
+        silnik -> krok(s, 1);
+    }
+}
+
+/**
+ * Odległość od krańców zakresu int, którą muszą zachować żywe komórki planszy silnika,
+ * żeby silniki mogły liczyć ich sąsiadów
+ */
+#define ZAPAS_SILNIKA (1 << 16)
+
+/**
+ * Największa wartość bezwzględna współrzędnej komórki na planszy silnika
+ */
+#define ZASIEG_SILNIKA ((long long) INT_MAX - ZAPAS_SILNIKA)
+
+/**
+ * Odległość od (0, 0), po przekroczeniu której plansza silnika jest przesuwana
+ * tak, żeby jej żywe komórki otaczały (0, 0)
+ */
+#define SRODEK_SILNIKA (1LL << 30)
+
+/**
+ * Pojemność opisu błędu gry i czytnika razem z kończącym go '\0'
+ */
+#define ROZMIAR_BLEDU 256
+
+/**
+ * Chebyshevowska odległość prostokątów żywych komórek dwóch skupisk, poniżej której
+ * skupiska scala się w jedno, i najmniejsza przerwa, wzdłuż której dzieli się skupisko
+ */
+#define PRZERWA_SKUPISK (1LL << 20)
+
+/**
+ * Największa liczba skupisk planszy gry
+ */
+#define NAJWIECEJ_SKUPISK 1024
+
+/**
+ * Reprezentuje skupisko żywych komórek gry liczone na własnej planszy silnika
+ *
+ * 's' - plansza silnika
+ * 'wiersz0', 'kol0' - współrzędne gry komórki (0, 0) planszy silnika
+ */
+typedef struct Skupisko_
+{
+    void* s;
+    long long wiersz0;
+    long long kol0;
+} Skupisko;
+
+/**
+ * Reprezentuje rozgrywaną grę
+ *
+ * Silniki liczą na współrzędnych int, a gra ma współrzędne 64-bitowe, więc jej żywe
+ * komórki dzieli się na skupiska, każde na własnej planszy silnika: komórka (y, x)
+ * planszy skupiska to komórka (wiersz0 + y, kol0 + x) gry. Odległe skupiska nie
+ * wpływają na siebie przez wiele generacji, więc liczy się je osobno, a bliskie się
+ * scala (zob. sprawdz_zasieg). Wczytywanie, okno, zrzut, migawki i statystyki
+ * przeliczają współrzędne, a gdy żywe komórki oddalają się od (0, 0) planszy
+ * skupiska, plansza jest przesuwana, a początek poprawiany.
+ *
+ * 'silnik' - silnik plansz skupisk
+ * 'skupiska', 'ile_skupisk', 'rozmiar_skupisk' - skupiska, ich liczba i pojemność tablicy
+ * 'ustawienia' - ustawienia, z którymi tworzy się plansze silnika
+ * 'regula' - reguła gry
+ * 'dopelniona' - 1, gdy plansze trzymają dopełnienie generacji (zob. regula_kroku)
+ * 'historia' - historia rozgrywki, w której szuka się cykli
+ * 'bez_sprawdzania' - liczba generacji, po których żywe komórki na pewno nie wyjdą
+ *                     poza ZASIEG_SILNIKA, a skupiska nie zbliżą się do siebie
+ * 'bez_zblizenia' - liczba generacji, po których żywe komórki na pewno nie wyjdą
+ *                   poza ZAKRES_WSPOLRZEDNYCH, a skupiska nie zbliżą się do siebie,
+ *                   niezależnie od zasięgu silnika (zob. skok_daleki)
+ * 'uklad' - numer układu skupisk, zmieniany przy każdej zmianie ich liczby lub początków
+ * 'kol', 'rozmiar_kol' - kolumny wiersza skupiska przekazywane przy wczytywaniu
+ * 'numery', 'rozmiar_numerow' - numery skupisk komórek wiersza przy wczytywaniu
+ * 'blad' - opis ostatniego błędu
+ */
+typedef struct Gra_
+{
+    const Silnik* silnik;
+    Skupisko* skupiska;
+    int ile_skupisk;
+    int rozmiar_skupisk;
+    Ustawienia ustawienia;
+    Regula regula;
+    int dopelniona;
+    struct Historia_* historia;
+    long long bez_sprawdzania;
+    long long bez_zblizenia;
+    long long uklad;
+    int* kol;
+    int rozmiar_kol;
+    int* numery;
+    int rozmiar_numerow;
+    char blad[ROZMIAR_BLEDU];
+} Gra;
+
+/**
+ * Zwraca 1, gdy współrzędna 'x' planszy silnika leży w ZASIEG_SILNIKA, wpp. 0
+ */
+static inline int w_zasiegu_silnika(long long x)
+{
+    return x >= -ZASIEG_SILNIKA && x <= ZASIEG_SILNIKA;
+}
+
+/**
+ * Dodaje do gry 'g' skupisko z pustą planszą silnika, której komórka (0, 0) to komórka
+ * ('wiersz0', 'kol0') gry, i zwraca jego numer
+ */
+static int dodaj_skupisko(Gra* g, long long wiersz0, long long kol0)
+{
+    g -> skupiska = (Skupisko*) powieksz(g -> skupiska, &g -> rozmiar_skupisk,
+                                         g -> ile_skupisk + 1, sizeof(Skupisko));
+    Skupisko* c = &g -> skupiska[g -> ile_skupisk];
+    c -> s = g -> silnik -> tworz(&g -> ustawienia);
+    c -> wiersz0 = wiersz0;
+    c -> kol0 = kol0;
+    g -> uklad++;
+    return g -> ile_skupisk++;
+}
+
+/**
+ * Usuwa z gry 'g' skupisko 'i' razem z jego planszą, na jego miejsce przenosząc ostatnie
+ */
+static void usun_skupisko(Gra* g, int i)
+{
+    g -> silnik -> czysc(g -> skupiska[i].s);
+    g -> skupiska[i] = g -> skupiska[--g -> ile_skupisk];
+    g -> uklad++;
+}
+
+/**
+ * Dodaje do planszy gry 'g' wiersz 'wiersz' z 'n' żywymi komórkami w rosnących
+ * kolumnach 'kol'
+ *
+ * Komórka trafia do skupiska, w którego zasięgu silnika leży, a gdy takiego
+ * nie ma, zakłada nowe skupisko i staje się jego komórką (0, 0). Wiersze muszą
+ * przychodzić w kolejności rosnących numerów.
+ * Zwraca 0, gdy skupisk byłoby więcej niż NAJWIECEJ_SKUPISK, wpp. 1
+ */
+static int dodaj_wiersz_gry(Gra* g, long long wiersz, const long long* kol, int n)
+{
+    g -> numery = (int*) powieksz(g -> numery, &g -> rozmiar_numerow, n, sizeof(int));
+    g -> kol = (int*) powieksz(g -> kol, &g -> rozmiar_kol, n, sizeof(int));
+    int c = 0;
+    for (int i = 0; i < n; i++) {
+        if (c < g -> ile_skupisk && w_zasiegu_silnika(wiersz - g -> skupiska[c].wiersz0)
+            && w_zasiegu_silnika(kol[i] - g -> skupiska[c].kol0)) {
+            g -> numery[i] = c;
+            continue;
+        }
+        c = 0;
+        while (c < g -> ile_skupisk && (!w_zasiegu_silnika(wiersz - g -> skupiska[c].wiersz0)
+                                        || !w_zasiegu_silnika(kol[i] - g -> skupiska[c].kol0)))
+            c++;
+        if (c == g -> ile_skupisk) {
+            if (g -> ile_skupisk == NAJWIECEJ_SKUPISK)
+                return 0;
+            dodaj_skupisko(g, wiersz, kol[i]);
+        }
+        g -> numery[i] = c;
+    }
+    // komórki skupiska trafiają na jego plansze jednym wierszem
+    for (int i = 0; i < n; i++) {
+        c = g -> numery[i];
+        if (c < 0)
+            continue;
+        Skupisko* sk = &g -> skupiska[c];
+        int m = 0;
+        for (int j = i; j < n; j++)
+            if (g -> numery[j] == c) {
+                g -> kol[m++] = (int) (kol[j] - sk -> kol0);
+                g -> numery[j] = -1;
+            }
+        g -> silnik -> dodaj_wiersz(sk -> s, (int) (wiersz - sk -> wiersz0), g -> kol, m);
+    }
+    g -> bez_sprawdzania = 0;
+    return 1;
+}
+
+/**
+ * Przygotowuje plansze wszystkich skupisk gry 'g' do liczenia po wczytaniu
+ */
+static void przygotuj_skupiska(Gra* g)
+{
+    for (int i = 0; i < g -> ile_skupisk; i++)
+        g -> silnik -> przygotuj(g -> skupiska[i].s);
+}
+
+/**
+ * Rozmiar bloku, którym czytnik czyta wejście
+ */
+#define ROZMIAR_CZYTNIKA (1 << 20)
+
+/**
+ * Czyta wejście blokami lub z pamięci, pamiętając położenie w tekście
+ *
+ * 'fd' - deskryptor, z którego czyta się kolejne bloki, -1 gdy cały tekst jest w pamięci
+ * 'bufor' - bufor bloku (NULL dla tekstu w pamięci)
+ * 'mapa', 'dlugosc_mapy' - zmapowany plik lub NULL
+ * 'p' - następny znak do przeczytania
+ * 'koniec' - koniec przeczytanej części tekstu
+ * 'przesuniecie' - położenie w tekście znaku, na który wskazuje 'p'
+ * 'linia' - numer linii znaku 'p', od 1
+ * 'poczatek_linii' - położenie w tekście pierwszego znaku tej linii
+ * 'blad' - opis pierwszego błędu wejścia, pusty, gdy go nie było
+ */
+struct Czytnik_
+{
+    int fd;
+    char* bufor;
+    void* mapa;
+    size_t dlugosc_mapy;
+    const char* p;
+    const char* koniec;
+    long long przesuniecie;
+    int linia;
+    long long poczatek_linii;
+    char blad[ROZMIAR_BLEDU];
+};
+
+/**
+ * Przygotowuje czytnik 'c' do czytania deskryptora 'fd'
+ */
+static void inicjuj_czytnik(Czytnik* c, int fd)
+{
+    c -> fd = fd;
+    c -> bufor = (char*) malloc(ROZMIAR_CZYTNIKA);
+    c -> mapa = NULL;
+    c -> dlugosc_mapy = 0;
+    c -> p = c -> bufor;
+    c -> koniec = c -> bufor;
+    c -> przesuniecie = 0;
+    c -> linia = 1;
+    c -> poczatek_linii = 0;
+    c -> blad[0] = '\0';
+}
+
+/**
+ * Przygotowuje czytnik 'c' do czytania pliku 'nazwa' zmapowanego do pamięci
+ *
+ * Zwraca 0, gdy pliku nie da się otworzyć, wpp. 1
+ */
+static int otworz_czytnik(Czytnik* c, const char* nazwa)
+{
+    int fd = open(nazwa, O_RDONLY);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return 0;
+    }
+    inicjuj_czytnik(c, -1);
+    free(c -> bufor);
+    c -> bufor = NULL;
+    if (st.st_size > 0) {
+        c -> mapa = mmap(NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (c -> mapa == MAP_FAILED) {
+            close(fd);
+            return 0;
+        }
+        c -> dlugosc_mapy = (size_t) st.st_size;
+        madvise(c -> mapa, c -> dlugosc_mapy, MADV_SEQUENTIAL);
+        c -> p = (const char*) c -> mapa;
+        c -> koniec = c -> p + c -> dlugosc_mapy;
+    }
+    close(fd);
+    return 1;
+}
+
+/**
+ * Zwalnia pamięć czytnika 'c'
+ */
+static void zamknij_czytnik(Czytnik* c)
+{
+    if (c -> mapa != NULL)
+        munmap(c -> mapa, c -> dlugosc_mapy);
+    free(c -> bufor);
+}
+
+/**
+ * Czyta następny blok wejścia czytnika 'c', gdy cały bieżący został przeczytany
+ *
+ * Zwraca 0 na końcu wejścia, wpp. 1
+ */
+static int uzupelnij_czytnik(Czytnik* c)
+{
+    if (c -> p < c -> koniec)
+        return 1;
+    if (c -> fd < 0)
+        return 0;
+    ssize_t n;
+    do
+        n = read(c -> fd, c -> bufor, ROZMIAR_CZYTNIKA);
+    while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return 0;
+    c -> p = c -> bufor;
+    c -> koniec = c -> bufor + n;
+    return 1;
+}
+
+/**
+ * Zwraca następny znak wejścia czytnika 'c' bez przeczytania go, lub EOF
+ */
+static inline int zajrzyj(Czytnik* c)
+{
+    if (c -> p == c -> koniec && !uzupelnij_czytnik(c))
+        return EOF;
+    return (unsigned char) *c -> p;
+}
+
+/**
+ * Czyta następny znak wejścia czytnika 'c' i zwraca go, lub EOF
+ */
+static inline int wez_znak(Czytnik* c)
+{
+    int x = zajrzyj(c);
+    if (x == EOF)
+        return EOF;
+    c -> p++;
+    c -> przesuniecie++;
+    if (x == '\n') {
+        c -> linia++;
+        c -> poczatek_linii = c -> przesuniecie;
+    }
+    return x;
+}
+
+/**
+ * Zapisuje w czytniku 'c' opis 'opis' błędu wejścia w miejscu następnego znaku,
+ * o ile wcześniej nie było błędu, i kończy jego wejście
+ */
+static void blad_wejscia(Czytnik* c, const char* opis)
+{
+    if (c -> blad[0] == '\0')
+        snprintf(c -> blad, ROZMIAR_BLEDU, "blad wejscia (linia %d, kolumna %lld): %s",
+                 c -> linia, c -> przesuniecie - c -> poczatek_linii + 1, opis);
+    c -> p = c -> koniec;
+    c -> fd = -1;
+}
+
+/**
+ * Pomija spacje i tabulacje na wejściu czytnika 'c'
+ */
+static void pomin_odstepy(Czytnik* c)
+{
+    int x = zajrzyj(c);
+    while (x == ' ' || x == '\t') {
+        wez_znak(c);
+        x = zajrzyj(c);
+    }
+}
+
+/**
+ * Czyta liczbę całkowitą od 'najmniej' do 'najwiecej' z wejścia czytnika 'c'
+ *
+ * Zwraca 0 z opisem błędu w czytniku, gdy na wejściu nie ma liczby lub nie mieści się
+ * ona w zakresie. Wartości bezwzględne granic nie mogą przekraczać ZAKRES_WSPOLRZEDNYCH.
+ */
+static long long czytaj_liczbe_z_zakresu(Czytnik* c, long long najmniej, long long najwiecej)
+{
+    int ujemna = 0;
+    if (zajrzyj(c) == '-') {
+        ujemna = 1;
+        wez_znak(c);
+    }
+    int x = zajrzyj(c);
+    if (x < '0' || x > '9') {
+        blad_wejscia(c, "oczekiwano liczby");
+        return 0;
+    }
+    long long granica = ujemna ? -najmniej : najwiecej;
+    long long wynik = 0;
+    while (1) {
+        const char* p = c -> p;
+        while (p < c -> koniec && *p >= '0' && *p <= '9') {
+            if (wynik > (granica - (*p - '0')) / 10) {
+                blad_wejscia(c, "liczba poza zakresem");
+                return 0;
+            }
+            wynik = wynik * 10 + (*p - '0');
+            p++;
+        }
+        c -> przesuniecie += p - c -> p;
+        c -> p = p;
+        if (p < c -> koniec || !uzupelnij_czytnik(c))
+            break;
+    }
+    return ujemna ? -wynik : wynik;
+}
+
+/**
+ * Czyta współrzędną komórki gry z wejścia czytnika 'c'
+ *
+ * Zwraca 0 z opisem błędu w czytniku, gdy na wejściu nie ma liczby lub jej wartość
+ * bezwzględna przekracza ZAKRES_WSPOLRZEDNYCH
+ */
+static long long czytaj_wspolrzedna(Czytnik* c)
+{
+    return czytaj_liczbe_z_zakresu(c, -ZAKRES_WSPOLRZEDNYCH, ZAKRES_WSPOLRZEDNYCH);
+}
+
+/**
+ * Czyta z wejścia czytnika 'c' resztę linii razem ze znakiem jej końca
+ * i zapisuje ją bez niego jako napis w '*bufor' o pojemności '*rozmiar'
+ */
+static void czytaj_linie(Czytnik* c, char** bufor, int* rozmiar)
+{
+    int n = 0;
+    int x = wez_znak(c);
+    while (x != EOF && x != '\n') {
+        *bufor = (char*) powieksz(*bufor, rozmiar, n + 2, sizeof(char));
+        (*bufor)[n++] = (char) x;
+        x = wez_znak(c);
+    }
+    *bufor = (char*) powieksz(*bufor, rozmiar, n + 1, sizeof(char));
+    (*bufor)[n] = '\0';
+}
+
+/**
+ * Czyta komórki z wejścia czytnika 'c' i dodaje je do planszy gry 'g'
+ *
+ * Każdy wiersz opisu to '/', numer wiersza i rosnące numery kolumn oddzielone spacjami.
+ * Opis kończy linia "/". Wiersze muszą być podane rosnąco. Komórki dzieli się na
+ * skupiska jak w dodaj_wiersz_gry.
+ * Zwraca 0 z opisem błędu w czytniku, gdy opis jest niepoprawny; plansza ma wtedy
+ * wiersze przeczytane przed błędem.
+ */
+static int czytaj_plansze(Gra* g, Czytnik* c)
+{
+    long long* kol = NULL;
+    int rozmiar = 0;
+    long long poprzedni = 0;
+    int pierwszy = 1;
+    while (c -> blad[0] == '\0') {
+        if (wez_znak(c) != '/') {
+            blad_wejscia(c, "oczekiwano '/'");
+            break;
+        }
+        int x = zajrzyj(c);
+        if (x == EOF || x == '\n') {
+            wez_znak(c);
+            break;
+        }
+        long long wiersz = czytaj_wspolrzedna(c);
+        if (!pierwszy && wiersz <= poprzedni)
+            blad_wejscia(c, "wiersze nie sa rosnace");
+        int n = 0;
+        while (c -> blad[0] == '\0') {
+            pomin_odstepy(c);
+            x = zajrzyj(c);
+            if (x == EOF || x == '\n')
+                break;
+            long long y = czytaj_wspolrzedna(c);
+            if (n > 0 && y <= kol[n - 1])
+                blad_wejscia(c, "kolumny nie sa rosnace");
+            if (c -> blad[0] != '\0')
+                break;
+            kol = (long long*) powieksz(kol, &rozmiar, n + 1, sizeof(long long));
+            kol[n++] = y;
+        }
+        if (c -> blad[0] != '\0')
+            break;
+        if (n > 0) {
+            if (!dodaj_wiersz_gry(g, wiersz, kol, n)) {
+                blad_wejscia(c, "za duzo odleglych skupisk komorek");
+                break;
+            }
+            poprzedni = wiersz;
+            pierwszy = 0;
+        }
+        wez_znak(c);
+    }
+    free(kol);
+    przygotuj_skupiska(g);
+    return c -> blad[0] == '\0';
+}
+
+/**
+ * Długość linii okna domyślnego rozmiaru razem ze znakiem końca linii
+ */
+#define DLUGOSC_LINII (KOLUMNY + 1)
+
+/**
+ * Reprezentuje okno wyświetlane w czasie gry
+ *
+ * 'wiersze', 'kolumny' - rozmiar okna, przy zerowym okno nie jest wyświetlane
+ * 'tryb' - sposób wyświetlania, OKNO_*
+ * 'f' - plik, do którego okno jest wypisywane
+ * 'bufor' - tekst okna razem z dolną ramką, przydzielony raz, gdy rozmiar jest inny
+ *           niż domyślny lub okno jest wyświetlane zmianami (okno domyślne wypisywane
+ *           w całości jest składane na stosie), wpp. NULL
+ * 'poprzednie' - tekst poprzednio wypisanego okna, gdy okno jest wyświetlane zmianami
+ * 'zmienione' - dla każdej linii 1, gdy mogła się zmienić od poprzedniego okna
+ * 'poprzednie_znane' - 1, gdy 'poprzednie' jest tym, co widać na wyjściu
+ * 'w', 'k' - współrzędne gry lewego górnego rogu poprzedniego okna
+ * 'uklad', 'dopelniona', 'generacja' - układ skupisk gry, to, czy plansza trzymała
+ *                                      dopełnienie, i numer generacji poprzedniego okna
+ */
+struct Okno_
+{
+    int wiersze;
+    int kolumny;
+    int tryb;
+    FILE* f;
+    char* bufor;
+    char* poprzednie;
+    char* zmienione;
+    int poprzednie_znane;
+    long long w;
+    long long k;
+    long long uklad;
+    int dopelniona;
+    long long generacja;
+};
+
+/**
+ * Tworzy w '*o' okno o 'wiersze' wierszach i 'kolumny' kolumnach wyświetlane
+ * sposobem 'tryb' do pliku 'f'
+ */
+static void tworz_okno(Okno* o, int wiersze, int kolumny, int tryb, FILE* f)
+{
+    memset(o, 0, sizeof(Okno));
+    o -> wiersze = wiersze;
+    o -> kolumny = kolumny;
+    o -> tryb = tryb;
+    o -> f = f;
+    if (wiersze == 0 || kolumny == 0 || (tryb == OKNO_PELNE && wiersze == WIERSZE && kolumny == KOLUMNY))
+        return;
+    size_t dlugosc = (size_t) kolumny + 1;
+    o -> bufor = (char*) malloc ((size_t) (wiersze + 1) * dlugosc);
+    if (tryb == OKNO_PELNE)
+        return;
+    o -> poprzednie = (char*) malloc ((size_t) (wiersze + 1) * dlugosc);
+    o -> zmienione = (char*) malloc ((size_t) wiersze);
+    // dolna ramka nie zmienia się, a bufory są zamieniane po każdym oknie
+    memset(o -> bufor + wiersze * dlugosc, '=', (size_t) kolumny);
+    o -> bufor[wiersze * dlugosc + kolumny] = '\n';
+    memcpy(o -> poprzednie + wiersze * dlugosc, o -> bufor + wiersze * dlugosc, dlugosc);
+}
+
+/**
+ * Zwalnia bufory okna 'o'
+ */
+static void czysc_okno(Okno* o)
+{
+    free(o -> bufor);
+    free(o -> poprzednie);
+    free(o -> zmienione);
+    o -> bufor = o -> poprzednie = o -> zmienione = NULL;
+}
+
+/**
+ * Zapomina, co widać na terminalu okna 'o' wyświetlanego sekwencjami ANSI, po wypisaniu
+ * do jego pliku innego tekstu, więc następne okno zostanie wypisane w całości
+ */
+static void uniewaznij_okno(Okno* o)
+{
+    if (o -> tryb == OKNO_ANSI)
+        o -> poprzednie_znane = 0;
+}
+
+/**
+ * Reprezentuje okno, do którego wpisuje się wiersze planszy
+ *
+ * 'bufor' - tekst okna, linie po 'dlugosc_linii' znaków
+ * 'w', 'k' - współrzędne planszy silnika lewego górnego rogu okna
+ * 'znak' - znak wpisywany w miejsce komórek planszy
+ * 'dlugosc_linii' - długość linii okna razem ze znakiem końca linii
+ */
+typedef struct WpisOkna_
+{
+    char* bufor;
+    long long w;
+    long long k;
+    char znak;
+    int dlugosc_linii;
+} WpisOkna;
+
+/**
+ * Wpisuje w okno opisane przez 'kontekst' komórki wiersza 'wiersz'
+ *
+ * Wszystkie kolumny 'kol' leżą w oknie
+ */
+static void wpisz_wiersz_w_okno(void* kontekst, int wiersz, const int* kol, int n)
+{
+    WpisOkna* wo = (WpisOkna*) kontekst;
+    char* linia = wo -> bufor + (size_t) (wiersz - wo -> w) * (size_t) wo -> dlugosc_linii;
+    for (int i = 0; i < n; i++)
+        linia[kol[i] - wo -> k] = wo -> znak;
+}
+
+/**
+ * Wpisuje w okno domyślnego rozmiaru opisane przez 'kontekst' komórki wiersza 'wiersz'
+ *
+ * Wszystkie kolumny 'kol' leżą w oknie
+ */
+static void wpisz_wiersz_w_okno_domyslne(void* kontekst, int wiersz, const int* kol, int n)
+{
+    WpisOkna* wo = (WpisOkna*) kontekst;
+    char* linia = wo -> bufor + (size_t) (wiersz - wo -> w) * DLUGOSC_LINII;
+    for (int i = 0; i < n; i++)
+        linia[kol[i] - wo -> k] = wo -> znak;
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy skupiska 'c' silnika 'silnik'
+ * o numerach od 'w_od' do 'w_do', z komórkami w kolumnach od 'k_od' do 'k_do'
+ *
+ * Współrzędne są współrzędnymi planszy skupiska i mogą wychodzić poza jej zasięg,
+ * który je wtedy przycina.
+ */
+static inline void przegladaj_prostokat(const Silnik* silnik, const Skupisko* c,
+                                        long long w_od, long long w_do,
+                                        long long k_od, long long k_do,
+                                        OdbiorcaWiersza f, void* kontekst)
+{
+    w_od = w_od > INT_MIN ? w_od : INT_MIN;
+    w_do = w_do < INT_MAX ? w_do : INT_MAX;
+    k_od = k_od > INT_MIN ? k_od : INT_MIN;
+    k_do = k_do < INT_MAX ? k_do : INT_MAX;
+    if (w_od <= w_do && k_od <= k_do)
+        silnik -> przegladaj(c -> s, (int) w_od, (int) w_do, (int) k_od, (int) k_do, f, kontekst);
+}
+
+/**
+ * Składa w buforze 'bufor' okna o 'kolumny' kolumnach linie od 'od' do 'do_' - 1
+ * planszy gry 'g', wpisując wiersze funkcją 'wpisz'
+ *
+ * Wywoływana ze stałym rozmiarem dla okna domyślnego, żeby kompilator mógł go wstawić.
+ * 'w' i 'k' oznaczają współrzędne gry lewego górnego rogu okna
+ */
+static inline void skladaj_linie(const Gra* g, char* bufor, int kolumny, int od, int do_,
+                                 long long w, long long k, OdbiorcaWiersza wpisz)
+{
+    int dlugosc = kolumny + 1;
+    for (int i = od; i < do_; i++) {
+        memset(bufor + (size_t) i * dlugosc, g -> dopelniona ? '0' : '.', (size_t) kolumny);
+        bufor[(size_t) i * dlugosc + kolumny] = '\n';
+    }
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        const Skupisko* c = &g -> skupiska[i];
+        WpisOkna wo = {bufor, w - c -> wiersz0, k - c -> kol0, g -> dopelniona ? '.' : '0', dlugosc};
+        przegladaj_prostokat(g -> silnik, c, wo.w + od, wo.w + do_ - 1, wo.k, wo.k + kolumny - 1,
+                             wpisz, &wo);
+    }
+}
+
+/**
+ * Składa w buforze 'bufor' i wypisuje w całości do 'f' okno o 'wiersze' wierszach
+ * i 'kolumny' kolumnach planszy gry 'g', wpisując wiersze funkcją 'wpisz'
+ *
+ * Wywoływana ze stałym rozmiarem dla okna domyślnego, żeby kompilator mógł go wstawić.
+ * 'w' i 'k' oznaczają współrzędne gry lewego górnego rogu okna
+ */
+static inline void skladaj_okno(const Gra* g, char* bufor, int wiersze, int kolumny,
+                                long long w, long long k, OdbiorcaWiersza wpisz, FILE* f)
+{
+    int dlugosc = kolumny + 1;
+    skladaj_linie(g, bufor, kolumny, 0, wiersze, w, k, wpisz);
+    memset(bufor + (size_t) wiersze * dlugosc, '=', (size_t) kolumny);
+    bufor[(size_t) wiersze * dlugosc + kolumny] = '\n';
+    fwrite(bufor, 1, (size_t) (wiersze + 1) * dlugosc, f);
+}
+
+/**
+ * Wyświetla zmiany okna 'o' planszy gry 'g' w generacji 'generacja' od poprzedniego
+ * wypisanego okna
+ *
+ * Gdy od poprzedniego okna silnik policzył jedną generację, okno i plansza silnika
+ * się nie przesunęły, a silnik śledzi zmiany, silnik wskazuje wiersze, w których mogły
+ * się zmienić komórki, a pozostałe linie przepisuje się z poprzedniego okna, nie
+ * przeglądając planszy. Gdy nic się nie zmieniło, nie przegląda się jej wcale.
+ * W pozostałych przypadkach okno składa się od nowa. Wypisuje się tylko linie różne
+ * od poprzednich.
+ */
+static void wyswietl_zmiany(const Gra* g, Okno* o, long long w, long long k, long long generacja)
+{
+    int wiersze = o -> wiersze;
+    int kolumny = o -> kolumny;
+    size_t dlugosc = (size_t) kolumny + 1;
+    int to_samo = o -> poprzednie_znane && o -> w == w && o -> k == k
+        && o -> uklad == g -> uklad && o -> dopelniona == g -> dopelniona;
+    if (to_samo && o -> generacja == generacja) {
+        memset(o -> zmienione, 0, (size_t) wiersze);
+        memcpy(o -> bufor, o -> poprzednie, (size_t) wiersze * dlugosc);
+    }
+    else if (to_samo && o -> generacja + 1 == generacja && g -> silnik -> zmienione_wiersze != NULL) {
+        memset(o -> zmienione, 0, (size_t) wiersze);
+        for (int i = 0; i < g -> ile_skupisk; i++) {
+            const Skupisko* c = &g -> skupiska[i];
+            long long w_rel = w - c -> wiersz0;
+            long long k_rel = k - c -> kol0;
+            long long w_od = w_rel > INT_MIN ? w_rel : INT_MIN;
+            long long w_do = w_rel + wiersze - 1 < INT_MAX ? w_rel + wiersze - 1 : INT_MAX;
+            long long k_od = k_rel > INT_MIN ? k_rel : INT_MIN;
+            long long k_do = k_rel + kolumny - 1 < INT_MAX ? k_rel + kolumny - 1 : INT_MAX;
+            if (w_od <= w_do && k_od <= k_do)
+                g -> silnik -> zmienione_wiersze(c -> s, (int) w_od, (int) w_do, (int) k_od, (int) k_do,
+                                                 o -> zmienione + (w_od - w_rel));
+        }
+        memcpy(o -> bufor, o -> poprzednie, (size_t) wiersze * dlugosc);
+        for (int i = 0; i < wiersze; i++) {
+            if (!o -> zmienione[i])
+                continue;
+            int j = i;
+            while (j < wiersze && o -> zmienione[j])
+                j++;
+            skladaj_linie(g, o -> bufor, kolumny, i, j, w, k, wpisz_wiersz_w_okno);
+            i = j;
+        }
+    }
+    else {
+        memset(o -> zmienione, 1, (size_t) wiersze);
+        skladaj_linie(g, o -> bufor, kolumny, 0, wiersze, w, k, wpisz_wiersz_w_okno);
+    }
+    if (o -> tryb == OKNO_ANSI && !o -> poprzednie_znane)
+        fputs("\033[H\033[2J", o -> f);
+    int wypisane = 0;
+    for (int i = 0; i < wiersze; i++) {
+        const char* linia = o -> bufor + (size_t) i * dlugosc;
+        if (!o -> zmienione[i]
+            || (o -> poprzednie_znane && memcmp(linia, o -> poprzednie + (size_t) i * dlugosc, dlugosc) == 0))
+            continue;
+        if (o -> tryb == OKNO_LINIE) {
+            fprintf(o -> f, "%d:", i + 1);
+            fwrite(linia, 1, dlugosc, o -> f);
+        }
+        else {
+            fprintf(o -> f, "\033[%d;1H", i + 1);
+            fwrite(linia, 1, (size_t) kolumny, o -> f);
+        }
+        wypisane = 1;
+    }
+    const char* ramka = o -> bufor + (size_t) wiersze * dlugosc;
+    if (o -> tryb == OKNO_LINIE)
+        fwrite(ramka, 1, dlugosc, o -> f);
+    else {
+        if (!o -> poprzednie_znane) {
+            fprintf(o -> f, "\033[%d;1H", wiersze + 1);
+            fwrite(ramka, 1, (size_t) kolumny, o -> f);
+        }
+        if (wypisane || !o -> poprzednie_znane)
+            fprintf(o -> f, "\033[%d;1H", wiersze + 2);
+    }
+    char* pom = o -> poprzednie;
+    o -> poprzednie = o -> bufor;
+    o -> bufor = pom;
+    o -> poprzednie_znane = 1;
+    o -> w = w;
+    o -> k = k;
+    o -> uklad = g -> uklad;
+    o -> dopelniona = g -> dopelniona;
+    o -> generacja = generacja;
+}
+
+/**
+ * Wyświetla okno 'o' planszy gry 'g' w generacji 'generacja'
+ *
+ * Komórki w oknie są żywe wtw gdy są żywe na planszy gry. Okno razem z dolną ramką
+ * jest składane w jednym buforze i pisane jednym wywołaniem, a silnik przegląda
+ * tylko wiersze i kolumny okna leżące na jego planszy. Gdy plansza trzyma dopełnienie
+ * generacji, jej komórki są martwe. Okno o zerowym rozmiarze nie jest wyświetlane,
+ * a okno w trybie innym niż OKNO_PELNE jest wyświetlane zmianami (zob. wyswietl_zmiany).
+ *
+ * 'w' i 'k' oznaczają współrzędne gry lewego górnego rogu okna
+ */
+static void wyswietl_okno(const Gra* g, Okno* o, long long w, long long k, long long generacja)
+{
+    if (o -> wiersze == 0 || o -> kolumny == 0)
+        return;
+    if (o -> tryb != OKNO_PELNE)
+        wyswietl_zmiany(g, o, w, k, generacja);
+    else if (o -> wiersze == WIERSZE && o -> kolumny == KOLUMNY) {
+        char bufor[(WIERSZE + 1) * DLUGOSC_LINII];
+        skladaj_okno(g, bufor, WIERSZE, KOLUMNY, w, k, wpisz_wiersz_w_okno_domyslne, o -> f);
+    }
+    else
+        skladaj_okno(g, o -> bufor, o -> wiersze, o -> kolumny, w, k, wpisz_wiersz_w_okno, o -> f);
+}
+
+
+/**
+ * Rozmiar bufora pisarza
+ */
+#define ROZMIAR_PISARZA (1 << 16)
+
+/**
+ * Zbiera tekst w buforze i pisze go dużymi porcjami do deskryptora
+ *
+ * 'fd' - deskryptor, do którego trafia tekst
+ * 'blad' - 1, gdy któryś zapis się nie udał
+ * 'ile' - liczba znaków w buforze
+ * 'bufor' - tekst czekający na zapis
+ */
+typedef struct Pisarz_
+{
+    int fd;
+    int blad;
+    size_t ile;
+    char bufor[ROZMIAR_PISARZA];
+} Pisarz;
+
+/**
+ * Pisze do deskryptora cały tekst z bufora pisarza 'p'
+ */
+static void oproznij_pisarza(Pisarz* p)
+{
+    size_t zapisane = 0;
+    while (zapisane < p -> ile && !p -> blad) {
+        ssize_t n = write(p -> fd, p -> bufor + zapisane, p -> ile - zapisane);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            p -> blad = 1;
+        else
+            zapisane += (size_t) n;
+    }
+    p -> ile = 0;
+}
+
+/**
+ * Dopisuje znak 'x' do bufora pisarza 'p'
+ */
+static inline void pisz_znak(Pisarz* p, char x)
+{
+    if (p -> ile == ROZMIAR_PISARZA)
+        oproznij_pisarza(p);
+    p -> bufor[p -> ile++] = x;
+}
+
+/**
+ * Dopisuje 'n' bajtów 'x' do bufora pisarza 'p'
+ */
+static void pisz_bajty(Pisarz* p, const void* x, size_t n)
+{
+    const char* q = (const char*) x;
+    while (n > 0) {
+        if (p -> ile == ROZMIAR_PISARZA)
+            oproznij_pisarza(p);
+        size_t ile = ROZMIAR_PISARZA - p -> ile < n ? ROZMIAR_PISARZA - p -> ile : n;
+        memcpy(p -> bufor + p -> ile, q, ile);
+        p -> ile += ile;
+        q += ile;
+        n -= ile;
+    }
+}
+
+/**
+ * Dopisuje liczbę 'x' zapisaną dziesiętnie do bufora pisarza 'p'
+ */
+static inline void pisz_liczbe(Pisarz* p, long long x)
+{
+    char cyfry[20];
+    int n = 0;
+    unsigned long long u = x < 0 ? 0ull - (unsigned long long) x : (unsigned long long) x;
+    do {
+        cyfry[n++] = (char) ('0' + u % 10);
+        u /= 10;
+    } while (u != 0);
+    if (p -> ile + 21 > ROZMIAR_PISARZA)
+        oproznij_pisarza(p);
+    if (x < 0)
+        p -> bufor[p -> ile++] = '-';
+    while (n > 0)
+        p -> bufor[p -> ile++] = cyfry[--n];
+}
+
+/**
+ * Funkcja odbierająca kolejne niepuste wiersze planszy gry, jak OdbiorcaWiersza, ale
+ * we współrzędnych gry
+ */
+typedef void (*OdbiorcaWierszaGry)(void* kontekst, long long wiersz, const long long* kol, int n);
+
+/**
+ * Reprezentuje skupisko w kopii generacji
+ *
+ * 't' - żywe komórki planszy skupiska
+ * 'wiersz0', 'kol0' - współrzędne gry komórki (0, 0) planszy skupiska
+ */
+typedef struct SkupiskoKopii_
+{
+    Tablice t;
+    long long wiersz0;
+    long long kol0;
+} SkupiskoKopii;
+
+/**
+ * Reprezentuje niezmienną kopię generacji gry
+ *
+ * Kopia nie zależy od gry, więc można ją zrzucić w innym wątku, gdy gra liczy
+ * kolejne generacje.
+ *
+ * 'skupiska', 'ile_skupisk' - kopie kolejnych skupisk gry i ich liczba
+ */
+struct Kopia_
+{
+    SkupiskoKopii* skupiska;
+    int ile_skupisk;
+};
+
+/**
+ * Tworzy kopię aktualnej generacji planszy gry 'g'
+ */
+static Kopia* kopiuj_stan(const Gra* g)
+{
+    Kopia* k = (Kopia*) calloc (1, sizeof(Kopia));
+    k -> ile_skupisk = g -> ile_skupisk;
+    k -> skupiska = (SkupiskoKopii*) calloc ((size_t) g -> ile_skupisk + 1, sizeof(SkupiskoKopii));
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        SkupiskoKopii* c = &k -> skupiska[i];
+        c -> wiersz0 = g -> skupiska[i].wiersz0;
+        c -> kol0 = g -> skupiska[i].kol0;
+        g -> silnik -> przegladaj(g -> skupiska[i].s, INT_MIN, INT_MAX, INT_MIN, INT_MAX,
+                                  dopisz_do_tablic, &c -> t);
+    }
+    return k;
+}
+
+/**
+ * Usuwa kopię 'k'
+ */
+static void usun_kopie(Kopia* k)
+{
+    for (int i = 0; i < k -> ile_skupisk; i++) {
+        free(k -> skupiska[i].t.w);
+        free(k -> skupiska[i].t.kol);
+    }
+    free(k -> skupiska);
+    free(k);
+}
+
+/**
+ * Reprezentuje wiersz skupiska kopii w kolejności wierszy gry
+ *
+ * 'wiersz', 'kol' - numer wiersza i pierwsza kolumna we współrzędnych gry
+ * 'skupisko', 'nr' - numer skupiska i numer wiersza w jego tablicach
+ */
+typedef struct WierszKopii_
+{
+    long long wiersz;
+    long long kol;
+    int skupisko;
+    int nr;
+} WierszKopii;
+
+/**
+ * Porównuje wiersze kopii 'a' i 'b' według wiersza, a potem pierwszej kolumny
+ */
+static int porownaj_wiersze_kopii(const void* a, const void* b)
+{
+    const WierszKopii* x = (const WierszKopii*) a;
+    const WierszKopii* y = (const WierszKopii*) b;
+    if (x -> wiersz != y -> wiersz)
+        return x -> wiersz < y -> wiersz ? -1 : 1;
+    return (x -> kol > y -> kol) - (x -> kol < y -> kol);
+}
+
+/**
+ * Porównuje liczby 'a' i 'b' typu long long
+ */
+static int porownaj_liczby(const void* a, const void* b)
+{
+    long long x = *(const long long*) a;
+    long long y = *(const long long*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Porównuje numery kolumn 'a' i 'b'
+ */
+static int porownaj_kolumny(const void* a, const void* b)
+{
+    int x = *(const int*) a;
+    int y = *(const int*) b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze kopii 'k' w kolejności rosnących numerów
+ *
+ * Wiersze skupisk porządkuje się według numerów wierszy gry, a wiersz gry złożony
+ * z wierszy kilku skupisk składa się w jeden. Skupiska trzymające ten sam wiersz leżą
+ * zwykle w rozłącznych przedziałach kolumn, więc sortuje się go tylko, gdy ich
+ * kolumny się przeplatają.
+ */
+static void przegladaj_kopie(const Kopia* k, OdbiorcaWierszaGry f, void* kontekst)
+{
+    int ile = 0;
+    for (int i = 0; i < k -> ile_skupisk; i++)
+        ile += k -> skupiska[i].t.ile_w;
+    WierszKopii* wiersze = (WierszKopii*) malloc (((size_t) ile + 1) * sizeof(WierszKopii));
+    ile = 0;
+    for (int i = 0; i < k -> ile_skupisk; i++) {
+        const SkupiskoKopii* c = &k -> skupiska[i];
+        for (int j = 0; j < c -> t.ile_w; j++) {
+            WierszKopii* w = &wiersze[ile++];
+            w -> wiersz = c -> wiersz0 + c -> t.w[j].wiersz;
+            w -> kol = c -> kol0 + c -> t.kol[c -> t.w[j].od];
+            w -> skupisko = i;
+            w -> nr = j;
+        }
+    }
+    if (k -> ile_skupisk > 1)
+        qsort(wiersze, (size_t) ile, sizeof(WierszKopii), porownaj_wiersze_kopii);
+    long long* kol = NULL;
+    int rozmiar = 0;
+    for (int i = 0; i < ile; ) {
+        int n = 0;
+        int rosnace = 1;
+        int j = i;
+        for (; j < ile && wiersze[j].wiersz == wiersze[i].wiersz; j++) {
+            const SkupiskoKopii* c = &k -> skupiska[wiersze[j].skupisko];
+            const WierszTablicy* w = &c -> t.w[wiersze[j].nr];
+            kol = (long long*) powieksz(kol, &rozmiar, n + w -> ile, sizeof(long long));
+            if (n > 0 && c -> kol0 + c -> t.kol[w -> od] < kol[n - 1])
+                rosnace = 0;
+            for (int x = 0; x < w -> ile; x++)
+                kol[n++] = c -> kol0 + c -> t.kol[w -> od + x];
+        }
+        if (!rosnace)
+            qsort(kol, (size_t) n, sizeof(long long), porownaj_liczby);
+        f(kontekst, wiersze[i].wiersz, kol, n);
+        i = j;
+    }
+    free(kol);
+    free(wiersze);
+}
+
+/**
+ * Reprezentuje odbiorcę wiersza gry, któremu przekazuje się wiersze planszy skupiska
+ *
+ * 'f', 'kontekst' - odbiorca wiersza gry i jego dane
+ * 'wiersz0', 'kol0' - współrzędne gry komórki (0, 0) planszy skupiska
+ * 'kol', 'rozmiar' - kolumny wiersza we współrzędnych gry i ich pojemność
+ */
+typedef struct PrzeliczanieWiersza_
+{
+    OdbiorcaWierszaGry f;
+    void* kontekst;
+    long long wiersz0;
+    long long kol0;
+    long long* kol;
+    int rozmiar;
+} PrzeliczanieWiersza;
+
+/**
+ * Przekazuje wiersz 'wiersz' planszy skupiska odbiorcy wiersza gry opisanemu przez
+ * 'kontekst', przeliczając współrzędne
+ */
+static void przelicz_wiersz(void* kontekst, int wiersz, const int* kol, int n)
+{
+    PrzeliczanieWiersza* p = (PrzeliczanieWiersza*) kontekst;
+    p -> kol = (long long*) powieksz(p -> kol, &p -> rozmiar, n, sizeof(long long));
+    for (int i = 0; i < n; i++)
+        p -> kol[i] = p -> kol0 + kol[i];
+    p -> f(p -> kontekst, p -> wiersz0 + wiersz, p -> kol, n);
+}
+
+/**
+ * Przekazuje odbiorcy 'f' niepuste wiersze planszy gry 'g' w kolejności rosnących numerów
+ *
+ * Plansze jednego skupiska przegląda się wprost, a kilka skupisk najpierw się kopiuje
+ * (zob. przegladaj_kopie)
+ */
+static void przegladaj_gre(const Gra* g, OdbiorcaWierszaGry f, void* kontekst)
+{
+    if (g -> ile_skupisk == 1) {
+        const Skupisko* c = &g -> skupiska[0];
+        PrzeliczanieWiersza p = {f, kontekst, c -> wiersz0, c -> kol0, NULL, 0};
+        g -> silnik -> przegladaj(c -> s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, przelicz_wiersz, &p);
+        free(p.kol);
+    }
+    else if (g -> ile_skupisk > 1) {
+        Kopia* k = kopiuj_stan(g);
+        przegladaj_kopie(k, f, kontekst);
+        usun_kopie(k);
+    }
+}
+
+/**
+ * Pisze do pisarza 'kontekst' wiersz 'wiersz' gry z żywymi komórkami w kolumnach 'kol'
+ * w formacie zrzutu stanu
+ */
+static void pisz_wiersz(void* kontekst, long long wiersz, const long long* kol, int n)
+{
+    Pisarz* p = (Pisarz*) kontekst;
+    pisz_znak(p, '/');
+    pisz_liczbe(p, wiersz);
+    for (int i = 0; i < n; i++) {
+        pisz_znak(p, ' ');
+        pisz_liczbe(p, kol[i]);
+    }
+    pisz_znak(p, '\n');
+}
+
+/**
+ * Pisze zrzut stanu planszy gry 'g' do deskryptora 'fd'
+ *
+ * Zwraca 0, gdy zapis się nie udał, wpp. 1
+ */
+static int zrzuc_stan(const Gra* g, int fd)
+{
+    Pisarz* p = (Pisarz*) malloc(sizeof(Pisarz));
+    p -> fd = fd;
+    p -> blad = 0;
+    p -> ile = 0;
+    przegladaj_gre(g, pisz_wiersz, p);
+    pisz_znak(p, '/');
+    pisz_znak(p, '\n');
+    oproznij_pisarza(p);
+    int wynik = !p -> blad;
+    free(p);
+    return wynik;
+}
+
+/**
+ * Pisze zrzut stanu kopii 'k' do deskryptora 'fd', taki sam jak zrzut stanu gry,
+ * z której ją zrobiono
+ *
+ * Zwraca 0, gdy zapis się nie udał, wpp. 1
+ */
+static int zrzuc_kopie(const Kopia* k, int fd)
+{
+    Pisarz* p = (Pisarz*) malloc(sizeof(Pisarz));
+    p -> fd = fd;
+    p -> blad = 0;
+    p -> ile = 0;
+    przegladaj_kopie(k, pisz_wiersz, p);
+    pisz_znak(p, '/');
+    pisz_znak(p, '\n');
+    oproznij_pisarza(p);
+    int wynik = !p -> blad;
+    free(p);
+    return wynik;
+}
+
+/**
+ * Wersja formatu migawki
+ *
+ * Migawka to binarny zapis planszy, liczby są zapisane od najmłodszego bajtu:
+ * - nagłówek: 8 bajtów "ZYCIEBIN", wersja (4 bajty), 4 bajty zerowe,
+ *   liczba wierszy, liczba komórek i długość danych (po 8 bajtów),
+ * - indeks: dla każdego wiersza rosnąco numer wiersza (8 bajtów), liczba komórek
+ *   (4 bajty), 4 bajty zerowe i położenie jego kolumn w danych (8 bajtów),
+ * - dane: kolumny kolejnych wierszy jako liczby zmiennej długości (7 bitów na bajt),
+ *   pierwsza zakodowana zygzakiem, kolejne jako różnica z poprzednią minus 1,
+ * - suma kontrolna wszystkich wcześniejszych bajtów (8 bajtów), zob. suma_kontrolna.
+ * Migawka w wersji 2 miała różnice kolumn mniejsze niż 2^32, a w wersji 1 także
+ * 32-bitowe współrzędne i we wpisie indeksu numer wiersza i liczbę komórek po 4 bajty.
+ */
+#define WERSJA_MIGAWKI 3
+
+/**
+ * Długości nagłówka, wpisu indeksu i sumy kontrolnej migawki
+ */
+#define NAGLOWEK_MIGAWKI 40
+#define WPIS_MIGAWKI 24
+#define WPIS_MIGAWKI_1 16
+#define SUMA_MIGAWKI 8
+
+/**
+ * Reprezentuje migawkę składaną w pamięci przed zapisem
+ *
+ * 'indeks', 'ile_indeksu' - wpisy indeksu i ich łączna długość w bajtach
+ * 'dane', 'ile_danych' - zakodowane kolumny i ich długość w bajtach
+ * 'rozmiar_*' - pojemności buforów
+ * 'ile_wierszy', 'ile_komorek' - liczba wierszy i komórek planszy
+ * 'blad' - 1, gdy bufor nie dał się powiększyć i migawki nie można zapisać
+ */
+typedef struct Migawka_
+{
+    uint8_t* indeks;
+    size_t ile_indeksu;
+    size_t rozmiar_indeksu;
+    uint8_t* dane;
+    size_t ile_danych;
+    size_t rozmiar_danych;
+    long long ile_wierszy;
+    long long ile_komorek;
+    int blad;
+} Migawka;
+
+/**
+ * Powiększa bufor '*t' o pojemności '*rozmiar' i 'ile' zajętych bajtach tak, aby
+ * zmieściło się w nim jeszcze 'n' bajtów
+ *
+ * Zwraca 0, gdy ich łączna liczba nie mieści się w size_t lub brakuje pamięci, wpp. 1
+ */
+static int powieksz_bufor_migawki(uint8_t** t, size_t* rozmiar, size_t ile, size_t n)
+{
+    if (n > SIZE_MAX - ile)
+        return 0;
+    n += ile;
+    if (n <= *rozmiar)
+        return 1;
+    size_t nowy = *rozmiar > 0 ? *rozmiar : 16;
+    while (nowy < n)
+        nowy = nowy <= SIZE_MAX / 2 ? nowy * 2 : n;
+    uint8_t* x = (uint8_t*) realloc(*t, nowy);
+    if (x == NULL)
+        return 0;
+    *t = x;
+    *rozmiar = nowy;
+    return 1;
+}
+
+/**
+ * Zapisuje 'n' najmłodszych bajtów liczby 'x' od najmłodszego pod adresem 'p'
+ */
+static void zapisz_bajty(uint8_t* p, uint64_t x, int n)
+{
+    for (int i = 0; i < n; i++)
+        p[i] = (uint8_t) (x >> (8 * i));
+}
+
+/**
+ * Zwraca liczbę zapisaną od najmłodszego bajtu w 'n' bajtach pod adresem 'p'
+ */
+static uint64_t czytaj_bajty(const uint8_t* p, int n)
+{
+    uint64_t x = 0;
+    for (int i = 0; i < n; i++)
+        x |= (uint64_t) p[i] << (8 * i);
+    return x;
+}
+
+/**
+ * Zwraca sumę kontrolną 'n' bajtów 'p', zaczynając od sumy 'h'
+ *
+ * To FNV-1a liczone na słowach 8-bajtowych (zapisanych od najmłodszego bajtu)
+ * i na pojedynczych bajtach końcówki krótszej niż słowo.
+ */
+static uint64_t suma_kontrolna(uint64_t h, const uint8_t* p, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        h ^= czytaj_bajty(p + i, 8);
+        h *= 1099511628211ULL;
+    }
+    for (; i < n; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/**
+ * Początkowa wartość sumy kontrolnej FNV-1a
+ */
+#define POCZATEK_SUMY 14695981039346656037ULL
+
+/**
+ * Dopisuje do migawki opisanej przez 'kontekst' wiersz 'wiersz' gry z żywymi komórkami
+ * w kolumnach 'kol'
+ */
+static void dopisz_do_migawki(void* kontekst, long long wiersz, const long long* kol, int n)
+{
+    Migawka* m = (Migawka*) kontekst;
+    // kolumna zajmuje najwyżej 10 bajtów
+    if (m -> blad || !powieksz_bufor_migawki(&m -> indeks, &m -> rozmiar_indeksu, m -> ile_indeksu, WPIS_MIGAWKI)
+        || !powieksz_bufor_migawki(&m -> dane, &m -> rozmiar_danych, m -> ile_danych, 10 * (size_t) n)) {
+        m -> blad = 1;
+        return;
+    }
+    uint8_t* wpis = m -> indeks + m -> ile_indeksu;
+    zapisz_bajty(wpis, (uint64_t) wiersz, 8);
+    zapisz_bajty(wpis + 8, (uint32_t) n, 4);
+    zapisz_bajty(wpis + 12, 0, 4);
+    zapisz_bajty(wpis + 16, (uint64_t) m -> ile_danych, 8);
+    m -> ile_indeksu += WPIS_MIGAWKI;
+    uint8_t* p = m -> dane + m -> ile_danych;
+    for (int i = 0; i < n; i++) {
+        uint64_t x;
+        if (i == 0)
+            x = ((uint64_t) kol[0] << 1) ^ (uint64_t) (kol[0] >> 63);
+        else
+            x = (uint64_t) kol[i] - (uint64_t) kol[i - 1] - 1;
+        while (x >= 0x80) {
+            *p++ = (uint8_t) (x | 0x80);
+            x >>= 7;
+        }
+        *p++ = (uint8_t) x;
+    }
+    m -> ile_danych = (size_t) (p - m -> dane);
+    m -> ile_wierszy++;
+    m -> ile_komorek += n;
+}
+
+/**
+ * Zapisuje migawkę planszy gry 'g' do pliku 'nazwa'
+ *
+ * Zwraca 0, gdy zapis się nie udał, wpp. 1
+ */
+static int zapisz_migawke(const Gra* g, const char* nazwa)
+{
+    Migawka m;
+    memset(&m, 0, sizeof(m));
+    przegladaj_gre(g, dopisz_do_migawki, &m);
+    uint8_t naglowek[NAGLOWEK_MIGAWKI];
+    memset(naglowek, 0, sizeof(naglowek));
+    memcpy(naglowek, "ZYCIEBIN", 8);
+    zapisz_bajty(naglowek + 8, WERSJA_MIGAWKI, 4);
+    zapisz_bajty(naglowek + 16, (uint64_t) m.ile_wierszy, 8);
+    zapisz_bajty(naglowek + 24, (uint64_t) m.ile_komorek, 8);
+    zapisz_bajty(naglowek + 32, (uint64_t) m.ile_danych, 8);
+    // nagłówek i indeks mają długość podzielną przez 8, więc sumę można liczyć częściami
+    uint64_t h = suma_kontrolna(POCZATEK_SUMY, naglowek, sizeof(naglowek));
+    h = suma_kontrolna(h, m.indeks, m.ile_indeksu);
+    h = suma_kontrolna(h, m.dane, m.ile_danych);
+    uint8_t suma[SUMA_MIGAWKI];
+    zapisz_bajty(suma, h, SUMA_MIGAWKI);
+    int wynik = 0;
+    int fd = m.blad ? -1 : open(nazwa, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0) {
+        Pisarz* p = (Pisarz*) malloc(sizeof(Pisarz));
+        p -> fd = fd;
+        p -> blad = 0;
+        p -> ile = 0;
+        pisz_bajty(p, naglowek, sizeof(naglowek));
+        pisz_bajty(p, m.indeks, m.ile_indeksu);
+        pisz_bajty(p, m.dane, m.ile_danych);
+        pisz_bajty(p, suma, sizeof(suma));
+        oproznij_pisarza(p);
+        wynik = !p -> blad;
+        free(p);
+        if (close(fd) != 0)
+            wynik = 0;
+    }
+    free(m.indeks);
+    free(m.dane);
+    return wynik;
+}
+
+/**
+ * Dodaje do planszy gry 'g' komórki z migawki zapisanej w pliku 'nazwa', czytając plik
+ * zmapowany do pamięci
+ *
+ * Czyta migawki w wersjach od 1 do WERSJA_MIGAWKI. Komórki dzieli się na skupiska,
+ * jak w czytaj_plansze.
+ * Zwraca 0 z opisem błędu w grze, gdy pliku nie da się przeczytać lub migawka jest
+ * niepoprawna, wpp. 1
+ */
+static int wczytaj_migawke(Gra* g, const char* nazwa)
+{
+    Czytnik c;
+    if (!otworz_czytnik(&c, nazwa)) {
+        snprintf(g -> blad, ROZMIAR_BLEDU, "nie mozna otworzyc pliku: %s", nazwa);
+        return 0;
+    }
+    const uint8_t* p = (const uint8_t*) c.p;
+    size_t dlugosc = (size_t) (c.koniec - c.p);
+    const char* blad = NULL;
+    uint64_t ile_wierszy = 0;
+    uint64_t ile_danych = 0;
+    uint64_t wersja = 0;
+    size_t wpis_indeksu = WPIS_MIGAWKI;
+    if (dlugosc < NAGLOWEK_MIGAWKI + SUMA_MIGAWKI || memcmp(p, "ZYCIEBIN", 8) != 0)
+        blad = "to nie jest migawka";
+    else if ((wersja = czytaj_bajty(p + 8, 4)) < 1 || wersja > WERSJA_MIGAWKI)
+        blad = "nieznana wersja migawki";
+    else {
+        if (wersja == 1)
+            wpis_indeksu = WPIS_MIGAWKI_1;
+        ile_wierszy = czytaj_bajty(p + 16, 8);
+        ile_danych = czytaj_bajty(p + 32, 8);
+        size_t reszta = dlugosc - NAGLOWEK_MIGAWKI - SUMA_MIGAWKI;
+        if (ile_wierszy > reszta / wpis_indeksu || ile_danych != reszta - ile_wierszy * wpis_indeksu)
+            blad = "niepoprawna dlugosc migawki";
+        else if (suma_kontrolna(POCZATEK_SUMY, p, dlugosc - SUMA_MIGAWKI)
+                 != czytaj_bajty(p + dlugosc - SUMA_MIGAWKI, SUMA_MIGAWKI))
+            blad = "niezgodna suma kontrolna";
+    }
+    // w wersji 1 numer wiersza i liczba komórek mają po 4 bajty
+    int pole_liczby = wersja == 1 ? 4 : 8;
+    int pole_polozenia = wersja == 1 ? 8 : 16;
+    const uint8_t* indeks = p + NAGLOWEK_MIGAWKI;
+    const uint8_t* dane = indeks + ile_wierszy * wpis_indeksu;
+    long long* kol = NULL;
+    int rozmiar = 0;
+    long long poprzedni = LLONG_MIN;
+    for (uint64_t i = 0; blad == NULL && i < ile_wierszy; i++) {
+        const uint8_t* wpis = indeks + i * wpis_indeksu;
+        long long wiersz = wersja == 1 ? (int) (uint32_t) czytaj_bajty(wpis, 4)
+                                       : (long long) czytaj_bajty(wpis, 8);
+        uint64_t n = czytaj_bajty(wpis + pole_liczby, 4);
+        uint64_t od = czytaj_bajty(wpis + pole_polozenia, 8);
+        uint64_t do_ = i + 1 < ile_wierszy ? czytaj_bajty(wpis + wpis_indeksu + pole_polozenia, 8)
+                                           : ile_danych;
+        if (wiersz <= poprzedni || wiersz > ZAKRES_WSPOLRZEDNYCH || wiersz < -ZAKRES_WSPOLRZEDNYCH
+            || n == 0 || n > INT_MAX || od > do_ || do_ > ile_danych) {
+            blad = "niepoprawny indeks migawki";
+            break;
+        }
+        poprzedni = wiersz;
+        kol = (long long*) powieksz(kol, &rozmiar, (int) n, sizeof(long long));
+        const uint8_t* q = dane + od;
+        const uint8_t* koniec = dane + do_;
+        long long x = 0;
+        uint64_t j = 0;
+        for (; j < n; j++) {
+            uint64_t v = 0;
+            int przesun = 0;
+            while (q < koniec && (*q & 0x80) && przesun < 70) {
+                v |= (uint64_t) (*q++ & 0x7f) << przesun;
+                przesun += 7;
+            }
+            if (q == koniec || przesun >= 70)
+                break;
+            v |= (uint64_t) *q++ << przesun;
+            if (j == 0)
+                x = (long long) (v >> 1) ^ -(long long) (v & 1);
+            else if (v <= UINT32_MAX
+                     || (wersja >= 3 && v < (uint64_t) ZAKRES_WSPOLRZEDNYCH - (uint64_t) x))
+                x += (long long) v + 1;
+            else
+                break;
+            if (x < -ZAKRES_WSPOLRZEDNYCH || x > ZAKRES_WSPOLRZEDNYCH)
+                break;
+            kol[j] = x;
+        }
+        if (j < n || q != koniec)
+            blad = "niepoprawne dane migawki";
+        else if (!dodaj_wiersz_gry(g, wiersz, kol, (int) n))
+            blad = "za duzo odleglych skupisk komorek";
+    }
+    free(kol);
+    zamknij_czytnik(&c);
+    if (blad != NULL) {
+        snprintf(g -> blad, ROZMIAR_BLEDU, "%s: %s", nazwa, blad);
+        return 0;
+    }
+    przygotuj_skupiska(g);
+    return 1;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek planszy skupiska 'c' gry 'g'
+ *
+ * Gdy silnik ich nie śledzi, przegląda całą plansze
+ */
+static void obszar_skupiska(const Gra* g, const Skupisko* c, Obszar* o)
+{
+    if (g -> silnik -> obszar != NULL) {
+        g -> silnik -> obszar(c -> s, o);
+        return;
+    }
+    memset(o, 0, sizeof(Obszar));
+    g -> silnik -> przegladaj(c -> s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_obszar, o);
+}
+
+/**
+ * Reprezentuje populację i najmniejszy prostokąt zawierający żywe komórki gry,
+ * jak Obszar, ale we współrzędnych gry
+ */
+typedef struct ObszarGry_
+{
+    long long populacja;
+    long long w_min;
+    long long w_max;
+    long long k_min;
+    long long k_max;
+} ObszarGry;
+
+/**
+ * Zapisuje w 'o' obszar skupiska 'c' gry 'g' we współrzędnych gry
+ */
+static void obszar_skupiska_w_grze(const Gra* g, const Skupisko* c, ObszarGry* o)
+{
+    Obszar x;
+    obszar_skupiska(g, c, &x);
+    o -> populacja = x.populacja;
+    o -> w_min = c -> wiersz0 + x.w_min;
+    o -> w_max = c -> wiersz0 + x.w_max;
+    o -> k_min = c -> kol0 + x.k_min;
+    o -> k_max = c -> kol0 + x.k_max;
+}
+
+/**
+ * Zapisuje w 'o' populację i prostokąt żywych komórek gry 'g'
+ */
+static void obszar_gry(const Gra* g, ObszarGry* o)
+{
+    memset(o, 0, sizeof(ObszarGry));
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        ObszarGry x;
+        obszar_skupiska_w_grze(g, &g -> skupiska[i], &x);
+        if (x.populacja == 0)
+            continue;
+        if (o -> populacja == 0)
+            *o = x;
+        else {
+            o -> populacja += x.populacja;
+            o -> w_min = x.w_min < o -> w_min ? x.w_min : o -> w_min;
+            o -> w_max = x.w_max > o -> w_max ? x.w_max : o -> w_max;
+            o -> k_min = x.k_min < o -> k_min ? x.k_min : o -> k_min;
+            o -> k_max = x.k_max > o -> k_max ? x.k_max : o -> k_max;
+        }
+    }
+}
+
+/**
+ * Pisze do 'f' populację i najmniejszy prostokąt z żywymi komórkami planszy gry 'g'
+ * oraz liczniki silnika każdego skupiska
+ */
+static void pisz_statystyki(const Gra* g, FILE* f)
+{
+    ObszarGry o;
+    obszar_gry(g, &o);
+    fprintf(f, "populacja %lld", o.populacja);
+    if (o.populacja > 0)
+        fprintf(f, ", wiersze %lld..%lld, kolumny %lld..%lld", o.w_min, o.w_max, o.k_min, o.k_max);
+    fprintf(f, "\n");
+    if (g -> ile_skupisk > 1)
+        fprintf(f, "skupiska: %d\n", g -> ile_skupisk);
+    for (int i = 0; i < g -> ile_skupisk && g -> silnik -> statystyki != NULL; i++)
+        g -> silnik -> statystyki(g -> skupiska[i].s, f);
+    fflush(f);
+}
+
+/**
+ * Zwraca największą wartość bezwzględną współrzędnych prostokąta obszaru 'o'
+ */
+static long long najdalsza_wspolrzedna(const Obszar* o)
+{
+    long long m = 0;
+    long long x[4] = {o -> w_min, o -> w_max, o -> k_min, o -> k_max};
+    for (int i = 0; i < 4; i++)
+        if ((x[i] < 0 ? -x[i] : x[i]) > m)
+            m = x[i] < 0 ? -x[i] : x[i];
+    return m;
+}
+
+/**
+ * Zwraca największą wartość bezwzględną współrzędnych prostokąta obszaru gry 'o'
+ */
+static long long najdalsza_wspolrzedna_gry(const ObszarGry* o)
+{
+    long long m = 0;
+    long long x[4] = {o -> w_min, o -> w_max, o -> k_min, o -> k_max};
+    for (int i = 0; i < 4; i++)
+        if ((x[i] < 0 ? -x[i] : x[i]) > m)
+            m = x[i] < 0 ? -x[i] : x[i];
+    return m;
+}
+
+/**
+ * Zwraca odległość prostokątów obszarów 'a' i 'b' w metryce maksimum: największą
+ * różnicę współrzędnych najbliższych komórek w jednym kierunku, niedodatnią, gdy
+ * prostokąty nachodzą na siebie
+ */
+static long long odleglosc_obszarow(const ObszarGry* a, const ObszarGry* b)
+{
+    long long dy = a -> w_min - b -> w_max > b -> w_min - a -> w_max ? a -> w_min - b -> w_max
+                                                                    : b -> w_min - a -> w_max;
+    long long dx = a -> k_min - b -> k_max > b -> k_min - a -> k_max ? a -> k_min - b -> k_max
+                                                                    : b -> k_min - a -> k_max;
+    return dy > dx ? dy : dx;
+}
+
+/**
+ * Zastępuje plansze skupiska 'c' gry 'g' nową planszą, której komórka (0, 0) to komórka
+ * ('wiersz0', 'kol0') gry
+ */
+static void nowa_plansza_skupiska(Gra* g, Skupisko* c, long long wiersz0, long long kol0)
+{
+    g -> silnik -> czysc(c -> s);
+    c -> s = g -> silnik -> tworz(&g -> ustawienia);
+    c -> wiersz0 = wiersz0;
+    c -> kol0 = kol0;
+    g -> uklad++;
+}
+
+/**
+ * Dzieli skupisko 'i' gry 'g' na dwa wzdłuż najszerszej przerwy między jego wierszami
+ * lub kolumnami, gdy jego prostokąt ma bok dłuższy niż SRODEK_SILNIKA, a przerwa
+ * ma co najmniej PRZERWA_SKUPISK
+ *
+ * Komórki przed przerwą zostają w skupisku 'i', a pozostałe trafiają do nowego
+ * skupiska z tym samym początkiem.
+ * Zwraca 1, gdy skupisko zostało podzielone, wpp. 0
+ */
+static int rozdziel_skupisko(Gra* g, int i)
+{
+    Obszar o;
+    obszar_skupiska(g, &g -> skupiska[i], &o);
+    if ((long long) o.w_max - o.w_min <= SRODEK_SILNIKA && (long long) o.k_max - o.k_min <= SRODEK_SILNIKA)
+        return 0;
+    Tablice a;
+    memset(&a, 0, sizeof(a));
+    g -> silnik -> przegladaj(g -> skupiska[i].s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dopisz_do_tablic, &a);
+    // podział wierszy: wiersze od 'ciecie_w' trafiają do nowego skupiska
+    int ciecie_w = 0;
+    long long przerwa_w = 0;
+    for (int j = 1; j < a.ile_w; j++)
+        if ((long long) a.w[j].wiersz - a.w[j - 1].wiersz > przerwa_w) {
+            przerwa_w = (long long) a.w[j].wiersz - a.w[j - 1].wiersz;
+            ciecie_w = j;
+        }
+    // podział kolumn: kolumny od 'ciecie_k' trafiają do nowego skupiska
+    int* kol = (int*) malloc (((size_t) a.ile_kol + 1) * sizeof(int));
+    memcpy(kol, a.kol, (size_t) a.ile_kol * sizeof(int));
+    qsort(kol, (size_t) a.ile_kol, sizeof(int), porownaj_kolumny);
+    long long ciecie_k = 0;
+    long long przerwa_k = 0;
+    for (int j = 1; j < a.ile_kol; j++)
+        if ((long long) kol[j] - kol[j - 1] > przerwa_k) {
+            przerwa_k = (long long) kol[j] - kol[j - 1];
+            ciecie_k = kol[j];
+        }
+    free(kol);
+    int wynik = przerwa_w >= PRZERWA_SKUPISK || przerwa_k >= PRZERWA_SKUPISK;
+    if (wynik) {
+        Skupisko* c = &g -> skupiska[i];
+        nowa_plansza_skupiska(g, c, c -> wiersz0, c -> kol0);
+        int j = dodaj_skupisko(g, c -> wiersz0, c -> kol0);
+        void* s[2] = {g -> skupiska[i].s, g -> skupiska[j].s};
+        for (int r = 0; r < a.ile_w; r++) {
+            const int* p = a.kol + a.w[r].od;
+            int n = a.w[r].ile;
+            if (przerwa_w >= przerwa_k) {
+                g -> silnik -> dodaj_wiersz(s[r >= ciecie_w], a.w[r].wiersz, p, n);
+                continue;
+            }
+            int m = 0;
+            while (m < n && p[m] < ciecie_k)
+                m++;
+            if (m > 0)
+                g -> silnik -> dodaj_wiersz(s[0], a.w[r].wiersz, p, m);
+            if (m < n)
+                g -> silnik -> dodaj_wiersz(s[1], a.w[r].wiersz, p + m, n - m);
+        }
+        g -> silnik -> przygotuj(s[0]);
+        g -> silnik -> przygotuj(s[1]);
+    }
+    free(a.w);
+    free(a.kol);
+    return wynik;
+}
+
+/**
+ * Scala skupisko 'j' gry 'g' ze skupiskiem 'i' < 'j', o obszarach 'a' i 'b', gdy
+ * prostokąt ich żywych komórek ma boki nie dłuższe niż dwa razy SRODEK_SILNIKA
+ *
+ * Komórka (0, 0) planszy scalonego skupiska leży w środku tego prostokąta, a skupisko
+ * 'j' się usuwa.
+ * Zwraca 1, gdy skupiska zostały scalone, wpp. 0
+ */
+static int scal_skupiska(Gra* g, int i, int j, const ObszarGry* a, const ObszarGry* b)
+{
+    long long w_min = a -> w_min < b -> w_min ? a -> w_min : b -> w_min;
+    long long w_max = a -> w_max > b -> w_max ? a -> w_max : b -> w_max;
+    long long k_min = a -> k_min < b -> k_min ? a -> k_min : b -> k_min;
+    long long k_max = a -> k_max > b -> k_max ? a -> k_max : b -> k_max;
+    if (w_max - w_min > 2 * SRODEK_SILNIKA || k_max - k_min > 2 * SRODEK_SILNIKA)
+        return 0;
+    long long wiersz0 = w_min + (w_max - w_min) / 2;
+    long long kol0 = k_min + (k_max - k_min) / 2;
+    Tablice t[2];
+    long long dy[2];
+    long long dx[2];
+    int nr[2] = {i, j};
+    for (int x = 0; x < 2; x++) {
+        const Skupisko* c = &g -> skupiska[nr[x]];
+        memset(&t[x], 0, sizeof(Tablice));
+        g -> silnik -> przegladaj(c -> s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dopisz_do_tablic, &t[x]);
+        dy[x] = c -> wiersz0 - wiersz0;
+        dx[x] = c -> kol0 - kol0;
+    }
+    usun_skupisko(g, j);
+    Skupisko* c = &g -> skupiska[i];
+    nowa_plansza_skupiska(g, c, wiersz0, kol0);
+    int* kol = (int*) malloc (((size_t) t[0].ile_kol + (size_t) t[1].ile_kol + 1) * sizeof(int));
+    int r[2] = {0, 0};
+    while (r[0] < t[0].ile_w || r[1] < t[1].ile_w) {
+        long long w[2];
+        for (int x = 0; x < 2; x++)
+            w[x] = r[x] < t[x].ile_w ? t[x].w[r[x]].wiersz + dy[x] : LLONG_MAX;
+        long long wiersz = w[0] < w[1] ? w[0] : w[1];
+        int n = 0;
+        int p[2] = {0, 0};
+        int ile[2] = {0, 0};
+        const int* z[2] = {NULL, NULL};
+        for (int x = 0; x < 2; x++)
+            if (w[x] == wiersz) {
+                z[x] = t[x].kol + t[x].w[r[x]].od;
+                ile[x] = t[x].w[r[x]].ile;
+                r[x]++;
+            }
+        // scalanie dwóch rosnących ciągów kolumn
+        while (p[0] < ile[0] || p[1] < ile[1]) {
+            long long k0 = p[0] < ile[0] ? z[0][p[0]] + dx[0] : LLONG_MAX;
+            long long k1 = p[1] < ile[1] ? z[1][p[1]] + dx[1] : LLONG_MAX;
+            kol[n++] = (int) (k0 < k1 ? k0 : k1);
+            p[k0 < k1 ? 0 : 1]++;
+        }
+        g -> silnik -> dodaj_wiersz(c -> s, (int) wiersz, kol, n);
+    }
+    g -> silnik -> przygotuj(c -> s);
+    free(kol);
+    for (int x = 0; x < 2; x++) {
+        free(t[x].w);
+        free(t[x].kol);
+    }
+    return 1;
+}
+
+/**
+ * Zwraca, czy plansza trzymająca dopełnienie generacji, gdy 'dopelniona' jest niezerowe,
+ * będzie je trzymać po 'n' > 0 generacjach reguły 'r' (zob. regula_kroku)
+ *
+ * Dopełnienie albo zostaje, albo przeplata się ze zwykłą generacją, więc wystarczą
+ * dwa kroki reguły.
+ */
+static int dopelniona_po(const Regula* r, int dopelniona, long long n)
+{
+    Regula q;
+    regula_kroku(r, &dopelniona, &q);
+    if ((n - 1) % 2 == 1)
+        regula_kroku(r, &dopelniona, &q);
+    return dopelniona;
+}
+
+/**
+ * Uaktualnia liczbę generacji, które plansza gry 'g' policzy bez sprawdzania zasięgu
+ *
+ * Puste skupiska się usuwa. Skupisko o boku prostokąta żywych komórek dłuższym niż
+ * SRODEK_SILNIKA dzieli się wzdłuż szerokiej przerwy (zob. rozdziel_skupisko),
+ * a skupiska bliższe niż PRZERWA_SKUPISK scala (zob. scal_skupiska). Gdy żywe komórki
+ * skupiska leżą dalej niż SRODEK_SILNIKA od (0, 0) jego planszy, plansza jest
+ * przesuwana tak, żeby środek ich prostokąta był w (0, 0), a początek skupiska
+ * poprawiany o to przesunięcie.
+ * Żywe komórki oddalają się o najwyżej jedną komórkę na generację, więc skupiska
+ * liczy się osobno, dopóki nie wyjdą poza zasięg silnika, a komórki różnych skupisk
+ * nie mają wspólnych sąsiadów. Bez względu na zasięg silnika to samo, liczone
+ * we współrzędnych gry aż do ZAKRES_WSPOLRZEDNYCH, trafia do 'bez_zblizenia'.
+ * Zwraca 0 z opisem błędu w grze, gdy prostokąt żywych komórek skupiska nie mieści się
+ * w zasięgu silnika lub zakresie współrzędnych albo skupiska zbliżyły się na tyle,
+ * że nie da się ich liczyć osobno ani scalić, wpp. 1
+ */
+static int sprawdz_zasieg(Gra* g)
+{
+    for (int i = g -> ile_skupisk - 1; i >= 0; i--) {
+        Obszar o;
+        obszar_skupiska(g, &g -> skupiska[i], &o);
+        if (o.populacja == 0)
+            usun_skupisko(g, i);
+    }
+    for (int i = 0; i < g -> ile_skupisk; i++)
+        while (g -> ile_skupisk < NAJWIECEJ_SKUPISK && rozdziel_skupisko(g, i))
+            ;
+    ObszarGry* ob = (ObszarGry*) malloc (((size_t) g -> ile_skupisk + 1) * sizeof(ObszarGry));
+    for (int i = 0; i < g -> ile_skupisk; i++)
+        obszar_skupiska_w_grze(g, &g -> skupiska[i], &ob[i]);
+    for (int i = 0; i < g -> ile_skupisk; i++)
+        for (int j = i + 1; j < g -> ile_skupisk; j++)
+            if (odleglosc_obszarow(&ob[i], &ob[j]) < PRZERWA_SKUPISK
+                && scal_skupiska(g, i, j, &ob[i], &ob[j])) {
+                obszar_skupiska_w_grze(g, &g -> skupiska[i], &ob[i]);
+                ob[j] = ob[g -> ile_skupisk];
+                j = i;
+            }
+    g -> bez_zblizenia = LLONG_MAX;
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        long long m = najdalsza_wspolrzedna_gry(&ob[i]);
+        if (m >= ZAKRES_WSPOLRZEDNYCH) {
+            free(ob);
+            g -> bez_sprawdzania = 0;
+            snprintf(g -> blad, ROZMIAR_BLEDU, "plansza przekracza zakres wspolrzednych");
+            return 0;
+        }
+        if (ZAKRES_WSPOLRZEDNYCH - m < g -> bez_zblizenia)
+            g -> bez_zblizenia = ZAKRES_WSPOLRZEDNYCH - m;
+        // komórki skupisk oddalonych o d nie mają wspólnych sąsiadów przez (d - 1) / 2 generacji
+        for (int j = 0; j < i; j++) {
+            long long d = (odleglosc_obszarow(&ob[i], &ob[j]) - 1) / 2;
+            if (d < g -> bez_zblizenia)
+                g -> bez_zblizenia = d;
+        }
+    }
+    g -> bez_sprawdzania = SRODEK_SILNIKA < g -> bez_zblizenia ? SRODEK_SILNIKA : g -> bez_zblizenia;
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        Skupisko* c = &g -> skupiska[i];
+        Obszar o;
+        obszar_skupiska(g, c, &o);
+        long long m = najdalsza_wspolrzedna(&o);
+        if (m > SRODEK_SILNIKA) {
+            long long dy = -(((long long) o.w_min + o.w_max) / 2);
+            long long dx = -(((long long) o.k_min + o.k_max) / 2);
+            g -> silnik -> przesun(c -> s, (int) dy, (int) dx);
+            c -> wiersz0 -= dy;
+            c -> kol0 -= dx;
+            g -> uklad++;
+            o.w_min += (int) dy;
+            o.w_max += (int) dy;
+            o.k_min += (int) dx;
+            o.k_max += (int) dx;
+            m = najdalsza_wspolrzedna(&o);
+        }
+        if (ZASIEG_SILNIKA - m < g -> bez_sprawdzania)
+            g -> bez_sprawdzania = ZASIEG_SILNIKA - m;
+    }
+    free(ob);
+    if (g -> bez_sprawdzania <= 0) {
+        g -> bez_sprawdzania = 0;
+        snprintf(g -> blad, ROZMIAR_BLEDU, "plansza przekracza zasieg silnika");
+        return 0;
+    }
+    return 1;
+}
+
+/**
+ * Próbuje obliczyć naraz więcej niż 'bez_sprawdzania', ale najwyżej 'n' kolejnych
+ * generacji planszy gry 'g', której silnik to umie (zob. Silnik)
+ *
+ * Skupiska nie zbliżą się do siebie ani do krańca zakresu współrzędnych przez
+ * 'bez_zblizenia' generacji, więc każde można liczyć osobno, a zasięg silnika ogranicza
+ * tylko rozmiar jego żywych komórek, bo silnik po skoku przesuwa je do (0, 0). Gdy
+ * któreś skupisko urosłoby ponad SRODEK_SILNIKA, próbuje się skoku o połowę krótszego.
+ * Próbne skoki nie zmieniają plansz, więc skupiska skaczą wszystkie albo żadne.
+ * Zwraca liczbę obliczonych generacji, 0, gdy nie udało się skoczyć
+ */
+static long long skok_daleki(Gra* g, long long n)
+{
+    if (g -> silnik -> skok == NULL || (g -> regula.narodziny & 1))
+        return 0;
+    long long m = g -> bez_zblizenia < n ? g -> bez_zblizenia : n;
+    for (; m > g -> bez_sprawdzania; m /= 2) {
+        long long dy;
+        long long dx;
+        int i = 0;
+        while (i < g -> ile_skupisk
+               && g -> silnik -> skok(g -> skupiska[i].s, m, SRODEK_SILNIKA, &dy, &dx, 0))
+            i++;
+        if (i < g -> ile_skupisk)
+            continue;
+        for (i = 0; i < g -> ile_skupisk; i++) {
+            Skupisko* c = &g -> skupiska[i];
+            g -> silnik -> skok(c -> s, m, SRODEK_SILNIKA, &dy, &dx, 1);
+            c -> wiersz0 -= dy;
+            c -> kol0 -= dx;
+        }
+        g -> uklad++;
+        g -> bez_sprawdzania = 0;
+        return m;
+    }
+    return 0;
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy gry 'g', pilnując, żeby żywe komórki
+ * nie wyszły poza zasięg silnika, a skupiska nie wpłynęły na siebie
+ * (zob. sprawdz_zasieg)
+ *
+ * Silnik, który to umie, skacze naraz o tyle generacji, ile pozwalają odległości
+ * skupisk (zob. skok_daleki), a nie tylko o 'bez_sprawdzania'.
+ * Zwraca 0, gdy żywe komórki nie mieszczą się w zasięgu silnika, wpp. 1
+ */
+static int licz_w_zasiegu(Gra* g, long long n)
+{
+    while (n > 0) {
+        if (g -> bez_sprawdzania == 0 && !sprawdz_zasieg(g))
+            return 0;
+        if (n > g -> bez_sprawdzania) {
+            long long k = skok_daleki(g, n);
+            if (k > 0) {
+                n -= k;
+                continue;
+            }
+        }
+        int m = (int) (g -> bez_sprawdzania < n ? g -> bez_sprawdzania : n);
+        for (int i = 0; i < g -> ile_skupisk; i++) {
+            int dopelniona = g -> dopelniona;
+            licz_generacje(g -> silnik, g -> skupiska[i].s, &g -> regula, &dopelniona, m);
+        }
+        g -> dopelniona = dopelniona_po(&g -> regula, g -> dopelniona, m);
+        g -> bez_sprawdzania -= m;
+        g -> bez_zblizenia -= m;
+        n -= m;
+    }
+    return 1;
+}
+
+/**
+ * Liczba miejsc tablicy historii generacji
+ */
+#define ROZMIAR_HISTORII 4096
+
+/**
+ * Co ile generacji zapisuje się odcisk w historii
+ *
+ * Kroki silników uaktualniają odcisk, ale sprowadzenie go do wspólnego położenia
+ * kosztuje dwa potęgowania, a rzadsze wpisy pozwalają historii pamiętać dłuższe okresy
+ */
+#define ODSTEP_ODCISKOW 64
+
+/**
+ * Przez ile generacji każdego liczenia szuka cykli silnik, który umie skakać daleko
+ * (zob. licz_z_historia)
+ */
+#define ROZBIEG_ODCISKOW (ODSTEP_ODCISKOW * ODSTEP_ODCISKOW)
+
+/**
+ * Reprezentuje generację zapamiętaną w historii
+ *
+ * 'hasz' - hasz generacji przesuniętej tak, żeby róg prostokąta jej żywych komórek był
+ *          w (0, 0)
+ * 'populacja' - liczba żywych komórek
+ * 'generacja' - numer generacji
+ * 'dopelniona' - 1, gdy plansza trzymała dopełnienie generacji
+ * 'zajety' - 1, gdy wpis zawiera generacje
+ */
+typedef struct WpisHistorii_
+{
+    uint64_t hasz;
+    long long populacja;
+    long long generacja;
+    int dopelniona;
+    int zajety;
+} WpisHistorii;
+
+/**
+ * Reprezentuje historię rozgrywki, w której szuka się cykli
+ *
+ * Wpisy tworzą tablicę mieszającą bez łańcuchów: nowa generacja zajmuje miejsce
+ * wyznaczone przez swój hasz, zastępując poprzedniego lokatora.
+ *
+ * 'wpisy' - zapamiętane generacje
+ * 'generacja' - numer aktualnej generacji
+ * 'okres' - okres znalezionego cyklu, 0, gdy cyklu jeszcze nie znaleziono
+ * 'dy', 'dx' - przesunięcie generacji po jednym okresie
+ * 'od' - numer generacji, w której znaleziono cykl
+ */
+typedef struct Historia_
+{
+    WpisHistorii wpisy[ROZMIAR_HISTORII];
+    long long generacja;
+    int okres;
+    int dy;
+    int dx;
+    long long od;
+} Historia;
+
+/**
+ * Tworzy pustą historię rozgrywki zaczynającej się od generacji 0
+ */
+static Historia* tworz_historie(void)
+{
+    return (Historia*) calloc (1, sizeof(Historia));
+}
+
+/**
+ * Reprezentuje spis żywych komórek generacji gry
+ *
+ * 'x' - kolejne niepuste wiersze w kolejności rosnących numerów, każdy zapisany jako
+ *       numer wiersza, liczba komórek i ich rosnące kolumny
+ * 'ile', 'rozmiar' - liczba zajętych i wszystkich miejsc 'x'
+ */
+typedef struct SpisKomorek_
+{
+    long long* x;
+    int ile;
+    int rozmiar;
+} SpisKomorek;
+
+/**
+ * Dopisuje do spisu 'kontekst' wiersz 'wiersz' gry z żywymi komórkami w kolumnach 'kol'
+ */
+static void dopisz_do_spisu(void* kontekst, long long wiersz, const long long* kol, int n)
+{
+    SpisKomorek* s = (SpisKomorek*) kontekst;
+    s -> x = (long long*) powieksz(s -> x, &s -> rozmiar, s -> ile + n + 2, sizeof(long long));
+    s -> x[s -> ile++] = wiersz;
+    s -> x[s -> ile++] = n;
+    memcpy(s -> x + s -> ile, kol, (size_t) n * sizeof(long long));
+    s -> ile += n;
+}
+
+/**
+ * Porównuje generację ze spisu 'b' z generacją ze spisu 'a' przesuniętą
+ * o 'dy' wierszy i 'dx' kolumn
+ *
+ * Zwraca 1, gdy są równe, wpp. 0
+ */
+static int rowne_po_przesunieciu(const SpisKomorek* a, const SpisKomorek* b, long long dy, long long dx)
+{
+    if (a -> ile != b -> ile)
+        return 0;
+    int i = 0;
+    while (i < a -> ile) {
+        if (a -> x[i] + dy != b -> x[i] || a -> x[i + 1] != b -> x[i + 1])
+            return 0;
+        int n = (int) a -> x[i + 1];
+        i += 2;
+        for (int j = 0; j < n; j++, i++)
+            if (a -> x[i] + dx != b -> x[i])
+                return 0;
+    }
+    return 1;
+}
+
+/**
+ * Zapisuje w 'o' odcisk planszy gry 'g' we współrzędnych gry
+ *
+ * Hasz skupiska przesuwa się o początek jego planszy, a róg to najmniejszy wiersz
+ * i najmniejsza kolumna rogów niepustych skupisk
+ */
+static void odcisk_gry(const Gra* g, Odcisk* o)
+{
+    memset(o, 0, sizeof(Odcisk));
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        const Skupisko* c = &g -> skupiska[i];
+        Odcisk x;
+        g -> silnik -> odcisk(c -> s, &x);
+        if (x.populacja == 0)
+            continue;
+        uint64_t m = mnoz_mod(potega_mod(PODSTAWA_WIERSZY, c -> wiersz0),
+                              potega_mod(PODSTAWA_KOLUMN, c -> kol0));
+        o -> hasz += mnoz_mod(x.hasz, m);
+        if (o -> hasz >= MODUL_HASZU)
+            o -> hasz -= MODUL_HASZU;
+        if (o -> populacja == 0 || c -> wiersz0 + x.wiersz < o -> wiersz)
+            o -> wiersz = c -> wiersz0 + x.wiersz;
+        if (o -> populacja == 0 || c -> kol0 + x.kol < o -> kol)
+            o -> kol = c -> kol0 + x.kol;
+        o -> populacja += x.populacja;
+    }
+}
+
+/**
+ * Sprowadza hasz odcisku 'o' do położenia, w którym lewy górny róg prostokąta żywych
+ * komórek jest w (0, 0)
+ *
+ * Róg pustej generacji ustawia na (0, 0)
+ */
+static void normalizuj_odcisk(Odcisk* o)
+{
+    if (o -> populacja == 0)
+        o -> wiersz = o -> kol = 0;
+    uint64_t m = mnoz_mod(potega_mod(PODSTAWA_WIERSZY, -o -> wiersz),
+                          potega_mod(PODSTAWA_KOLUMN, -o -> kol));
+    o -> hasz = mnoz_mod(o -> hasz, m);
+}
+
+/**
+ * Zastępuje skupiska gry 'g' skupiskami kopii 'k'
+ */
+static void odtworz_plansze(Gra* g, const Kopia* k)
+{
+    const Silnik* silnik = g -> silnik;
+    while (g -> ile_skupisk > 0)
+        usun_skupisko(g, g -> ile_skupisk - 1);
+    for (int i = 0; i < k -> ile_skupisk; i++) {
+        const SkupiskoKopii* c = &k -> skupiska[i];
+        void* s = g -> skupiska[dodaj_skupisko(g, c -> wiersz0, c -> kol0)].s;
+        for (int j = 0; j < c -> t.ile_w; j++)
+            silnik -> dodaj_wiersz(s, c -> t.w[j].wiersz, c -> t.kol + c -> t.w[j].od, c -> t.w[j].ile);
+        silnik -> przygotuj(s);
+    }
+}
+
+/**
+ * Szuka najmniejszego okresu planszy gry 'g' nie większego niż 'p', licząc kolejne
+ * generacje, aż generacja okaże się aktualną przesuniętą tak jak róg prostokąta jej
+ * żywych komórek
+ *
+ * Odciski porównuje się po każdym kroku, a gdy są równe, porównuje się całe generacje.
+ * Przesunięcie we współrzędnych gry zapisuje w '*dy', '*dx'. Po znalezieniu okresu
+ * plansza gry jest generacją aktualną, bo początki skupisk cofają się o przesunięcie,
+ * a gdy okresu nie ma, generację aktualną wczytuje się od nowa, więc szukanie nie
+ * zużywa generacji.
+ * Zwraca okres, 0, gdy po 'p' generacjach nie powtórzyła się generacja aktualna,
+ * lub -1, gdy żywe komórki wyszły poza zasięg silnika
+ */
+static int szukaj_okresu(Gra* g, int p, long long* dy, long long* dx)
+{
+    Odcisk o;
+    odcisk_gry(g, &o);
+    normalizuj_odcisk(&o);
+    int dopelniona0 = g -> dopelniona;
+    Kopia* k = kopiuj_stan(g);
+    SpisKomorek a;
+    SpisKomorek b;
+    memset(&a, 0, sizeof(a));
+    memset(&b, 0, sizeof(b));
+    przegladaj_kopie(k, dopisz_do_spisu, &a);
+    int wynik = 0;
+    for (int q = 1; q <= p && wynik == 0; q++) {
+        if (!licz_w_zasiegu(g, 1)) {
+            wynik = -1;
+            break;
+        }
+        Odcisk x;
+        odcisk_gry(g, &x);
+        normalizuj_odcisk(&x);
+        if (x.hasz != o.hasz || x.populacja != o.populacja || g -> dopelniona != dopelniona0)
+            continue;
+        b.ile = 0;
+        przegladaj_gre(g, dopisz_do_spisu, &b);
+        if (rowne_po_przesunieciu(&a, &b, x.wiersz - o.wiersz, x.kol - o.kol)) {
+            *dy = x.wiersz - o.wiersz;
+            *dx = x.kol - o.kol;
+            for (int i = 0; i < g -> ile_skupisk; i++) {
+                g -> skupiska[i].wiersz0 -= *dy;
+                g -> skupiska[i].kol0 -= *dx;
+            }
+            g -> uklad++;
+            wynik = q;
+        }
+    }
+    if (wynik == 0) {
+        odtworz_plansze(g, k);
+        g -> dopelniona = dopelniona0;
+        g -> bez_sprawdzania = 0;
+    }
+    usun_kopie(k);
+    free(a.x);
+    free(b.x);
+    return wynik;
+}
+
+/**
+ * Przesuwa współrzędną '*x' o 'k' razy 'd', gdzie 'k' >= 0
+ *
+ * Zwraca 0, gdy wynik wyszedłby poza ZAKRES_WSPOLRZEDNYCH, wpp. 1
+ */
+static int przesun_o_okresy(long long* x, long long k, int d)
+{
+    if (d == 0)
+        return 1;
+    unsigned long long zakres = (unsigned long long) ZAKRES_WSPOLRZEDNYCH;
+    unsigned long long wolne = d > 0 ? zakres - (unsigned long long) *x : zakres + (unsigned long long) *x;
+    unsigned long long krok = d > 0 ? (unsigned long long) d : (unsigned long long) -(long long) d;
+    if (wolne > 2 * zakres || (unsigned long long) k > wolne / krok)
+        return 0;
+    *x += k * d;
+    return 1;
+}
+
+/**
+ * Oblicza 'n' kolejnych generacji planszy gry 'g', szukając cykli w jej historii
+ *
+ * Co ODSTEP_ODCISKOW generacji odcisk generacji sprowadza się do położenia, w którym
+ * róg prostokąta żywych komórek jest w (0, 0), i szuka w historii. Gdy generacja sprzed
+ * p kroków miała ten sam odcisk, szuka się najmniejszego okresu nie większego niż p
+ * (zob. szukaj_okresu), niezależnie od 'n', bo szukanie nie zużywa generacji, więc cykl
+ * wykrywa się też przy liczeniu po jednej generacji. Znaleziony cykl to zwykle martwy
+ * układ (okres 1), oscylator lub statek. Odtąd pełne okresy wszystkich 'n' generacji
+ * przeskakuje się naraz, przesuwając początki skupisk, a liczy tylko resztę. Cykl
+ * zapamiętuje się w historii. Silnik bez odcisku liczy wszystkie generacje. Silnik,
+ * który umie skakać daleko (zob. skok_daleki), szuka cykli tylko przez pierwsze
+ * ROZBIEG_ODCISKOW generacji każdego wywołania, a resztę przeskakuje, bo liczenie
+ * po ODSTEP_ODCISKOW generacji byłoby dla niego wolniejsze niż skok.
+ * Zwraca 0 z opisem błędu w grze, gdy żywe komórki wyszły poza zasięg silnika lub
+ * zakres współrzędnych albo numer generacji przekroczyłby LLONG_MAX, wpp. 1
+ */
+static int licz_z_historia(Gra* g, long long n)
+{
+    const Silnik* silnik = g -> silnik;
+    Historia* h = g -> historia;
+    if (n > LLONG_MAX - h -> generacja) {
+        snprintf(g -> blad, ROZMIAR_BLEDU, "numer generacji poza zakresem");
+        return 0;
+    }
+    long long rozbieg = silnik -> skok != NULL ? ROZBIEG_ODCISKOW : LLONG_MAX;
+    while (n > 0 && h -> okres == 0 && silnik -> odcisk != NULL && rozbieg > 0) {
+        int m = ODSTEP_ODCISKOW - (int) (h -> generacja % ODSTEP_ODCISKOW);
+        if (m == ODSTEP_ODCISKOW) {
+            Odcisk o;
+            odcisk_gry(g, &o);
+            normalizuj_odcisk(&o);
+            WpisHistorii* w = &h -> wpisy[o.hasz % ROZMIAR_HISTORII];
+            if (w -> zajety && w -> hasz == o.hasz && w -> populacja == o.populacja
+                && w -> dopelniona == g -> dopelniona && h -> generacja - w -> generacja <= INT_MAX) {
+                long long dy;
+                long long dx;
+                int q = szukaj_okresu(g, (int) (h -> generacja - w -> generacja), &dy, &dx);
+                if (q < 0)
+                    return 0;
+                if (q > 0) {
+                    h -> okres = q;
+                    h -> dy = (int) dy;
+                    h -> dx = (int) dx;
+                    h -> od = h -> generacja;
+                    continue;
+                }
+            }
+            w -> hasz = o.hasz;
+            w -> populacja = o.populacja;
+            w -> generacja = h -> generacja;
+            w -> dopelniona = g -> dopelniona;
+            w -> zajety = 1;
+        }
+        if (m > n)
+            m = (int) n;
+        if (!licz_w_zasiegu(g, m))
+            return 0;
+        h -> generacja += m;
+        n -= m;
+        rozbieg -= m;
+    }
+    if (n > 0 && h -> okres > 0) {
+        long long k = n / h -> okres;
+        for (int i = 0; i < g -> ile_skupisk; i++) {
+            long long wiersz0 = g -> skupiska[i].wiersz0;
+            long long kol0 = g -> skupiska[i].kol0;
+            if (!przesun_o_okresy(&wiersz0, k, h -> dy) || !przesun_o_okresy(&kol0, k, h -> dx)) {
+                snprintf(g -> blad, ROZMIAR_BLEDU, "plansza przekracza zakres wspolrzednych");
+                return 0;
+            }
+        }
+        for (int i = 0; i < g -> ile_skupisk; i++) {
+            przesun_o_okresy(&g -> skupiska[i].wiersz0, k, h -> dy);
+            przesun_o_okresy(&g -> skupiska[i].kol0, k, h -> dx);
+        }
+        // przesunięcie o zero okresów nie zmienia układu, co pozwala oknu czytać
+        // tylko zmienione wiersze osiadłej lub oscylującej planszy
+        if (k > 0 && (h -> dy != 0 || h -> dx != 0))
+            g -> uklad++;
+        h -> generacja += k * h -> okres;
+        n -= k * h -> okres;
+    }
+    if (!licz_w_zasiegu(g, n))
+        return 0;
+    h -> generacja += n;
+    return 1;
+}
+
+/**
+ * Zwraca liczbę żywych komórek planszy gry 'g' w prostokącie o rogach ('w1', 'k1')
+ * i ('w2', 'k2'), gdzie 'w1' <= 'w2' i 'k1' <= 'k2'
+ *
+ * Plansza silnika trzymająca dopełnienie generacji musi się mieścić w prostokącie
+ * o polu nie większym niż LLONG_MAX, inaczej zwraca -1.
+ */
+static long long policz_w_prostokacie(const Gra* g, long long w1, long long k1, long long w2, long long k2)
+{
+    long long n = 0;
+    for (int i = 0; i < g -> ile_skupisk; i++) {
+        const Skupisko* c = &g -> skupiska[i];
+        przegladaj_prostokat(g -> silnik, c, w1 - c -> wiersz0, w2 - c -> wiersz0,
+                             k1 - c -> kol0, k2 - c -> kol0, dolicz_populacje, &n);
+    }
+    if (!g -> dopelniona)
+        return n;
+    unsigned long long wiersze = (unsigned long long) w2 - (unsigned long long) w1 + 1;
+    unsigned long long kolumny = (unsigned long long) k2 - (unsigned long long) k1 + 1;
+    if (wiersze > (unsigned long long) LLONG_MAX / kolumny)
+        return -1;
+    return (long long) (wiersze * kolumny) - n;
+}
+
+/**
+ * Reprezentuje wzorzec testu wydajności
+ *
+ * 'nazwa' - nazwa wzorca w wynikach
+ * 'wiersze' - kolejne wiersze wzorca zakończone NULL, 'O' oznacza żywą komórkę,
+ *             lub NULL dla losowej zupy o boku ROZMIAR_ZUPY
+ * 'gestosc' - procent żywych komórek zupy
+ * 'kopie' - liczba kopii wzorca w każdym kierunku
+ * 'odstep' - odległość między lewymi górnymi rogami sąsiednich kopii
+ */
+typedef struct Wzorzec_
+{
+    const char* nazwa;
+    const char* const* wiersze;
+    int gestosc;
+    int kopie;
+    int odstep;
+} Wzorzec;
+
+/**
+ * Bok kwadratu, który wypełnia losowa zupa
+ */
+#define ROZMIAR_ZUPY 256
+
+/**
+ * Domyślna liczba generacji liczonych w teście wydajności
+ */
+#define GENERACJE_TESTU 1000
+
+static const char* const r_pentomino[] = {".OO", "OO.", ".O.", NULL};
+
+static const char* const zoledz[] = {".O.....", "...O...", "OO..OOO", NULL};
+
+static const char* const kroliki[] = {"O...OOO", "OOO..O.", ".O.....", NULL};
+
+static const char* const dzialo_gospera[] = {
+    "........................O...........",
+    "......................O.O...........",
+    "............OO......OO............OO",
+    "...........O...O....OO............OO",
+    "OO........O.....O...OO..............",
+    "OO........O...O.OO....O.O...........",
+    "..........O.....O.......O...........",
+    "...........O...O....................",
+    "............OO......................",
+    NULL
+};
+
+/**
+ * Wzorce testu wydajności
+ */
+static const Wzorzec wzorce[] = {
+    {"r-pentomino", r_pentomino, 0, 1, 0},
+    {"acorn", zoledz, 0, 1, 0},
+    {"gosper-gun", dzialo_gospera, 0, 1, 0},
+    {"rabbits", kroliki, 0, 1, 0},
+    {"r-pentomino-8x8", r_pentomino, 0, 8, 1024},
+    {"zupa-10", NULL, 10, 1, 0},
+    {"zupa-30", NULL, 30, 1, 0},
+    {"zupa-50", NULL, 50, 1, 0},
+};
+
+#define ILE_WZORCOW ((int) (sizeof(wzorce) / sizeof(wzorce[0])))
+
+/**
+ * Dodaje do planszy 's' silnika 'silnik' komórki wzorca 'wz' i przygotowuje ją
+ */
+static void posiej(const Silnik* silnik, void* s, const Wzorzec* wz)
+{
+    int* kol = NULL;
+    int rozmiar = 0;
+    if (wz -> wiersze == NULL) {
+        uint64_t x = 0x9E3779B97F4A7C15ULL;
+        for (int y = 0; y < ROZMIAR_ZUPY; y++) {
+            int n = 0;
+            kol = (int*) powieksz(kol, &rozmiar, ROZMIAR_ZUPY, sizeof(int));
+            for (int k = 0; k < ROZMIAR_ZUPY; k++) {
+                x ^= x << 13;
+                x ^= x >> 7;
+                x ^= x << 17;
+                if ((int) (x % 100) < wz -> gestosc)
+                    kol[n++] = k;
+            }
+            if (n > 0)
+                silnik -> dodaj_wiersz(s, y, kol, n);
+        }
+    }
+    else {
+        int szerokosc = (int) strlen(wz -> wiersze[0]);
+        for (int i = 0; i < wz -> kopie; i++)
+            for (int y = 0; wz -> wiersze[y] != NULL; y++) {
+                int n = 0;
+                kol = (int*) powieksz(kol, &rozmiar, wz -> kopie * szerokosc, sizeof(int));
+                for (int j = 0; j < wz -> kopie; j++)
+                    for (int k = 0; k < szerokosc; k++)
+                        if (wz -> wiersze[y][k] == 'O')
+                            kol[n++] = j * wz -> odstep + k;
+                if (n > 0)
+                    silnik -> dodaj_wiersz(s, i * wz -> odstep + y, kol, n);
+            }
+    }
+    free(kol);
+    silnik -> przygotuj(s);
+}
+
+/**
+ * Zwraca liczbę żywych komórek planszy 's' silnika 'silnik'
+ */
+static long long populacja(const Silnik* silnik, void* s)
+{
+    long long n = 0;
+    silnik -> przegladaj(s, INT_MIN, INT_MAX, INT_MIN, INT_MAX, dolicz_populacje, &n);
+    return n;
+}
+
+/**
+ * Liczy 'generacje' generacji wzorca 'wz' silnikiem 'silnik' o ustawieniach 'u'
+ * i pisze wynik jako obiekt JSON
+ *
+ * Mierzy się tylko liczenie generacji, po jednej naraz. Liczba przeliczonych
+ * komórek to suma populacji generacji, od których zaczynał się krok, a dla reguły
+ * z B0 suma liczności trzymanych przez plansze generacji lub ich dopełnień.
+ */
+static void testuj(const Silnik* silnik, const Ustawienia* u, const Wzorzec* wz, int generacje)
+{
+    void* s = silnik -> tworz(u);
+    posiej(silnik, s, wz);
+    long long poczatkowa = populacja(silnik, s);
+    double czasy[ILE_FAZ];
+    memset(czasy, 0, sizeof(czasy));
+    double czas = 0;
+    long long komorki = 0;
+    long long populacja_teraz = poczatkowa;
+    int dopelniona = 0;
+    for (int g = 0; g < generacje; g++) {
+        komorki += populacja_teraz;
+        double t = teraz();
+        if (silnik -> krok_mierzony != NULL && !(u -> regula.narodziny & 1))
+            silnik -> krok_mierzony(s, czasy);
+        else
+            licz_generacje(silnik, s, &u -> regula, &dopelniona, 1);
+        czas += teraz() - t;
+        populacja_teraz = populacja(silnik, s);
+    }
+    struct rusage r;
+    getrusage(RUSAGE_SELF, &r);
+    char regula[24];
+    pisz_regule(&u -> regula, regula);
+    printf("  {\"silnik\": \"%s\", \"wzorzec\": \"%s\", \"regula\": \"%s\", \"watki\": %d, "
+           "\"generacje\": %d, \"populacja_poczatkowa\": %lld, \"populacja_koncowa\": %lld, "
+           "\"sekundy\": %.6f, \"generacje_na_sekunde\": %.1f, \"komorki_na_sekunde\": %.1f, "
+           "\"szczyt_rss_kb\": %ld",
+           silnik -> nazwa, wz -> nazwa, regula, u -> watki, generacje, poczatkowa, populacja_teraz,
+           czas,           czas > 0 ? generacje / czas : 0.0, czas > 0 ? komorki / czas : 0.0, r.ru_maxrss);
+    if (silnik -> fazy != NULL) {
+        printf(", \"fazy\": {");
+        for (int i = 0; silnik -> fazy[i] != NULL; i++)
+            printf("%s\"%s\": %.6f", i > 0 ? ", " : "", silnik -> fazy[i], czasy[i]);
+        printf("}");
+    }
+    printf("}");
+    fflush(stdout);
+    silnik -> czysc(s);
+}
+
+/**
+ * Wykonuje test wydajności silnika 'silnik' lub wszystkich silników, gdy jest NULL,
+ * na wszystkich wzorcach, liczących po 'generacje' generacji
+ *
+ * Każdy test działa w osobnym procesie, żeby szczyt pamięci dotyczył tylko jego.
+ * Wyniki pisze na standardowe wyjście jako tablicę JSON.
+ * Zwraca 0, gdy wszystkie testy się udały, wpp. 1
+ */
+static int testuj_wydajnosc(const Silnik* silnik, const Ustawienia* u, int generacje)
+{
+    int wynik = 0;
+    int pierwszy = 1;
+    printf("[\n");
+    for (int i = 0; i < ILE_SILNIKOW; i++) {
+        if (silnik != NULL && silnik != &silniki[i])
+            continue;
+        Ustawienia v = *u;
+        if (!silniki[i].wielowatkowy)
+            v.watki = 1;
+        for (int j = 0; j < ILE_WZORCOW; j++) {
+            if (!pierwszy)
+                printf(",\n");
+            pierwszy = 0;
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid == 0) {
+                testuj(&silniki[i], &v, &wzorce[j], generacje);
+                _exit(0);
+            }
+            int stan = 0;
+            if (pid < 0 || waitpid(pid, &stan, 0) != pid || !WIFEXITED(stan)
+                || WEXITSTATUS(stan) != 0) {
+                fprintf(stderr, "test %s/%s nie powiodl sie\n", silniki[i].nazwa, wzorce[j].nazwa);
+                wynik = 1;
+            }
+        }
+    }
+    printf("\n]\n");
+    return wynik;
+}
+
+
+/**
+ * Zwraca silnik o nazwie 'nazwa' lub NULL, gdy takiego nie ma
+ */
+static const Silnik* szukaj_silnika(const char* nazwa)
+{
+    for (int i = 0; i < ILE_SILNIKOW; i++)
+        if (strcmp(nazwa, silniki[i].nazwa) == 0)
+            return &silniki[i];
+    return NULL;
+}
+
+/**
+ * Zapisuje w 'u' ustawienia planszy silnika 'silnik' liczącej 'watki' wątkami
+ * według reguły 'regula' (zob. zycie_tworz)
+ *
+ * Zwraca 0, gdy reguła jest niepoprawna lub silnik nie umie liczyć wieloma wątkami,
+ * wpp. 1
+ */
+static int ustaw(Ustawienia* u, const Silnik* silnik, int watki, const char* regula)
+{
+    u -> watki = watki;
+    u -> regula.narodziny = NARODZINY_CONWAYA;
+    u -> regula.przetrwanie = PRZETRWANIE_CONWAYA;
+    if (regula != NULL && !czytaj_regule(regula, &u -> regula))
+        return 0;
+    return watki >= 1 && (watki == 1 || silnik == NULL || silnik -> wielowatkowy);
+}
+
+// Interfejs biblioteki, opisany w zycie.h
+
+const char* zycie_nazwa_silnika(int i)
+{
+    return i >= 0 && i < ILE_SILNIKOW ? silniki[i].nazwa : NULL;
+}
+
+int zycie_silnik_wielowatkowy(const char* nazwa)
+{
+    const Silnik* silnik = szukaj_silnika(nazwa);
+    return silnik != NULL && silnik -> wielowatkowy;
+}
+
+int zycie_poprawna_regula(const char* napis)
+{
+    Regula r;
+    return czytaj_regule(napis, &r);
+}
+
+Zycie* zycie_tworz(const char* silnik, int watki, const char* regula)
+{
+    const Silnik* s = silnik == NULL ? &silniki[0] : szukaj_silnika(silnik);
+    Ustawienia u;
+    if (s == NULL || !ustaw(&u, s, watki, regula))
+        return NULL;
+    Gra* g = (Gra*) calloc (1, sizeof(Gra));
+    g -> silnik = s;
+    g -> ustawienia = u;
+    g -> regula = u.regula;
+    g -> historia = tworz_historie();
+    return g;
+}
+
+void zycie_usun(Zycie* z)
+{
+    for (int i = 0; i < z -> ile_skupisk; i++)
+        z -> silnik -> czysc(z -> skupiska[i].s);
+    free(z -> skupiska);
+    free(z -> kol);
+    free(z -> numery);
+    free(z -> historia);
+    free(z);
+}
+
+const char* zycie_blad(const Zycie* z)
+{
+    return z -> blad;
+}
+
+Czytnik* zycie_czytnik(int fd)
+{
+    Czytnik* c = (Czytnik*) malloc (sizeof(Czytnik));
+    inicjuj_czytnik(c, fd);
+    return c;
+}
+
+Czytnik* zycie_czytnik_pliku(const char* nazwa)
+{
+    Czytnik* c = (Czytnik*) malloc (sizeof(Czytnik));
+    if (!otworz_czytnik(c, nazwa)) {
+        free(c);
+        return NULL;
+    }
+    return c;
+}
+
+Czytnik* zycie_czytnik_tekstu(const char* tekst, size_t dlugosc)
+{
+    Czytnik* c = (Czytnik*) malloc (sizeof(Czytnik));
+    inicjuj_czytnik(c, -1);
+    free(c -> bufor);
+    c -> bufor = NULL;
+    c -> p = tekst;
+    c -> koniec = tekst + dlugosc;
+    return c;
+}
+
+void zycie_zamknij_czytnik(Czytnik* c)
+{
+    zamknij_czytnik(c);
+    free(c);
+}
+
+const char* zycie_blad_czytnika(const Czytnik* c)
+{
+    return c -> blad;
+}
+
+int zycie_wczytaj(Zycie* z, Czytnik* c)
+{
+    if (czytaj_plansze(z, c))
+        return 1;
+    snprintf(z -> blad, ROZMIAR_BLEDU, "%s", c -> blad);
+    return 0;
+}
+
+int zycie_wczytaj_migawke(Zycie* z, const char* nazwa)
+{
+    return wczytaj_migawke(z, nazwa);
+}
+
+int zycie_koniec_wejscia(Czytnik* c)
+{
+    while (zajrzyj(c) == '\n')
+        wez_znak(c);
+    return zajrzyj(c) == EOF;
+}
+
+/**
+ * Czyta z napisu '*s' liczbę całkowitą o wartości bezwzględnej najwyżej 'najwiecej'
+ * do '*wynik', przesuwając '*s' za nią
+ *
+ * Zwraca 0, gdy w '*s' nie ma liczby lub wychodzi ona poza zakres, wpp. 1
+ */
+static int czytaj_liczbe_napisu(const char** s, long long najwiecej, long long* wynik)
+{
+    const char* p = *s;
+    int ujemna = *p == '-';
+    if (ujemna)
+        p++;
+    if (*p < '0' || *p > '9')
+        return 0;
+    long long x = 0;
+    while (*p >= '0' && *p <= '9') {
+        if (x > (najwiecej - (*p - '0')) / 10)
+            return 0;
+        x = x * 10 + (*p - '0');
+        p++;
+    }
+    *wynik = ujemna ? -x : x;
+    *s = p;
+    return 1;
+}
+
+/**
+ * Pomija spacje i tabulacje napisu 's' i zwraca wskaźnik na pierwszy inny znak
+ */
+static const char* pomin_odstepy_napisu(const char* s)
+{
+    while (*s == ' ' || *s == '\t')
+        s++;
+    return s;
+}
+
+/**
+ * Rozpoznaje w 'p' polecenie z linii 'p -> tekst' zaczynającej się od liczby
+ *
+ * Liczba generacji musi być dodatnia i może mieć cały zakres long long, jak w trybie
+ * wsadowym, a współrzędne okna muszą mieścić się w ZAKRES_WSPOLRZEDNYCH. Linia, która
+ * nie jest żadnym poleceniem, daje POLECENIE_BLEDNE.
+ */
+static void rozpoznaj_polecenie_liczbowe(Polecenie* p)
+{
+    const char* s = pomin_odstepy_napisu(p -> tekst);
+    long long y;
+    p -> rodzaj = POLECENIE_BLEDNE;
+    if (!czytaj_liczbe_napisu(&s, LLONG_MAX, &y))
+        return;
+    if (*s == '>' && y == 0) {
+        memmove(p -> tekst, s + 1, strlen(s + 1) + 1);
+        p -> rodzaj = POLECENIE_ZRZUT_DO;
+        return;
+    }
+    s = pomin_odstepy_napisu(s);
+    if (*s == '\0') {
+        if (y == 0)
+            p -> rodzaj = POLECENIE_ZRZUT;
+        else if (y > 0) {
+            p -> rodzaj = POLECENIE_KROK;
+            p -> liczba = y;
+        }
+        return;
+    }
+    long long k;
+    if (y < -ZAKRES_WSPOLRZEDNYCH || y > ZAKRES_WSPOLRZEDNYCH
+        || !czytaj_liczbe_napisu(&s, ZAKRES_WSPOLRZEDNYCH, &k) || *pomin_odstepy_napisu(s) != '\0')
+        return;
+    p -> rodzaj = POLECENIE_OKNO;
+    p -> w = y;
+    p -> k = k;
+}
+
+/**
+ * Czyta polecenie tak, jak czytała je gra, ale niepoprawna linia nie kończy gry:
+ * czyta się ją w całości jako POLECENIE_BLEDNE (zob. rozpoznaj_polecenie_liczbowe)
+ */
+int zycie_czytaj_polecenie(Czytnik* c, Polecenie* p)
+{
+    if (c -> blad[0] != '\0')
+        return 0;
+    int x = zajrzyj(c);
+    p -> liczba = 1;
+    if (x == '.')
+        p -> rodzaj = POLECENIE_KONIEC;
+    else if (x == '\n' || x == EOF) {
+        wez_znak(c);
+        p -> rodzaj = POLECENIE_KROK;
+    }
+    else if (x >= 'a' && x <= 'z') {
+        czytaj_linie(c, &p -> tekst, &p -> rozmiar_tekstu);
+        p -> rodzaj = POLECENIE_SLOWO;
+    }
+    else {
+        czytaj_linie(c, &p -> tekst, &p -> rozmiar_tekstu);
+        rozpoznaj_polecenie_liczbowe(p);
+    }
+    return 1;
+}
+
+int zycie_licz(Zycie* z, long long n)
+{
+    return n <= 0 || licz_z_historia(z, n);
+}
+
+/**
+ * Reprezentuje gry liczone zespołem przez zycie_licz_wiele
+ *
+ * 'gry' - gry, zadanie i liczy grę i
+ * 'n' - liczba generacji do policzenia
+ * 'wyniki' - wyniki zycie_licz kolejnych gier
+ */
+typedef struct LiczenieWielu_
+{
+    Zycie** gry;
+    long long n;
+    int* wyniki;
+} LiczenieWielu;
+
+/**
+ * Liczy grę 'nr' zadania zycie_licz_wiele opisanego przez 'kontekst'
+ */
+static void licz_gre(void* kontekst, int nr, int watek)
+{
+    (void) watek;
+    LiczenieWielu* l = (LiczenieWielu*) kontekst;
+    l -> wyniki[nr] = zycie_licz(l -> gry[nr], l -> n);
+}
+
+void zycie_licz_wiele(Zycie** gry, int ile, long long n, int watki, int* wyniki)
+{
+    LiczenieWielu l = {gry, n, wyniki};
+    if (watki > ile)
+        watki = ile;
+    if (watki <= 1) {
+        for (int i = 0; i < ile; i++)
+            licz_gre(&l, i, 0);
+        return;
+    }
+    Zespol* z = tworz_zespol(watki);
+    uruchom_zespol(z, ile, licz_gre, &l);
+    czysc_zespol(z);
+}
+
+long long zycie_generacja(const Zycie* z)
+{
+    return z -> historia -> generacja;
+}
+
+int zycie_okres(const Zycie* z, int* okres, int* dy, int* dx, long long* od)
+{
+    const Historia* h = z -> historia;
+    if (h -> okres == 0)
+        return 0;
+    *okres = h -> okres;
+    *dy = h -> dy;
+    *dx = h -> dx;
+    *od = h -> od;
+    return 1;
+}
+
+int zycie_nieskonczona(const Zycie* z)
+{
+    return z -> dopelniona;
+}
+
+long long zycie_populacja(const Zycie* z)
+{
+    ObszarGry o;
+    obszar_gry(z, &o);
+    return o.populacja;
+}
+
+int zycie_prostokat(const Zycie* z, long long* w1, long long* k1, long long* w2, long long* k2)
+{
+    ObszarGry o;
+    obszar_gry(z, &o);
+    if (o.populacja == 0)
+        return 0;
+    *w1 = o.w_min;
+    *k1 = o.k_min;
+    *w2 = o.w_max;
+    *k2 = o.k_max;
+    return 1;
+}
+
+int zycie_zywa(const Zycie* z, long long w, long long k)
+{
+    return (int) policz_w_prostokacie(z, w, k, w, k);
+}
+
+long long zycie_policz(const Zycie* z, long long w1, long long k1, long long w2, long long k2)
+{
+    return policz_w_prostokacie(z, w1, k1, w2, k2);
+}
+
+void zycie_wytnij(const Zycie* z, long long w, long long k, int wiersze, int kolumny, char* bufor)
+{
+    skladaj_linie(z, bufor, kolumny, 0, wiersze, w, k, wpisz_wiersz_w_okno);
+}
+
+int zycie_zrzuc(Zycie* z, int fd)
+{
+    if (zrzuc_stan(z, fd))
+        return 1;
+    snprintf(z -> blad, ROZMIAR_BLEDU, "nie udal sie zapis zrzutu");
+    return 0;
+}
+
+Kopia* zycie_kopiuj(const Zycie* z)
+{
+    return kopiuj_stan(z);
+}
+
+int zycie_zrzuc_kopie(const Kopia* k, int fd)
+{
+    return zrzuc_kopie(k, fd);
+}
+
+void zycie_usun_kopie(Kopia* k)
+{
+    usun_kopie(k);
+}
+
+int zycie_zapisz_migawke(Zycie* z, const char* nazwa)
+{
+    if (zapisz_migawke(z, nazwa))
+        return 1;
+    snprintf(z -> blad, ROZMIAR_BLEDU, "nie udal sie zapis migawki: %s", nazwa);
+    return 0;
+}
+
+void zycie_pisz_statystyki(const Zycie* z, FILE* f)
+{
+    pisz_statystyki(z, f);
+}
+
+Okno* zycie_tworz_okno(int wiersze, int kolumny, int tryb, FILE* f)
+{
+    if (wiersze < 0 || kolumny < 0 || wiersze > NAJWIEKSZE_OKNO || kolumny > NAJWIEKSZE_OKNO)
+        return NULL;
+    Okno* o = (Okno*) malloc (sizeof(Okno));
+    tworz_okno(o, wiersze, kolumny, tryb, f);
+    return o;
+}
+
+void zycie_wyswietl_okno(const Zycie* z, Okno* o, long long w, long long k)
+{
+    wyswietl_okno(z, o, w, k, z -> historia -> generacja);
+}
+
+void zycie_uniewaznij_okno(Okno* o)
+{
+    uniewaznij_okno(o);
+}
+
+void zycie_usun_okno(Okno* o)
+{
+    czysc_okno(o);
+    free(o);
+}
+
+int zycie_testuj_wydajnosc(const char* silnik, int watki, const char* regula, int generacje)
+{
+    const Silnik* s = silnik == NULL ? NULL : szukaj_silnika(silnik);
+    Ustawienia u;
+    // wątki silników jednowątkowych test ogranicza sam do jednego
+    if ((silnik != NULL && s == NULL) || !ustaw(&u, NULL, watki, regula))
+        return 1;
+    return testuj_wydajnosc(s, &u, generacje);
+}
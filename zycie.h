@@ -0,0 +1,353 @@
+/**
+ * "Zycie" - biblioteka
+ *
+ * Symulacja świata komórek "Game of Life" (i innych reguł B/S) dostępna przez uchwyt
+ * gry Zycie. Biblioteka nie ma stanu globalnego: każda gra ma własną plansze, silnik,
+ * historię, wątki i pamięć, więc w jednym procesie może działać wiele niezależnych gier,
+ * także w różnych wątkach, o ile jednej gry w danej chwili używa jeden wątek.
+ *
+ * Współrzędne komórek są 64-bitowe, o wartości bezwzględnej najwyżej ZAKRES_WSPOLRZEDNYCH.
+ * Funkcje zwracające int zwracają 0 przy błędzie, a jego opis podaje zycie_blad
+ * lub zycie_blad_czytnika, wpp. 1, o ile opis nie mówi inaczej.
+ *
+ * autor: Michał Korniak
+ *
+ * data: 30 grudnia 2022
+ */
+
+#ifndef ZYCIE_H
+#define ZYCIE_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/**
+ * Największa wartość bezwzględna współrzędnej komórki gry
+ */
+#define ZAKRES_WSPOLRZEDNYCH (1LL << 62)
+
+/**
+ * Domyślna liczba wierszy okna
+ */
+#ifndef WIERSZE
+#define WIERSZE 22
+#endif
+
+/**
+ * Domyślna liczba kolumn okna
+ */
+#ifndef KOLUMNY
+#define KOLUMNY 80
+#endif
+
+/**
+ * Największa liczba wierszy i kolumn okna
+ */
+#define NAJWIEKSZE_OKNO 10000
+
+/**
+ * Sposoby wyświetlania okna
+ *
+ * OKNO_PELNE - każde okno jest wypisywane w całości
+ * OKNO_LINIE - wypisywane są tylko linie różne od wypisanych w poprzednim oknie, każda
+ *              jako numer linii od 1, ':' i tekst linii, a po nich dolna ramka
+ * OKNO_ANSI - zmienione linie są nadpisywane na terminalu po ustawieniu kursora
+ *             sekwencją ANSI, pierwsze okno czyści ekran
+ */
+#define OKNO_PELNE 0
+#define OKNO_LINIE 1
+#define OKNO_ANSI 2
+
+/**
+ * Rodzaje poleceń czytanych przez zycie_czytaj_polecenie
+ *
+ * POLECENIE_KONIEC - '.', koniec gry
+ * POLECENIE_KROK - liczba N lub pusta linia (N = 1), policzenie N generacji
+ * POLECENIE_ZRZUT - '0', zrzut stanu na wyjście
+ * POLECENIE_ZRZUT_DO - "0>cel", zrzut stanu do celu
+ * POLECENIE_OKNO - "w k", przesunięcie okna
+ * POLECENIE_SLOWO - linia zaczynająca się od małej litery, np. "statystyki"
+ * POLECENIE_BLEDNE - niepoprawna linia, np. "5 x"; gra toczy się dalej
+ */
+#define POLECENIE_KONIEC 0
+#define POLECENIE_KROK 1
+#define POLECENIE_ZRZUT 2
+#define POLECENIE_ZRZUT_DO 3
+#define POLECENIE_OKNO 4
+#define POLECENIE_SLOWO 5
+#define POLECENIE_BLEDNE 6
+
+/**
+ * Rozgrywana gra
+ */
+typedef struct Gra_ Zycie;
+
+/**
+ * Wejście tekstowe z opisem planszy i poleceniami
+ */
+typedef struct Czytnik_ Czytnik;
+
+/**
+ * Okno wyświetlające fragment planszy
+ */
+typedef struct Okno_ Okno;
+
+/**
+ * Niezmienna kopia generacji gry
+ */
+typedef struct Kopia_ Kopia;
+
+/**
+ * Reprezentuje przeczytane polecenie
+ *
+ * 'rodzaj' - POLECENIE_*
+ * 'liczba' - liczba generacji polecenia POLECENIE_KROK
+ * 'w', 'k' - lewy górny róg okna polecenia POLECENIE_OKNO
+ * 'tekst' - cel polecenia POLECENIE_ZRZUT_DO lub linia polecenia POLECENIE_SLOWO
+ *           albo POLECENIE_BLEDNE
+ * 'rozmiar_tekstu' - pojemność 'tekst'; polecenie przed pierwszym czytaniem musi mieć
+ *                    'tekst' NULL i 'rozmiar_tekstu' 0, a po ostatnim zwolnić 'tekst'
+ */
+typedef struct Polecenie_
+{
+    int rodzaj;
+    long long liczba;
+    long long w;
+    long long k;
+    char* tekst;
+    int rozmiar_tekstu;
+} Polecenie;
+
+/**
+ * Zwraca nazwę silnika numer 'i' od 0 lub NULL, gdy takiego nie ma; silnik 0 jest domyślny
+ */
+const char* zycie_nazwa_silnika(int i);
+
+/**
+ * Zwraca 1, gdy silnik 'nazwa' umie liczyć generację wieloma wątkami, wpp. 0
+ */
+int zycie_silnik_wielowatkowy(const char* nazwa);
+
+/**
+ * Zwraca 1, gdy 'napis' jest poprawną regułą B/S, np. "B36/S23", wpp. 0
+ */
+int zycie_poprawna_regula(const char* napis);
+
+/**
+ * Tworzy pustą grę silnikiem 'silnik' liczącym 'watki' wątkami według reguły 'regula'
+ *
+ * NULL jako 'silnik' lub 'regula' oznacza silnik domyślny i regułę "B3/S23".
+ * Zwraca NULL, gdy silnik jest nieznany, reguła niepoprawna lub silnik nie umie
+ * liczyć wieloma wątkami.
+ */
+Zycie* zycie_tworz(const char* silnik, int watki, const char* regula);
+
+/**
+ * Usuwa grę 'z' razem z jej planszą i wątkami
+ */
+void zycie_usun(Zycie* z);
+
+/**
+ * Zwraca opis ostatniego błędu gry 'z'
+ */
+const char* zycie_blad(const Zycie* z);
+
+/**
+ * Tworzy czytnik deskryptora 'fd', czytający go blokami
+ */
+Czytnik* zycie_czytnik(int fd);
+
+/**
+ * Tworzy czytnik pliku 'nazwa' zmapowanego do pamięci lub zwraca NULL, gdy pliku
+ * nie da się otworzyć
+ */
+Czytnik* zycie_czytnik_pliku(const char* nazwa);
+
+/**
+ * Tworzy czytnik 'dlugosc' znaków tekstu 'tekst', który musi istnieć do zamknięcia czytnika
+ */
+Czytnik* zycie_czytnik_tekstu(const char* tekst, size_t dlugosc);
+
+/**
+ * Zamyka czytnik 'c'
+ */
+void zycie_zamknij_czytnik(Czytnik* c);
+
+/**
+ * Zwraca opis błędu wejścia czytnika 'c' z miejscem jego wystąpienia
+ */
+const char* zycie_blad_czytnika(const Czytnik* c);
+
+/**
+ * Czyta z czytnika 'c' opis generacji początkowej pustej gry 'z'
+ *
+ * Każdy wiersz opisu to '/', numer wiersza i rosnące numery kolumn oddzielone spacjami,
+ * a opis kończy linia "/". Czytnik zostaje za opisem, więc może dalej czytać polecenia
+ * lub kolejną plansze. Przy błędzie gra ma opis błędu czytnika.
+ */
+int zycie_wczytaj(Zycie* z, Czytnik* c);
+
+/**
+ * Wczytuje generację początkową pustej gry 'z' z migawki 'nazwa' zapisanej przez
+ * zycie_zapisz_migawke
+ */
+int zycie_wczytaj_migawke(Zycie* z, const char* nazwa);
+
+/**
+ * Pomija puste linie czytnika 'c' i zwraca 1, gdy za nimi jest koniec wejścia, wpp. 0
+ *
+ * Pozwala czytać z jednego wejścia kolejne plansze, aż się skończą.
+ */
+int zycie_koniec_wejscia(Czytnik* c);
+
+/**
+ * Czyta z czytnika 'c' następne polecenie do 'p'
+ *
+ * Niepoprawną linię polecenia czyta w całości jako POLECENIE_BLEDNE. Zwraca 0 z opisem
+ * błędu w czytniku tylko wtedy, gdy czytnik zgłosił błąd już wcześniej, wpp. 1
+ */
+int zycie_czytaj_polecenie(Czytnik* c, Polecenie* p);
+
+/**
+ * Liczy 'n' kolejnych generacji gry 'z'
+ *
+ * Po wykryciu cyklu pełne okresy przeskakuje (zob. zycie_okres). Zwraca 0, gdy żywe
+ * komórki nie mieszczą się już w zasięgu silnika; gry nie można wtedy dalej liczyć.
+ */
+int zycie_licz(Zycie* z, long long n);
+
+/**
+ * Liczy 'n' kolejnych generacji każdej z 'ile' gier 'gry' zespołem 'watki' wątków
+ * i zapisuje w 'wyniki'[i] wynik zycie_licz gry 'gry'[i]
+ *
+ * Każdą grę liczy w całości jeden wątek, a wątek, który skończył swoje gry, podkrada
+ * je pozostałym. Gry nie mogą się powtarzać.
+ */
+void zycie_licz_wiele(Zycie** gry, int ile, long long n, int watki, int* wyniki);
+
+/**
+ * Zwraca numer aktualnej generacji gry 'z', początkowa ma numer 0
+ */
+long long zycie_generacja(const Zycie* z);
+
+/**
+ * Zapisuje w '*okres' okres cyklu gry 'z', w '*dy', '*dx' przesunięcie planszy w jednym
+ * okresie, a w '*od' numer generacji, w której go wykryto
+ *
+ * Zwraca 0, gdy cyklu jeszcze nie wykryto, wpp. 1
+ */
+int zycie_okres(const Zycie* z, int* okres, int* dy, int* dx, long long* od);
+
+/**
+ * Zwraca 1, gdy żywych komórek gry 'z' jest nieskończenie wiele (reguła z B0), wpp. 0
+ *
+ * Populacja, prostokąt, zrzut, migawka i statystyki wymagają skończonej populacji.
+ */
+int zycie_nieskonczona(const Zycie* z);
+
+/**
+ * Zwraca liczbę żywych komórek gry 'z' o skończonej populacji
+ */
+long long zycie_populacja(const Zycie* z);
+
+/**
+ * Zapisuje w '*w1', '*k1' i '*w2', '*k2' rogi najmniejszego prostokąta z żywymi
+ * komórkami gry 'z' o skończonej populacji
+ *
+ * Zwraca 0, gdy nie ma żywych komórek, wpp. 1
+ */
+int zycie_prostokat(const Zycie* z, long long* w1, long long* k1, long long* w2, long long* k2);
+
+/**
+ * Zwraca 1, gdy komórka ('w', 'k') gry 'z' jest żywa, wpp. 0
+ */
+int zycie_zywa(const Zycie* z, long long w, long long k);
+
+/**
+ * Zwraca liczbę żywych komórek gry 'z' w prostokącie o rogach ('w1', 'k1') i ('w2', 'k2'),
+ * gdzie 'w1' <= 'w2' i 'k1' <= 'k2', lub -1, gdy przy nieskończonej populacji
+ * przekracza ona LLONG_MAX
+ */
+long long zycie_policz(const Zycie* z, long long w1, long long k1, long long w2, long long k2);
+
+/**
+ * Zapisuje w 'bufor' prostokąt gry 'z' o lewym górnym rogu ('w', 'k'), 'wiersze' wierszach
+ * i 'kolumny' kolumnach jako linie 'kolumny' znaków '0' (żywa) i '.' (martwa)
+ * zakończone '\n'
+ *
+ * Silnik przegląda tylko wiersze prostokąta.
+ */
+void zycie_wytnij(const Zycie* z, long long w, long long k, int wiersze, int kolumny, char* bufor);
+
+/**
+ * Pisze zrzut stanu gry 'z' o skończonej populacji do deskryptora 'fd'
+ *
+ * Zrzut to opis generacji w formacie czytanym przez zycie_wczytaj.
+ */
+int zycie_zrzuc(Zycie* z, int fd);
+
+/**
+ * Tworzy kopię aktualnej generacji gry 'z' o skończonej populacji
+ *
+ * Kopia nie zależy od gry: można ją zrzucić w innym wątku, gdy gra liczy dalej.
+ */
+Kopia* zycie_kopiuj(const Zycie* z);
+
+/**
+ * Pisze zrzut stanu kopii 'k' do deskryptora 'fd', taki jak zycie_zrzuc gry w chwili
+ * zrobienia kopii
+ *
+ * Zwraca 0, gdy zapis się nie udał, wpp. 1
+ */
+int zycie_zrzuc_kopie(const Kopia* k, int fd);
+
+/**
+ * Usuwa kopię 'k'
+ */
+void zycie_usun_kopie(Kopia* k);
+
+/**
+ * Zapisuje migawkę gry 'z' o skończonej populacji do pliku 'nazwa'
+ */
+int zycie_zapisz_migawke(Zycie* z, const char* nazwa);
+
+/**
+ * Pisze do 'f' populację i prostokąt z żywymi komórkami gry 'z' o skończonej populacji
+ * oraz liczniki jej silnika
+ */
+void zycie_pisz_statystyki(const Zycie* z, FILE* f);
+
+/**
+ * Tworzy okno o 'wiersze' wierszach i 'kolumny' kolumnach wyświetlane sposobem 'tryb'
+ * do 'f' lub zwraca NULL, gdy rozmiar jest ujemny lub większy niż NAJWIEKSZE_OKNO
+ *
+ * Okno o zerowym rozmiarze nie jest wyświetlane.
+ */
+Okno* zycie_tworz_okno(int wiersze, int kolumny, int tryb, FILE* f);
+
+/**
+ * Wyświetla okno 'o' aktualnej generacji gry 'z' o lewym górnym rogu ('w', 'k')
+ */
+void zycie_wyswietl_okno(const Zycie* z, Okno* o, long long w, long long k);
+
+/**
+ * Zapomina, co okno 'o' wyświetlane sekwencjami ANSI pokazuje na terminalu, po wypisaniu
+ * do niego innego tekstu
+ */
+void zycie_uniewaznij_okno(Okno* o);
+
+/**
+ * Usuwa okno 'o'
+ */
+void zycie_usun_okno(Okno* o);
+
+/**
+ * Wykonuje test wydajności silnika 'silnik' lub wszystkich, gdy jest NULL, liczących
+ * 'watki' wątkami według reguły 'regula' po 'generacje' generacji na każdym wzorcu
+ *
+ * Wyniki pisze na standardowe wyjście jako tablicę JSON. Zwraca 0, gdy wszystkie testy
+ * się udały, wpp. 1.
+ */
+int zycie_testuj_wydajnosc(const char* silnik, int watki, const char* regula, int generacje);
+
+#endif